@@ -0,0 +1,175 @@
+//
+// AdaptiveTessellator.cpp
+//
+
+#include "AdaptiveTessellator.h"
+
+#include <QVector4D>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+struct Sample
+{
+    qreal t;
+    QVector3D point;
+};
+
+class SegmentSubdivider
+{
+public:
+    SegmentSubdivider(CurveType type, std::span<const QVector3D> controlPoints, qsizetype segment,
+                      int degree, const TessellationOptions& options, QVector<QVector3D>& out,
+                      TessellationStats& stats)
+        : m_type(type), m_controlPoints(controlPoints), m_segment(segment), m_degree(degree),
+          m_options(options), m_out(out), m_stats(stats)
+    {
+    }
+
+    Sample sample(qreal t) const
+    {
+        return { t, CurveCalculator::segmentPoint(m_type, m_controlPoints, m_segment, t, m_degree) };
+    }
+
+    // Emits every vertex of (a, b]; mid is the sample halfway between them
+    void subdivide(const Sample& a, const Sample& mid, const Sample& b, int depth)
+    {
+        m_stats.maxDepthReached = std::max(m_stats.maxDepthReached, depth);
+
+        const Sample q1 = sample(0.5 * (a.t + mid.t));
+        const Sample q3 = sample(0.5 * (mid.t + b.t));
+
+        if (depth >= m_options.maxDepth || isFlat(a.point, b.point, q1.point, mid.point, q3.point)) {
+            m_out.append(b.point);
+            ++m_stats.vertexCount;
+            return;
+        }
+
+        subdivide(a, q1, mid, depth + 1);
+        subdivide(mid, q3, b, depth + 1);
+    }
+
+private:
+    // Distance from p to the segment [a, b] in the tolerance space
+    qreal deviation(const QVector3D& a, const QVector3D& b, const QVector3D& p) const
+    {
+        if (m_options.space == TessellationOptions::Space::World) {
+            return distanceToSegment(a, b, p);
+        }
+
+        QVector3D sa, sb, sp;
+        const bool aVisible = toPixels(a, sa);
+        const bool bVisible = toPixels(b, sb);
+        const bool pVisible = toPixels(p, sp);
+        if (aVisible && bVisible && pVisible) {
+            return distanceToSegment(sa, sb, sp);
+        }
+        // Wholly behind the camera is invisible; crossing the eye plane keeps splitting
+        return (aVisible || bVisible || pVisible) ? std::numeric_limits<qreal>::infinity() : 0.0;
+    }
+
+    bool isFlat(const QVector3D& a, const QVector3D& b,
+                const QVector3D& q1, const QVector3D& mid, const QVector3D& q3) const
+    {
+        return deviation(a, b, q1) <= m_options.tolerance
+            && deviation(a, b, mid) <= m_options.tolerance
+            && deviation(a, b, q3) <= m_options.tolerance;
+    }
+
+    bool toPixels(const QVector3D& p, QVector3D& pixel) const
+    {
+        const QVector4D clip = m_options.viewProjection * QVector4D(p, 1.0f);
+        if (clip.w() <= 0.0f) return false;
+
+        pixel = QVector3D((clip.x() / clip.w() + 1.0f) * 0.5f * m_options.viewportSize.width(),
+                          (1.0f - clip.y() / clip.w()) * 0.5f * m_options.viewportSize.height(),
+                          0.0f);
+        return true;
+    }
+
+    static qreal distanceToSegment(const QVector3D& a, const QVector3D& b, const QVector3D& p)
+    {
+        const QVector3D ab = b - a;
+        const float lengthSquared = ab.lengthSquared();
+        if (lengthSquared <= 0.0f) {
+            return (p - a).length();
+        }
+        const float u = std::clamp(QVector3D::dotProduct(p - a, ab) / lengthSquared, 0.0f, 1.0f);
+        return (p - (a + ab * u)).length();
+    }
+
+    CurveType m_type;
+    std::span<const QVector3D> m_controlPoints;
+    qsizetype m_segment;
+    int m_degree;
+    const TessellationOptions& m_options;
+    QVector<QVector3D>& m_out;
+    TessellationStats& m_stats;
+};
+
+// High-degree Bézier curves can wiggle between three probes, so they start
+// from roughly one interval per cubic span instead of a single one.
+int initialIntervals(CurveType type, qsizetype pointCount)
+{
+    if (type != CurveType::Bezier) return 1;
+    return static_cast<int>(std::clamp<qsizetype>((pointCount - 1 + 2) / 3, 1, 256));
+}
+
+}
+
+TessellationStats AdaptiveTessellator::tessellateSegment(CurveType type, std::span<const QVector3D> controlPoints,
+                                                         qsizetype segment, const TessellationOptions& options,
+                                                         bool withFirst, QVector<QVector3D>& out, int degree)
+{
+    TessellationStats stats;
+    SegmentSubdivider subdivider(type, controlPoints, segment, degree, options, out, stats);
+
+    const int intervals = initialIntervals(type, static_cast<qsizetype>(controlPoints.size()));
+    Sample a = subdivider.sample(0.0);
+    if (withFirst) {
+        out.append(a.point);
+        ++stats.vertexCount;
+    }
+
+    for (int i = 1; i <= intervals; ++i) {
+        const Sample b = subdivider.sample(static_cast<qreal>(i) / intervals);
+        subdivider.subdivide(a, subdivider.sample(0.5 * (a.t + b.t)), b, 0);
+        a = b;
+    }
+
+    stats.segmentCount = 1;
+    return stats;
+}
+
+TessellationStats AdaptiveTessellator::tessellate(CurveType type, std::span<const QVector3D> controlPoints,
+                                                  const TessellationOptions& options, QVector<QVector3D>& out,
+                                                  const std::function<bool()>& interrupted, int degree)
+{
+    TessellationStats stats;
+    const qsizetype segments = CurveCalculator::segmentCount(type, static_cast<qsizetype>(controlPoints.size()), degree);
+
+    if (segments == 0) {
+        // Too few points for a curve: same fallback as the fixed tessellation
+        for (const QVector3D& p : controlPoints) {
+            out.append(p);
+        }
+        stats.vertexCount = static_cast<qsizetype>(controlPoints.size());
+        return stats;
+    }
+
+    for (qsizetype i = 0; i < segments; ++i) {
+        if (interrupted && interrupted()) {
+            stats.interrupted = true;
+            return stats;
+        }
+
+        // Consecutive segments share their joint, keep it only once
+        const TessellationStats segmentStats = tessellateSegment(type, controlPoints, i, options, i == 0, out, degree);
+        stats.vertexCount += segmentStats.vertexCount;
+        stats.segmentCount += segmentStats.segmentCount;
+        stats.maxDepthReached = std::max(stats.maxDepthReached, segmentStats.maxDepthReached);
+    }
+    return stats;
+}
@@ -0,0 +1,65 @@
+//
+// AdaptiveTessellator.h
+//
+
+#ifndef CURVES3D_ADAPTIVETESSELLATOR_H
+#define CURVES3D_ADAPTIVETESSELLATOR_H
+
+#include "CurveCalculator.h"
+
+#include <QMatrix4x4>
+#include <QSize>
+
+#include <functional>
+
+struct TessellationOptions
+{
+    enum class Space
+    {
+        World,  // tolerance in scene units
+        Screen  // tolerance in pixels after projecting with viewProjection
+    };
+
+    Space space = Space::World;
+    float tolerance = 0.05f;
+
+    // Screen space only
+    QMatrix4x4 viewProjection;
+    QSize viewportSize;
+
+    // Bounds the recursion: at most 2^maxDepth intervals per starting interval
+    int maxDepth = 10;
+
+    bool operator==(const TessellationOptions&) const = default;
+};
+
+struct TessellationStats
+{
+    qsizetype vertexCount = 0;
+    qsizetype segmentCount = 0;
+    int maxDepthReached = 0;
+    bool interrupted = false;
+};
+
+// Error-bounded tessellation: every parameter interval is split in half until
+// the curve at 1/4, 1/2 and 3/4 of it lies within the tolerance of the chord.
+// Flat stretches collapse to a few vertices, tight bends get as many as needed.
+class AdaptiveTessellator
+{
+public:
+    // Appends the polyline to out (joints between segments are shared). If
+    // interrupted() returns true between segments, stops early and reports it;
+    // out then holds a partial polyline.
+    static TessellationStats tessellate(CurveType type, std::span<const QVector3D> controlPoints,
+                                        const TessellationOptions& options, QVector<QVector3D>& out,
+                                        const std::function<bool()>& interrupted = {},
+                                        int degree = CurveCalculator::BSPLINE_DEGREE);
+
+    // Appends one segment; the vertex at t = 0 is included only if withFirst is set
+    static TessellationStats tessellateSegment(CurveType type, std::span<const QVector3D> controlPoints,
+                                               qsizetype segment, const TessellationOptions& options,
+                                               bool withFirst, QVector<QVector3D>& out,
+                                               int degree = CurveCalculator::BSPLINE_DEGREE);
+};
+
+#endif //CURVES3D_ADAPTIVETESSELLATOR_H
@@ -0,0 +1,184 @@
+//
+// ArcLengthTable.cpp
+//
+
+#include "ArcLengthTable.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+// 5-point Gauss-Legendre rule on [-1, 1]: exact for polynomials up to degree 9
+constexpr std::array<qreal, 5> GAUSS_NODES = {
+    -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640
+};
+constexpr std::array<qreal, 5> GAUSS_WEIGHTS = {
+    0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891
+};
+
+constexpr int MAX_NEWTON_ITERATIONS = 8;
+// Relative to the interval length; well below float control-point precision
+constexpr qreal NEWTON_TOLERANCE = 1e-10;
+
+int intervalsPerSegment(CurveType type, qsizetype pointCount)
+{
+    if (type != CurveType::Bezier) return ArcLengthTable::INTERVALS_PER_SPAN;
+    const qsizetype spans = std::clamp<qsizetype>((pointCount - 1 + 2) / 3, 1, 64);
+    return static_cast<int>(spans) * ArcLengthTable::INTERVALS_PER_SPAN;
+}
+
+}
+
+void ArcLengthTable::rebuild(CurveType type, const QList<QVector3D>& controlPoints, int degree)
+{
+    m_type = type;
+    m_degree = degree;
+    m_controlPoints = controlPoints;
+    m_segmentCount = CurveCalculator::segmentCount(type, controlPoints.size(), degree);
+    m_intervals = intervalsPerSegment(type, controlPoints.size());
+
+    m_intervalEnd.resize(m_segmentCount * m_intervals);
+    m_segmentStart.resize(m_segmentCount + 1);
+    for (qsizetype segment = 0; segment < m_segmentCount; ++segment) {
+        integrateSegment(segment);
+    }
+    accumulate(0);
+}
+
+void ArcLengthTable::updateSegments(const QList<QVector3D>& controlPoints,
+                                    qsizetype firstSegment, qsizetype lastSegment)
+{
+    Q_ASSERT(controlPoints.size() == m_controlPoints.size());
+    m_controlPoints = controlPoints;
+
+    firstSegment = std::max<qsizetype>(firstSegment, 0);
+    lastSegment = std::min(lastSegment, m_segmentCount - 1);
+    for (qsizetype segment = firstSegment; segment <= lastSegment; ++segment) {
+        integrateSegment(segment);
+    }
+    accumulate(firstSegment);
+}
+
+qreal ArcLengthTable::segmentLength(qsizetype segment) const
+{
+    Q_ASSERT(segment >= 0 && segment < m_segmentCount);
+    return m_segmentStart[segment + 1] - m_segmentStart[segment];
+}
+
+qreal ArcLengthTable::lengthAt(qsizetype segment, qreal t) const
+{
+    Q_ASSERT(segment >= 0 && segment < m_segmentCount);
+    t = std::clamp(t, 0.0, 1.0);
+
+    const int k = std::min(static_cast<int>(t * m_intervals), m_intervals - 1);
+    const qreal* ends = m_intervalEnd.constData() + segment * m_intervals;
+    const qreal before = (k == 0) ? 0.0 : ends[k - 1];
+    return m_segmentStart[segment] + before + integrate(segment, static_cast<qreal>(k) / m_intervals, t);
+}
+
+ArcLengthParameter ArcLengthTable::parameterAt(qreal distance) const
+{
+    if (m_segmentCount == 0) return {};
+
+    distance = std::clamp(distance, 0.0, totalLength());
+
+    // Last segment starting at or before the distance
+    const auto segmentIt = std::upper_bound(m_segmentStart.cbegin() + 1, m_segmentStart.cend() - 1, distance);
+    const qsizetype segment = segmentIt - (m_segmentStart.cbegin() + 1);
+    const qreal local = distance - m_segmentStart[segment];
+
+    const qreal* ends = m_intervalEnd.constData() + segment * m_intervals;
+    const int k = static_cast<int>(std::min<qsizetype>(
+        std::lower_bound(ends, ends + m_intervals, local) - ends, m_intervals - 1));
+
+    const qreal before = (k == 0) ? 0.0 : ends[k - 1];
+    const qreal intervalLength = ends[k] - before;
+    const qreal a = static_cast<qreal>(k) / m_intervals;
+    const qreal b = static_cast<qreal>(k + 1) / m_intervals;
+    const qreal remaining = local - before;
+
+    if (intervalLength <= 0.0) return { segment, a };
+
+    // Solve integrate(a, t) = remaining; speed is the derivative, the bracket
+    // [lo, hi] catches steps that overshoot where the speed varies sharply
+    qreal lo = a;
+    qreal hi = b;
+    qreal t = a + (b - a) * (remaining / intervalLength);
+    for (int i = 0; i < MAX_NEWTON_ITERATIONS; ++i) {
+        const qreal f = integrate(segment, a, t) - remaining;
+        if (std::abs(f) <= NEWTON_TOLERANCE * intervalLength) break;
+        (f > 0.0 ? hi : lo) = t;
+
+        const qreal v = speed(segment, t);
+        const qreal next = (v > 0.0) ? t - f / v : lo - 1.0;
+        t = (next > lo && next < hi) ? next : 0.5 * (lo + hi);
+    }
+    return { segment, t };
+}
+
+QVector3D ArcLengthTable::pointAt(qreal distance) const
+{
+    const ArcLengthParameter parameter = parameterAt(distance);
+    if (!parameter.isValid()) {
+        return m_controlPoints.isEmpty() ? QVector3D(0, 0, 0) : m_controlPoints.first();
+    }
+
+    const std::span<const QVector3D> points(m_controlPoints.constData(), static_cast<size_t>(m_controlPoints.size()));
+    return CurveCalculator::segmentPoint(m_type, points, parameter.segment, parameter.t, m_degree);
+}
+
+void ArcLengthTable::sampleUniform(std::span<QVector3D> out) const
+{
+    const size_t count = out.size();
+    if (count == 0) return;
+    if (count == 1) {
+        out[0] = pointAt(0.0);
+        return;
+    }
+
+    const qreal step = totalLength() / static_cast<qreal>(count - 1);
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = pointAt(step * static_cast<qreal>(i));
+    }
+}
+
+qreal ArcLengthTable::speed(qsizetype segment, qreal t) const
+{
+    const std::span<const QVector3D> points(m_controlPoints.constData(), static_cast<size_t>(m_controlPoints.size()));
+    return CurveCalculator::segmentDerivative(m_type, points, segment, t, m_degree).length();
+}
+
+qreal ArcLengthTable::integrate(qsizetype segment, qreal a, qreal b) const
+{
+    if (b <= a) return 0.0;
+
+    const qreal halfWidth = 0.5 * (b - a);
+    const qreal center = 0.5 * (a + b);
+    qreal sum = 0.0;
+    for (size_t i = 0; i < GAUSS_NODES.size(); ++i) {
+        sum += GAUSS_WEIGHTS[i] * speed(segment, center + halfWidth * GAUSS_NODES[i]);
+    }
+    return sum * halfWidth;
+}
+
+void ArcLengthTable::integrateSegment(qsizetype segment)
+{
+    qreal* ends = m_intervalEnd.data() + segment * m_intervals;
+    qreal length = 0.0;
+    for (int k = 0; k < m_intervals; ++k) {
+        length += integrate(segment, static_cast<qreal>(k) / m_intervals, static_cast<qreal>(k + 1) / m_intervals);
+        ends[k] = length;
+    }
+}
+
+void ArcLengthTable::accumulate(qsizetype firstSegment)
+{
+    if (m_segmentStart.isEmpty()) return;
+
+    m_segmentStart[0] = 0.0;
+    for (qsizetype segment = firstSegment; segment < m_segmentCount; ++segment) {
+        m_segmentStart[segment + 1] = m_segmentStart[segment] + m_intervalEnd[(segment + 1) * m_intervals - 1];
+    }
+}
@@ -0,0 +1,76 @@
+//
+// ArcLengthTable.h
+//
+
+#ifndef CURVES3D_ARCLENGTHTABLE_H
+#define CURVES3D_ARCLENGTHTABLE_H
+
+#include "CurveCalculator.h"
+
+#include <span>
+
+// Position on a curve in segment coordinates
+struct ArcLengthParameter
+{
+    qsizetype segment = -1;
+    qreal t = 0.0;
+
+    bool isValid() const { return segment >= 0; }
+};
+
+// Cumulative arc length of a curve, for constant-speed traversal and even
+// spacing. Every segment is split into fixed intervals whose lengths are
+// integrated with 5-point Gauss-Legendre quadrature of |C'(t)|; a lookup
+// binary-searches the table and then solves L(t) = s inside one interval
+// with safeguarded Newton, so it costs O(log n) plus a few quadratures.
+// Segments are independent, so moving a control point only re-integrates
+// the segments in its support.
+class ArcLengthTable
+{
+public:
+    // Quadrature intervals per cubic segment (Bézier curves get one group per cubic span)
+    static constexpr int INTERVALS_PER_SPAN = 8;
+
+    // degree is the B-spline degree, ignored by the other types
+    void rebuild(CurveType type, const QList<QVector3D>& controlPoints,
+                 int degree = CurveCalculator::BSPLINE_DEGREE);
+    // Same type and point count, only segments [firstSegment, lastSegment] changed shape
+    void updateSegments(const QList<QVector3D>& controlPoints, qsizetype firstSegment, qsizetype lastSegment);
+
+    CurveType type() const { return m_type; }
+    int degree() const { return m_degree; }
+    qsizetype segmentCount() const { return m_segmentCount; }
+    qsizetype pointCount() const { return m_controlPoints.size(); }
+    bool isEmpty() const { return m_segmentCount == 0; }
+
+    qreal totalLength() const { return m_segmentStart.isEmpty() ? 0.0 : m_segmentStart.last(); }
+    qreal segmentLength(qsizetype segment) const;
+
+    // Distance from the start of the curve to (segment, t)
+    qreal lengthAt(qsizetype segment, qreal t) const;
+    // Inverse of lengthAt; distance is clamped to [0, totalLength()]
+    ArcLengthParameter parameterAt(qreal distance) const;
+    QVector3D pointAt(qreal distance) const;
+
+    // out.size() points evenly spaced along the curve, both ends included
+    void sampleUniform(std::span<QVector3D> out) const;
+
+private:
+    qreal speed(qsizetype segment, qreal t) const;
+    qreal integrate(qsizetype segment, qreal a, qreal b) const;
+    void integrateSegment(qsizetype segment);
+    void accumulate(qsizetype firstSegment);
+
+    CurveType m_type = CurveType::Bezier;
+    int m_degree = CurveCalculator::BSPLINE_DEGREE;
+    QList<QVector3D> m_controlPoints;
+    qsizetype m_segmentCount = 0;
+    int m_intervals = INTERVALS_PER_SPAN;
+
+    // Length from the segment start to the end of each interval, m_intervals per segment
+    QVector<qreal> m_intervalEnd;
+    // Length from the curve start to each segment start, plus the total
+    QVector<qreal> m_segmentStart;
+};
+
+#endif //CURVES3D_ARCLENGTHTABLE_H
@@ -0,0 +1,260 @@
+//
+// ClosestPointQuery.cpp
+//
+
+#include "ClosestPointQuery.h"
+#include "ParallelFor.h"
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Pieces a Bézier curve is split into: about one per cubic span, bounded
+constexpr qsizetype MAX_BEZIER_PIECES = 64;
+
+// Coarse samples per piece before Newton refinement
+constexpr int SAMPLES_PER_PIECE = 8;
+constexpr int NEWTON_ITERATIONS = 12;
+
+struct Vec3
+{
+    qreal x = 0.0, y = 0.0, z = 0.0;
+
+    Vec3() = default;
+    Vec3(qreal ax, qreal ay, qreal az) : x(ax), y(ay), z(az) {}
+    explicit Vec3(const QVector3D& v) : x(v.x()), y(v.y()), z(v.z()) {}
+
+    Vec3 operator+(const Vec3& o) const { return { x + o.x, y + o.y, z + o.z }; }
+    Vec3 operator-(const Vec3& o) const { return { x - o.x, y - o.y, z - o.z }; }
+    Vec3 operator*(qreal s) const { return { x * s, y * s, z * s }; }
+    qreal dot(const Vec3& o) const { return x * o.x + y * o.y + z * o.z; }
+    QVector3D toVector3D() const { return QVector3D(x, y, z); }
+};
+
+Vec3 lerp(const Vec3& a, const Vec3& b, qreal s)
+{
+    return a + (b - a) * s;
+}
+
+// Point, first and second derivative of a Bézier at s, by De Casteljau
+void evaluateBezier(std::span<const QVector3D> points, qreal s, Vec3& position, Vec3& d1, Vec3& d2)
+{
+    const int degree = static_cast<int>(points.size()) - 1;
+    if (degree == 0) {
+        position = Vec3(points[0]);
+        d1 = d2 = Vec3();
+        return;
+    }
+
+    QVarLengthArray<Vec3, 16> level(points.size());
+    for (qsizetype i = 0; i < level.size(); ++i) {
+        level[i] = Vec3(points[i]);
+    }
+
+    // Reduce to three points (or two for a line)
+    for (int k = degree; k > 2; --k) {
+        for (int i = 0; i < k; ++i) {
+            level[i] = lerp(level[i], level[i + 1], s);
+        }
+    }
+
+    if (degree >= 2) {
+        d2 = (level[2] - level[1] * 2.0 + level[0]) * (degree * (degree - 1));
+        level[0] = lerp(level[0], level[1], s);
+        level[1] = lerp(level[1], level[2], s);
+    } else {
+        d2 = Vec3();
+    }
+    d1 = (level[1] - level[0]) * degree;
+    position = lerp(level[0], level[1], s);
+}
+
+// Cubic Bézier control points through four samples at t = 0, 1/3, 2/3, 1
+std::array<QVector3D, 4> cubicFromSamples(const Vec3& q0, const Vec3& q1, const Vec3& q2, const Vec3& q3)
+{
+    const Vec3 a = q1 * 27.0 - q0 * 8.0 - q3;
+    const Vec3 b = q2 * 27.0 - q0 - q3 * 8.0;
+    return { q0.toVector3D(),
+             ((a * 2.0 - b) * (1.0 / 18.0)).toVector3D(),
+             ((b * 2.0 - a) * (1.0 / 18.0)).toVector3D(),
+             q3.toVector3D() };
+}
+
+qreal boxDistanceSquared(const QVector3D& boxMin, const QVector3D& boxMax, const QVector3D& p)
+{
+    qreal sum = 0.0;
+    for (int axis = 0; axis < 3; ++axis) {
+        const qreal below = boxMin[axis] - p[axis];
+        const qreal above = p[axis] - boxMax[axis];
+        const qreal d = std::max({ below, above, qreal(0) });
+        sum += d * d;
+    }
+    return sum;
+}
+
+}
+
+ClosestPointQuery::ClosestPointQuery(CurveType type, std::span<const QVector3D> controlPoints)
+{
+    const qsizetype n = static_cast<qsizetype>(controlPoints.size());
+    const qsizetype segments = CurveCalculator::segmentCount(type, n);
+
+    if (segments == 0) {
+        // Too few points for a curve: the renderer shows the polyline through them
+        for (qsizetype i = 0; i < n; ++i) {
+            const QVector3D line[2] = { controlPoints[i], controlPoints[std::min(i + 1, n - 1)] };
+            addPiece(i, 0.0, 1.0, line);
+        }
+        return;
+    }
+
+    if (type != CurveType::Bezier) {
+        // Every other segment is a cubic: its Bézier form is exact
+        for (qsizetype segment = 0; segment < segments; ++segment) {
+            auto sample = [&](qreal t) {
+                return Vec3(CurveCalculator::segmentPoint(type, controlPoints, segment, t));
+            };
+            const std::array<QVector3D, 4> bezier =
+                cubicFromSamples(sample(0.0), sample(1.0 / 3.0), sample(2.0 / 3.0), sample(1.0));
+            addPiece(segment, 0.0, 1.0, bezier);
+        }
+        return;
+    }
+
+    // One high-degree segment: peel pieces off the front by De Casteljau
+    // subdivision so their (tighter) hulls can be pruned independently
+    const qsizetype pieces = std::clamp<qsizetype>((n - 1 + 2) / 3, 1, MAX_BEZIER_PIECES);
+    std::vector<Vec3> remaining(controlPoints.begin(), controlPoints.end());
+    std::vector<Vec3> left(static_cast<size_t>(n));
+    QVector<QVector3D> piece(n);
+    qreal t0 = 0.0;
+
+    for (qsizetype k = 0; k < pieces; ++k) {
+        const qreal t1 = static_cast<qreal>(k + 1) / pieces;
+        if (k + 1 == pieces) {
+            for (qsizetype i = 0; i < n; ++i) piece[i] = remaining[i].toVector3D();
+            addPiece(0, t0, 1.0, piece);
+            break;
+        }
+
+        // Split the remaining [t0, 1] at the local parameter of t1
+        const qreal s = (t1 - t0) / (1.0 - t0);
+        for (qsizetype level = 0; level < n; ++level) {
+            left[level] = remaining[0];
+            for (qsizetype i = 0; i + level + 1 < n; ++i) {
+                remaining[i] = lerp(remaining[i], remaining[i + 1], s);
+            }
+        }
+        for (qsizetype i = 0; i < n; ++i) piece[i] = left[i].toVector3D();
+        addPiece(0, t0, t1, piece);
+        t0 = t1;
+    }
+}
+
+void ClosestPointQuery::addPiece(qsizetype segment, qreal t0, qreal t1, std::span<const QVector3D> bezier)
+{
+    Piece piece;
+    piece.segment = segment;
+    piece.t0 = t0;
+    piece.t1 = t1;
+    piece.firstPoint = m_bezierPoints.size();
+    piece.degree = static_cast<int>(bezier.size()) - 1;
+    piece.boxMin = piece.boxMax = bezier[0];
+
+    for (const QVector3D& p : bezier) {
+        m_bezierPoints.append(p);
+        for (int axis = 0; axis < 3; ++axis) {
+            piece.boxMin[axis] = std::min(piece.boxMin[axis], p[axis]);
+            piece.boxMax[axis] = std::max(piece.boxMax[axis], p[axis]);
+        }
+    }
+    m_pieces.append(piece);
+}
+
+void ClosestPointQuery::refine(const Piece& piece, const QVector3D& query, ClosestPointResult& best) const
+{
+    const std::span<const QVector3D> points(m_bezierPoints.constData() + piece.firstPoint,
+                                            static_cast<size_t>(piece.degree + 1));
+    const Vec3 q(query);
+    Vec3 position, d1, d2;
+
+    auto consider = [&](qreal s, const Vec3& p) {
+        const qreal distance = std::sqrt((p - q).dot(p - q));
+        if (distance < best.distance) {
+            best.segment = piece.segment;
+            best.t = piece.t0 + (piece.t1 - piece.t0) * s;
+            best.point = p.toVector3D();
+            best.distance = distance;
+        }
+    };
+
+    // Coarse samples (ends included) of g(s) = (C(s) - q) . C'(s), half the
+    // derivative of the squared distance. Every interval where g goes from
+    // negative to positive brackets a local minimum.
+    qreal slope[SAMPLES_PER_PIECE + 1];
+    for (int i = 0; i <= SAMPLES_PER_PIECE; ++i) {
+        const qreal s = static_cast<qreal>(i) / SAMPLES_PER_PIECE;
+        evaluateBezier(points, s, position, d1, d2);
+        slope[i] = (position - q).dot(d1);
+        consider(s, position);
+    }
+
+    for (int i = 0; i < SAMPLES_PER_PIECE; ++i) {
+        if (!(slope[i] < 0.0 && slope[i + 1] >= 0.0)) continue;
+
+        // Newton on g, falling back to bisection whenever a step leaves the bracket
+        qreal low = static_cast<qreal>(i) / SAMPLES_PER_PIECE;
+        qreal high = static_cast<qreal>(i + 1) / SAMPLES_PER_PIECE;
+        qreal s = 0.5 * (low + high);
+        for (int iteration = 0; iteration < NEWTON_ITERATIONS; ++iteration) {
+            evaluateBezier(points, s, position, d1, d2);
+            const Vec3 diff = position - q;
+            const qreal g = diff.dot(d1);
+            const qreal gPrime = d1.dot(d1) + diff.dot(d2);
+
+            if (g < 0.0) low = s; else high = s;
+
+            qreal next = (gPrime > 0.0) ? s - g / gPrime : 0.5 * (low + high);
+            if (!(next > low && next < high)) next = 0.5 * (low + high);
+
+            const qreal step = std::abs(next - s);
+            s = next;
+            if (step < 1e-9) break;
+        }
+        evaluateBezier(points, s, position, d1, d2);
+        consider(s, position);
+    }
+}
+
+ClosestPointResult ClosestPointQuery::closest(const QVector3D& query) const
+{
+    ClosestPointResult best;
+    if (m_pieces.isEmpty()) return best;
+
+    // Nearest hull first; a hull farther than the best point so far can be skipped
+    QVarLengthArray<std::pair<qreal, qsizetype>, 64> order(m_pieces.size());
+    for (qsizetype i = 0; i < m_pieces.size(); ++i) {
+        order[i] = { boxDistanceSquared(m_pieces[i].boxMin, m_pieces[i].boxMax, query), i };
+    }
+    std::sort(order.begin(), order.end());
+
+    for (const auto& [boxDistance, index] : order) {
+        if (boxDistance > best.distance * best.distance) break;
+        refine(m_pieces[index], query, best);
+    }
+    return best;
+}
+
+void ClosestPointQuery::closest(std::span<const QVector3D> queries, std::span<ClosestPointResult> results,
+                                int threadCount) const
+{
+    Q_ASSERT(results.size() >= queries.size());
+
+    parallelFor(static_cast<qsizetype>(queries.size()), PARALLEL_THRESHOLD, threadCount, [&](qsizetype i) {
+        results[i] = closest(queries[i]);
+    });
+}
@@ -0,0 +1,68 @@
+//
+// ClosestPointQuery.h
+//
+
+#ifndef CURVES3D_CLOSESTPOINTQUERY_H
+#define CURVES3D_CLOSESTPOINTQUERY_H
+
+#include "CurveCalculator.h"
+
+#include <limits>
+
+struct ClosestPointResult
+{
+    qsizetype segment = -1;  // Segment of the curve (see CurveCalculator::segmentCount)
+    qreal t = 0.0;           // Parameter within that segment, in [0, 1]
+    QVector3D point;
+    qreal distance = std::numeric_limits<qreal>::infinity();
+
+    bool isValid() const { return segment >= 0; }
+    // Curve-wide parameter: segment index plus t
+    qreal parameter() const { return static_cast<qreal>(segment) + t; }
+};
+
+// Closest point on one curve for any number of query points. The curve is
+// converted once into Bézier pieces (cubic segments exactly, a high-degree
+// Bézier by De Casteljau subdivision); by the convex hull property each
+// piece's control-point box bounds it, so a query visits pieces nearest box
+// first and stops once no box can beat the best distance found. Inside a
+// piece, coarse samples pick the start and Newton iterations on
+// (C(s) - q) . C'(s) = 0 refine it. Read-only after construction, so one
+// instance serves any number of threads.
+class ClosestPointQuery
+{
+public:
+    ClosestPointQuery(CurveType type, std::span<const QVector3D> controlPoints);
+
+    bool isEmpty() const { return m_pieces.isEmpty(); }
+
+    ClosestPointResult closest(const QVector3D& query) const;
+
+    // results[i] = closest(queries[i]); large batches are split across
+    // threadCount threads (0 = one per hardware thread)
+    void closest(std::span<const QVector3D> queries, std::span<ClosestPointResult> results,
+                 int threadCount = 0) const;
+
+    // Smaller batches are answered on the calling thread
+    static constexpr qsizetype PARALLEL_THRESHOLD = 512;
+
+private:
+    struct Piece
+    {
+        qsizetype segment = 0;
+        qreal t0 = 0.0;          // Segment parameter range covered by the piece
+        qreal t1 = 1.0;
+        qsizetype firstPoint = 0; // Bézier control points in m_bezierPoints
+        int degree = 0;
+        QVector3D boxMin;
+        QVector3D boxMax;
+    };
+
+    void addPiece(qsizetype segment, qreal t0, qreal t1, std::span<const QVector3D> bezier);
+    void refine(const Piece& piece, const QVector3D& query, ClosestPointResult& best) const;
+
+    QVector<Piece> m_pieces;
+    QVector<QVector3D> m_bezierPoints;
+};
+
+#endif //CURVES3D_CLOSESTPOINTQUERY_H
@@ -0,0 +1,42 @@
+//
+// CoordinateDelegate.cpp
+//
+
+#include "CoordinateDelegate.h"
+
+#include <QDoubleSpinBox>
+
+namespace {
+
+constexpr double COORDINATE_LIMIT = 1e6;
+constexpr int EDIT_DECIMALS = 3;
+
+}
+
+QString CoordinateDelegate::displayText(const QVariant &value, const QLocale &locale) const
+{
+    return locale.toString(value.toDouble(), 'f', 1);
+}
+
+QWidget *CoordinateDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &,
+                                          const QModelIndex &) const
+{
+    QDoubleSpinBox *editor = new QDoubleSpinBox(parent);
+    editor->setRange(-COORDINATE_LIMIT, COORDINATE_LIMIT);
+    editor->setDecimals(EDIT_DECIMALS);
+    editor->setButtonSymbols(QAbstractSpinBox::NoButtons);
+    editor->setFrame(false);
+    return editor;
+}
+
+void CoordinateDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    static_cast<QDoubleSpinBox*>(editor)->setValue(index.data(Qt::EditRole).toDouble());
+}
+
+void CoordinateDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const
+{
+    QDoubleSpinBox *spinBox = static_cast<QDoubleSpinBox*>(editor);
+    spinBox->interpretText();
+    model->setData(index, spinBox->value(), Qt::EditRole);
+}
@@ -0,0 +1,26 @@
+//
+// CoordinateDelegate.h
+//
+
+#ifndef CURVES3D_COORDINATEDELEGATE_H
+#define CURVES3D_COORDINATEDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// Point table cells: shown with one decimal, edited with a spin box. The
+// editor only exists while a cell is being edited.
+class CoordinateDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    QString displayText(const QVariant &value, const QLocale &locale) const override;
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const override;
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void setModelData(QWidget *editor, QAbstractItemModel *model, const QModelIndex &index) const override;
+};
+
+#endif //CURVES3D_COORDINATEDELEGATE_H
@@ -0,0 +1,61 @@
+//
+// CurveBasis.cpp
+//
+
+#include "CurveBasis.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVarLengthArray>
+
+#include <memory>
+
+namespace {
+
+// Built lazily, never freed or rebuilt, so spans handed out stay valid
+std::unique_ptr<float[]> s_bernsteinTables[CurveBasis::MAX_TABULATED_DEGREE + 1];
+QMutex s_bernsteinMutex;
+
+std::unique_ptr<float[]> buildBernsteinTable(int degree)
+{
+    const int width = degree + 1;
+    auto table = std::make_unique<float[]>(static_cast<size_t>(CurveCalculator::SEGMENT_SAMPLES * width));
+    QVarLengthArray<qreal, CurveBasis::MAX_TABULATED_DEGREE + 1> b(width);
+
+    for (int step = 0; step < CurveCalculator::SEGMENT_SAMPLES; ++step) {
+        const qreal t = CurveBasis::stepParameter(step);
+        const qreal s = 1.0 - t;
+
+        // Triangle recurrence B_i^k = (1-t) B_i^{k-1} + t B_{i-1}^{k-1}: only
+        // convex combinations, so no cancellation or factorial overflow.
+        b[0] = 1.0;
+        for (int k = 1; k <= degree; ++k) {
+            b[k] = t * b[k - 1];
+            for (int i = k - 1; i >= 1; --i) {
+                b[i] = s * b[i] + t * b[i - 1];
+            }
+            b[0] *= s;
+        }
+
+        for (int i = 0; i < width; ++i) {
+            table[step * width + i] = static_cast<float>(b[i]);
+        }
+    }
+    return table;
+}
+
+}
+
+std::span<const float> CurveBasis::bernstein(int degree)
+{
+    if (degree < 0 || degree > MAX_TABULATED_DEGREE) {
+        return {};
+    }
+
+    QMutexLocker locker(&s_bernsteinMutex);
+    std::unique_ptr<float[]>& table = s_bernsteinTables[degree];
+    if (!table) {
+        table = buildBernsteinTable(degree);
+    }
+    return std::span<const float>(table.get(), static_cast<size_t>(CurveCalculator::SEGMENT_SAMPLES * (degree + 1)));
+}
@@ -0,0 +1,115 @@
+//
+// CurveBasis.h
+//
+
+#ifndef CURVES3D_CURVEBASIS_H
+#define CURVES3D_CURVEBASIS_H
+
+#include "CurveCalculator.h"
+
+#include <array>
+#include <span>
+
+// Blending weights of the fixed-resolution tessellation (CURVE_DETAIL steps).
+// The cubic tables are built at compile time with exactly the expressions the
+// direct evaluators use, so tabulated and direct results are bit-identical.
+class CurveBasis
+{
+public:
+    using CubicWeights = std::array<float, 4>;
+    using CubicTable = std::array<CubicWeights, CurveCalculator::SEGMENT_SAMPLES>;
+
+    // Bernstein tables are cached up to this degree, higher degrees use De Casteljau
+    static constexpr int MAX_TABULATED_DEGREE = 64;
+
+    static constexpr qreal stepParameter(int step)
+    {
+        return static_cast<qreal>(step) / static_cast<qreal>(CurveCalculator::CURVE_DETAIL);
+    }
+
+    // Q(t) = P1*H1 + P4*H2 + R1*H3 + R4*H4
+    static constexpr std::array<qreal, 4> hermiteWeights(qreal t)
+    {
+        qreal t2 = t * t;
+        qreal t3 = t2 * t;
+        return { 2.0 * t3 - 3.0 * t2 + 1.0,
+                 -2.0 * t3 + 3.0 * t2,
+                 t3 - 2.0 * t2 + t,
+                 t3 - t2 };
+    }
+
+    // Q(t) = P0*B0 + P1*B1 + P2*B2 + P3*B3
+    static constexpr std::array<qreal, 4> bsplineWeights(qreal t)
+    {
+        qreal t2 = t * t;
+        qreal t3 = t2 * t;
+        return { (-t3 + 3.0 * t2 - 3.0 * t + 1.0) / 6.0,
+                 (3.0 * t3 - 6.0 * t2 + 4.0) / 6.0,
+                 (-3.0 * t3 + 3.0 * t2 + 3.0 * t + 1.0) / 6.0,
+                 t3 / 6.0 };
+    }
+
+    // d/dt of hermiteWeights
+    static constexpr std::array<qreal, 4> hermiteDerivativeWeights(qreal t)
+    {
+        qreal t2 = t * t;
+        return { 6.0 * t2 - 6.0 * t,
+                 -6.0 * t2 + 6.0 * t,
+                 3.0 * t2 - 4.0 * t + 1.0,
+                 3.0 * t2 - 2.0 * t };
+    }
+
+    // d/dt of bsplineWeights
+    static constexpr std::array<qreal, 4> bsplineDerivativeWeights(qreal t)
+    {
+        qreal t2 = t * t;
+        return { (-t2 + 2.0 * t - 1.0) / 2.0,
+                 (3.0 * t2 - 4.0 * t) / 2.0,
+                 (-3.0 * t2 + 2.0 * t + 1.0) / 2.0,
+                 t2 / 2.0 };
+    }
+
+    // Catmull-Rom (CATMULL_ROM_TAU) folded into weights on P0..P3, so the tangents
+    // need not be formed first: Q(t) = P0*C0 + P1*C1 + P2*C2 + P3*C3
+    static constexpr std::array<qreal, 4> catmullRomWeights(qreal t)
+    {
+        const qreal tau = CurveCalculator::CATMULL_ROM_TAU;
+        const std::array<qreal, 4> h = hermiteWeights(t);
+        return { -tau * h[2],
+                 h[0] - tau * h[3],
+                 h[1] + tau * h[2],
+                 tau * h[3] };
+    }
+
+    static constexpr const CubicTable& hermite() { return s_hermite; }
+    static constexpr const CubicTable& uniformBSpline() { return s_bspline; }
+    static constexpr const CubicTable& catmullRom() { return s_catmullRom; }
+
+    // Row-major SEGMENT_SAMPLES x (degree + 1) Bernstein weights, built once per
+    // degree and shared by all threads. Empty above MAX_TABULATED_DEGREE.
+    static std::span<const float> bernstein(int degree);
+
+private:
+    template <typename Weights>
+    static constexpr CubicTable makeTable(Weights weights)
+    {
+        CubicTable table{};
+        for (int i = 0; i < CurveCalculator::SEGMENT_SAMPLES; ++i) {
+            const std::array<qreal, 4> w = weights(stepParameter(i));
+            for (int k = 0; k < 4; ++k) {
+                table[i][k] = static_cast<float>(w[k]);
+            }
+        }
+        return table;
+    }
+
+    static const CubicTable s_hermite;
+    static const CubicTable s_bspline;
+    static const CubicTable s_catmullRom;
+};
+
+inline constexpr CurveBasis::CubicTable CurveBasis::s_hermite = CurveBasis::makeTable(CurveBasis::hermiteWeights);
+inline constexpr CurveBasis::CubicTable CurveBasis::s_bspline = CurveBasis::makeTable(CurveBasis::bsplineWeights);
+inline constexpr CurveBasis::CubicTable CurveBasis::s_catmullRom = CurveBasis::makeTable(CurveBasis::catmullRomWeights);
+
+#endif //CURVES3D_CURVEBASIS_H
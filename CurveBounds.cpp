@@ -0,0 +1,53 @@
+//
+// CurveBounds.cpp
+//
+
+#include "CurveBounds.h"
+
+BoundingBox CurveBounds::segmentBox(CurveType type, std::span<const QVector3D> controlPoints, qsizetype segment,
+                                    int degree)
+{
+    const qsizetype n = static_cast<qsizetype>(controlPoints.size());
+    Q_ASSERT(segment >= 0 && segment < CurveCalculator::segmentCount(type, n, degree));
+
+    BoundingBox box;
+    if (type == CurveType::Hermite) {
+        // Same padding and tension as CurveCalculator; tangents scaled by 1/3 give the Bézier form
+        const float tau = static_cast<float>(CurveCalculator::CATMULL_ROM_TAU);
+        const QVector3D& p0 = controlPoints[std::max<qsizetype>(segment - 1, 0)];
+        const QVector3D& p1 = controlPoints[segment];
+        const QVector3D& p2 = controlPoints[segment + 1];
+        const QVector3D& p3 = controlPoints[std::min<qsizetype>(segment + 2, n - 1)];
+        box.extend(p1);
+        box.extend(p1 + (p2 - p0) * (tau / 3.0f));
+        box.extend(p2 - (p3 - p1) * (tau / 3.0f));
+        box.extend(p2);
+        return box;
+    }
+
+    qsizetype first = 0;
+    qsizetype last = 0;
+    CurveCalculator::segmentSupport(type, n, segment, first, last, degree);
+    for (qsizetype i = first; i <= last; ++i) {
+        box.extend(controlPoints[i]);
+    }
+    return box;
+}
+
+void CurveBounds::compute(CurveType type, std::span<const QVector3D> controlPoints, std::span<BoundingBox> out,
+                          int degree)
+{
+    const qsizetype segments = CurveCalculator::segmentCount(type, static_cast<qsizetype>(controlPoints.size()), degree);
+    Q_ASSERT(static_cast<qsizetype>(out.size()) == segments);
+    if (segments > 0) {
+        update(type, controlPoints, 0, segments - 1, out, degree);
+    }
+}
+
+void CurveBounds::update(CurveType type, std::span<const QVector3D> controlPoints,
+                         qsizetype first, qsizetype last, std::span<BoundingBox> out, int degree)
+{
+    for (qsizetype segment = first; segment <= last; ++segment) {
+        out[segment] = segmentBox(type, controlPoints, segment, degree);
+    }
+}
@@ -0,0 +1,54 @@
+//
+// CurveBounds.h
+//
+
+#ifndef CURVES3D_CURVEBOUNDS_H
+#define CURVES3D_CURVEBOUNDS_H
+
+#include "CurveCalculator.h"
+
+#include <limits>
+
+// Axis-aligned box; empty until a point is added
+struct BoundingBox
+{
+    QVector3D min = QVector3D(1, 1, 1) * std::numeric_limits<float>::max();
+    QVector3D max = QVector3D(1, 1, 1) * -std::numeric_limits<float>::max();
+
+    bool isEmpty() const { return min.x() > max.x(); }
+
+    void extend(const QVector3D& p)
+    {
+        min = QVector3D(std::min(min.x(), p.x()), std::min(min.y(), p.y()), std::min(min.z(), p.z()));
+        max = QVector3D(std::max(max.x(), p.x()), std::max(max.y(), p.y()), std::max(max.z(), p.z()));
+    }
+
+    void unite(const BoundingBox& other)
+    {
+        if (other.isEmpty()) return;
+        extend(other.min);
+        extend(other.max);
+    }
+};
+
+// Per-segment boxes from the control hull, which contains the segment
+// (convex hull property): the support points for Bézier and B-spline
+// segments, the Bézier control points of the Catmull-Rom segment. Cheaper
+// than boxing the samples and independent of the tessellation.
+class CurveBounds
+{
+public:
+    // degree is the B-spline degree, ignored by the other types
+    static BoundingBox segmentBox(CurveType type, std::span<const QVector3D> controlPoints, qsizetype segment,
+                                  int degree = CurveCalculator::BSPLINE_DEGREE);
+
+    // out holds segmentCount() boxes; a curve too short for segments gets none
+    static void compute(CurveType type, std::span<const QVector3D> controlPoints, std::span<BoundingBox> out,
+                        int degree = CurveCalculator::BSPLINE_DEGREE);
+    // Recomputes boxes [first, last] only, e.g. after a point moved
+    static void update(CurveType type, std::span<const QVector3D> controlPoints,
+                       qsizetype first, qsizetype last, std::span<BoundingBox> out,
+                       int degree = CurveCalculator::BSPLINE_DEGREE);
+};
+
+#endif //CURVES3D_CURVEBOUNDS_H
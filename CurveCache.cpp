@@ -0,0 +1,245 @@
+//
+// CurveCache.cpp
+//
+
+#include "CurveCache.h"
+
+#include <algorithm>
+
+namespace {
+
+// Beyond this share of moved points a full rebuild is cheaper than patching
+constexpr qsizetype PATCH_LIMIT_DIVISOR = 4;
+
+// Fixed rebuilds longer than this poll the interrupt check between blocks of segments
+constexpr qsizetype REBUILD_BLOCK_SEGMENTS = 4096;
+
+}
+
+void CurveCache::setType(CurveType type)
+{
+    if (m_type != type) {
+        m_type = type;
+        m_arcLengthStale = true;
+        resolveEvaluator();
+        rebuild();
+    }
+}
+
+void CurveCache::setDegree(int degree)
+{
+    Q_ASSERT(degree >= 1);
+    if (m_degree != degree) {
+        m_degree = degree;
+        m_arcLengthStale = true;
+        resolveEvaluator();
+        if (m_type == CurveType::BSpline) {
+            rebuild();
+        }
+    }
+}
+
+void CurveCache::setAdaptive(bool enabled, const TessellationOptions& options)
+{
+    if (m_adaptive == enabled && m_adaptiveOptions == options) return;
+
+    m_adaptive = enabled;
+    m_adaptiveOptions = options;
+    rebuild();
+}
+
+void CurveCache::setControlPoints(const QList<QVector3D>& points)
+{
+    if (!m_complete) {
+        m_controlPoints = points;
+        m_arcLengthStale = true;
+        resolveEvaluator();
+        rebuild();
+        return;
+    }
+
+    if (points.size() != m_controlPoints.size() || m_adaptive) {
+        if (points != m_controlPoints) {
+            m_controlPoints = points;
+            m_arcLengthStale = true;
+            resolveEvaluator();
+            rebuild();
+        }
+        return;
+    }
+
+    QList<qsizetype> moved;
+    for (qsizetype i = 0; i < points.size(); ++i) {
+        if (points[i] != m_controlPoints[i]) {
+            moved.append(i);
+            if (moved.size() > points.size() / PATCH_LIMIT_DIVISOR + 1) {
+                m_controlPoints = points;
+                m_arcLengthStale = true;
+                rebuild();
+                return;
+            }
+        }
+    }
+
+    for (qsizetype index : moved) {
+        movePoint(index, points[index]);
+    }
+}
+
+void CurveCache::movePoint(qsizetype index, const QVector3D& position)
+{
+    Q_ASSERT(index >= 0 && index < m_controlPoints.size());
+    if (m_controlPoints[index] == position) return;
+
+    m_controlPoints[index] = position;
+
+    const bool hasSegments = CurveCalculator::segmentCount(m_type, m_controlPoints.size(), m_degree) > 0;
+    qsizetype firstSegment = 0;
+    qsizetype lastSegment = 0;
+    if (hasSegments) {
+        CurveCalculator::affectedSegments(m_type, m_controlPoints.size(), index, firstSegment, lastSegment,
+                                          m_degree);
+        m_arcLengthDirty.unite({ firstSegment, lastSegment - firstSegment + 1 });
+    }
+
+    if (m_adaptive || !m_complete) {
+        rebuild();
+        return;
+    }
+
+    if (!hasSegments) {
+        // Below the minimum point count the "curve" is the points themselves
+        m_vertices[index] = position;
+        m_dirty.unite({ index, 1 });
+        return;
+    }
+
+    patchSegments(firstSegment, lastSegment);
+}
+
+void CurveCache::movePoints(const QList<qsizetype>& indices, const QList<QVector3D>& positions)
+{
+    Q_ASSERT(indices.size() == positions.size());
+    if (indices.isEmpty()) return;
+
+    if (m_adaptive || !m_complete || indices.size() > m_controlPoints.size() / PATCH_LIMIT_DIVISOR + 1) {
+        for (qsizetype i = 0; i < indices.size(); ++i) {
+            m_controlPoints[indices[i]] = positions[i];
+        }
+        m_arcLengthStale = true;
+        rebuild();
+        return;
+    }
+
+    for (qsizetype i = 0; i < indices.size(); ++i) {
+        movePoint(indices[i], positions[i]);
+    }
+}
+
+void CurveCache::patchSegments(qsizetype firstSegment, qsizetype lastSegment)
+{
+    const std::span<const QVector3D> points(m_controlPoints.constData(), static_cast<size_t>(m_controlPoints.size()));
+    const std::span<QVector3D> out(m_vertices.data(), static_cast<size_t>(m_vertices.size()));
+
+    for (qsizetype segment = firstSegment; segment <= lastSegment; ++segment) {
+        CurveCalculator::evaluateSegment(m_type, points, segment, out, BasisEvaluation::Tabulated, m_degree);
+    }
+    CurveBounds::update(m_type, points, firstSegment, lastSegment,
+                        std::span<BoundingBox>(m_segmentBounds.data(), static_cast<size_t>(m_segmentBounds.size())),
+                        m_degree);
+
+    const qsizetype first = CurveCalculator::segmentVertexOffset(m_type, firstSegment);
+    const qsizetype end = CurveCalculator::segmentVertexOffset(m_type, lastSegment)
+                        + CurveCalculator::segmentVertexCount(m_type, lastSegment);
+    m_dirty.unite({ first, end - first });
+    m_boundsDirty.unite({ firstSegment, lastSegment - firstSegment + 1 });
+}
+
+void CurveCache::resolveEvaluator()
+{
+    // The specializations are cubic when it comes to B-splines
+    const bool cubic = m_type != CurveType::BSpline || m_degree == CurveCalculator::BSPLINE_DEGREE;
+    m_evaluator = cubic ? FixedDegreeKernels::find(m_type, m_controlPoints.size()) : nullptr;
+}
+
+void CurveCache::rebuild()
+{
+    const qsizetype oldSize = m_vertices.size();
+    const std::span<const QVector3D> points(m_controlPoints.constData(), static_cast<size_t>(m_controlPoints.size()));
+
+    if (m_adaptive) {
+        m_segmentBounds.clear();
+        m_vertices.clear();
+        m_complete = !AdaptiveTessellator::tessellate(m_type, points, m_adaptiveOptions, m_vertices,
+                                                      m_interrupted, m_degree).interrupted;
+    } else {
+        m_vertices.resize(CurveCalculator::outputSize(m_type, m_controlPoints.size(), m_degree));
+        const std::span<QVector3D> out(m_vertices.data(), static_cast<size_t>(m_vertices.size()));
+        const qsizetype segments = CurveCalculator::segmentCount(m_type, m_controlPoints.size(), m_degree);
+        m_segmentBounds.resize(segments);
+        const std::span<BoundingBox> bounds(m_segmentBounds.data(), static_cast<size_t>(m_segmentBounds.size()));
+
+        m_complete = true;
+        if (m_interrupted && segments > REBUILD_BLOCK_SEGMENTS) {
+            // Segment by segment is bit-identical to the whole-curve kernels
+            for (qsizetype first = 0; first < segments; first += REBUILD_BLOCK_SEGMENTS) {
+                if (m_interrupted()) {
+                    m_complete = false;
+                    break;
+                }
+                const qsizetype last = std::min(first + REBUILD_BLOCK_SEGMENTS, segments) - 1;
+                for (qsizetype segment = first; segment <= last; ++segment) {
+                    CurveCalculator::evaluateSegment(m_type, points, segment, out, BasisEvaluation::Tabulated,
+                                                     m_degree);
+                }
+                CurveBounds::update(m_type, points, first, last, bounds, m_degree);
+            }
+        } else {
+            if (m_evaluator) {
+                m_evaluator(points, out);
+            } else {
+                CurveCalculator::evaluate(m_type, points, out, BasisEvaluation::Tabulated, m_degree);
+            }
+            CurveBounds::compute(m_type, points, bounds, m_degree);
+        }
+    }
+
+    m_layoutChanged = m_layoutChanged || m_vertices.size() != oldSize;
+    m_dirty = { 0, m_vertices.size() };
+    m_boundsDirty = { 0, m_segmentBounds.size() };
+}
+
+const ArcLengthTable& CurveCache::arcLength()
+{
+    if (m_arcLengthStale || m_arcLength.type() != m_type || m_arcLength.degree() != m_degree
+        || m_arcLength.pointCount() != m_controlPoints.size()) {
+        m_arcLength.rebuild(m_type, m_controlPoints, m_degree);
+    } else if (!m_arcLengthDirty.isEmpty()) {
+        m_arcLength.updateSegments(m_controlPoints, m_arcLengthDirty.first, m_arcLengthDirty.end() - 1);
+    }
+
+    m_arcLengthStale = false;
+    m_arcLengthDirty = {};
+    return m_arcLength;
+}
+
+IndexRange CurveCache::takeDirtyVertices()
+{
+    const IndexRange dirty = m_dirty;
+    m_dirty = {};
+    return dirty;
+}
+
+IndexRange CurveCache::takeDirtyBounds()
+{
+    const IndexRange dirty = m_boundsDirty;
+    m_boundsDirty = {};
+    return dirty;
+}
+
+bool CurveCache::takeLayoutChanged()
+{
+    const bool changed = m_layoutChanged;
+    m_layoutChanged = false;
+    return changed;
+}
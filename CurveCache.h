@@ -0,0 +1,89 @@
+//
+// CurveCache.h
+//
+
+#ifndef CURVES3D_CURVECACHE_H
+#define CURVES3D_CURVECACHE_H
+
+#include "CurveCalculator.h"
+#include "AdaptiveTessellator.h"
+#include "FixedDegreeKernels.h"
+#include "ArcLengthTable.h"
+#include "CurveBounds.h"
+#include "IndexRange.h"
+
+#include <functional>
+
+// Tessellated curve plus the bookkeeping to patch it: moving one control
+// point re-evaluates only the segments in its local support (four for the
+// cubic B-spline and Catmull-Rom) and records which vertices changed, so
+// the renderer can upload just that range.
+class CurveCache
+{
+public:
+    CurveType type() const { return m_type; }
+    const QList<QVector3D>& controlPoints() const { return m_controlPoints; }
+    const QVector<QVector3D>& vertices() const { return m_vertices; }
+    // One box per segment, patched along with the vertices; empty while
+    // adaptive, where segments have no fixed vertex range to cull or thin out
+    const QVector<BoundingBox>& segmentBounds() const { return m_segmentBounds; }
+
+    void setType(CurveType type);
+    // B-spline degree; the other types ignore it
+    void setDegree(int degree);
+    int degree() const { return m_degree; }
+    // Adaptive tessellation changes the vertex layout on every edit, so it always rebuilds
+    void setAdaptive(bool enabled, const TessellationOptions& options = TessellationOptions());
+    bool isAdaptive() const { return m_adaptive; }
+
+    // Polled between segments of an adaptive rebuild, and between blocks of
+    // segments of a long fixed one; a rebuild it cuts short leaves the cache
+    // incomplete and the next edit rebuilds from scratch
+    void setInterruptCheck(std::function<bool()> interrupted) { m_interrupted = std::move(interrupted); }
+    bool isComplete() const { return m_complete; }
+
+    // Diffs against the cached points; a few moved points are patched in place
+    void setControlPoints(const QList<QVector3D>& points);
+    void movePoint(qsizetype index, const QVector3D& position);
+    // Several moves at once: patched one by one, or one rebuild when that is cheaper
+    void movePoints(const QList<qsizetype>& indices, const QList<QVector3D>& positions);
+
+    // Arc-length table of the current points, brought up to date on demand:
+    // only segments touched by moved points since the last call are re-integrated
+    const ArcLengthTable& arcLength();
+
+    // Vertices rewritten since the last call; the whole buffer after a rebuild
+    IndexRange takeDirtyVertices();
+    // Same for segmentBounds(), in segments
+    IndexRange takeDirtyBounds();
+    // True when the vertex count changed, i.e. GPU storage must be reallocated
+    bool takeLayoutChanged();
+
+private:
+    void rebuild();
+    void resolveEvaluator();
+    void patchSegments(qsizetype firstSegment, qsizetype lastSegment);
+
+    CurveType m_type = CurveType::Bezier;
+    int m_degree = CurveCalculator::BSPLINE_DEGREE;
+    FixedDegreeKernels::Evaluator m_evaluator = nullptr; // Follows type, degree and point count
+    bool m_adaptive = false;
+    TessellationOptions m_adaptiveOptions;
+
+    QList<QVector3D> m_controlPoints;
+    QVector<QVector3D> m_vertices;
+    QVector<BoundingBox> m_segmentBounds;
+
+    IndexRange m_dirty;
+    IndexRange m_boundsDirty;
+    bool m_layoutChanged = true;
+
+    ArcLengthTable m_arcLength;
+    IndexRange m_arcLengthDirty; // Segments
+    bool m_arcLengthStale = true;
+
+    std::function<bool()> m_interrupted;
+    bool m_complete = true;
+};
+
+#endif //CURVES3D_CURVECACHE_H
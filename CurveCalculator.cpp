@@ -3,77 +3,289 @@
 //
 
 #include "CurveCalculator.h"
+#include "CurveBasis.h"
+#include "CurveKernels.h"
+#include "NurbsEvaluator.h"
 
 #include <QtMath>
+#include <QVarLengthArray>
 #include <QDebug>
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace {
+
+std::span<const QVector3D> asSpan(const QList<QVector3D>& points)
+{
+    return std::span<const QVector3D>(points.constData(), static_cast<size_t>(points.size()));
+}
+
+QVector<QVector3D> evaluateToVector(CurveType type, const QList<QVector3D>& controlPoints,
+                                    int degree = CurveCalculator::BSPLINE_DEGREE)
+{
+    QVector<QVector3D> calculatedPoints(CurveCalculator::outputSize(type, controlPoints.size(), degree));
+    CurveCalculator::evaluate(type, asSpan(controlPoints),
+                              std::span<QVector3D>(calculatedPoints.data(), static_cast<size_t>(calculatedPoints.size())),
+                              BasisEvaluation::Tabulated, degree);
+    return calculatedPoints;
+}
+
+// Every span of a uniform B-spline is the span [degree, degree + 1] of its
+// degree + 1 points over the knots 0, 1, ..., 2 * degree + 1. One de Boor
+// evaluator per thread and degree is built for that shape and refilled with
+// each span's points, so whole curves and patched segments share the exact
+// same arithmetic and nothing is allocated per span.
+NurbsEvaluator& uniformSpanEvaluator(std::span<const QVector3D> points, int degree)
+{
+    Q_ASSERT(degree >= 1 && static_cast<qsizetype>(points.size()) == degree + 1);
+
+    thread_local std::vector<std::unique_ptr<NurbsEvaluator>> evaluators;
+    if (static_cast<int>(evaluators.size()) <= degree) {
+        evaluators.resize(static_cast<size_t>(degree) + 1);
+    }
+
+    std::unique_ptr<NurbsEvaluator>& evaluator = evaluators[static_cast<size_t>(degree)];
+    if (!evaluator) {
+        NurbsCurve curve;
+        curve.degree = degree;
+        curve.controlPoints = QList<QVector3D>(points.begin(), points.end());
+        curve.knots = NurbsCurve::uniformKnots(degree + 1, degree);
+        evaluator = std::make_unique<NurbsEvaluator>(curve);
+    } else {
+        evaluator->setControlPoints(points);
+    }
+    return *evaluator;
+}
+
+QVector3D uniformSpanPoint(std::span<const QVector3D> points, int degree, qreal t)
+{
+    return uniformSpanEvaluator(points, degree).point(degree + t);
+}
+
+// Q = P0*W0 + P1*W1 + P2*W2 + P3*W3 for every row of a precomputed table
+void evaluateCubicTable(const CurveBasis::CubicTable& table,
+                        const QVector3D& p0, const QVector3D& p1,
+                        const QVector3D& p2, const QVector3D& p3,
+                        QVector3D* out)
+{
+    for (const CurveBasis::CubicWeights& w : table) {
+        *out++ = p0 * w[0] + p1 * w[1] + p2 * w[2] + p3 * w[3];
+    }
+}
+
+// Feeds sliding-window cubic segments through CurveKernels in chunks small
+// enough for stack SoA buffers, then interleaves the result into out.
+constexpr qsizetype KERNEL_CHUNK_SEGMENTS = 16;
+
+template <typename PointAt>
+qsizetype evaluateCubicVectorized(CubicSegmentBasis basis, qsizetype segments, PointAt pointAt,
+                                  QVector3D* out, bool shareJoints)
+{
+    constexpr int samples = CurveCalculator::SEGMENT_SAMPLES;
+    float inX[KERNEL_CHUNK_SEGMENTS + 3], inY[KERNEL_CHUNK_SEGMENTS + 3], inZ[KERNEL_CHUNK_SEGMENTS + 3];
+    float outX[KERNEL_CHUNK_SEGMENTS * samples], outY[KERNEL_CHUNK_SEGMENTS * samples], outZ[KERNEL_CHUNK_SEGMENTS * samples];
+    qsizetype written = 0;
+
+    for (qsizetype first = 0; first < segments; first += KERNEL_CHUNK_SEGMENTS) {
+        const qsizetype count = std::min(KERNEL_CHUNK_SEGMENTS, segments - first);
+        for (qsizetype k = 0; k < count + 3; ++k) {
+            const QVector3D p = pointAt(first + k);
+            inX[k] = p.x();
+            inY[k] = p.y();
+            inZ[k] = p.z();
+        }
+
+        CurveKernels::evaluateSegments(basis, SoAPoints{ inX, inY, inZ, count + 3 }, SoAOutput{ outX, outY, outZ });
+
+        for (qsizetype seg = 0; seg < count; ++seg) {
+            const int from = (shareJoints && first + seg > 0) ? 1 : 0;
+            for (int s = from; s < samples; ++s) {
+                const qsizetype idx = seg * samples + s;
+                out[written++] = QVector3D(outX[idx], outY[idx], outZ[idx]);
+            }
+        }
+    }
+    return written;
+}
+
+}
+
 // --- Helper: De Casteljau for a single t (3D) ---
-QVector3D CurveCalculator::deCasteljau(const QList<QVector3D>& controlPoints, qreal t)
+QVector3D CurveCalculator::deCasteljau(std::span<const QVector3D> controlPoints, qreal t,
+                                       std::span<QVector3D> scratch)
 {
-    if (controlPoints.isEmpty()) {
+    if (controlPoints.empty()) {
         return QVector3D(0, 0, 0);
     }
 
-    QVector<QVector3D> points = controlPoints.toVector();
-    int n = points.size() - 1;
+    Q_ASSERT(scratch.size() >= controlPoints.size());
+    std::copy(controlPoints.begin(), controlPoints.end(), scratch.begin());
+    int n = static_cast<int>(controlPoints.size()) - 1;
 
     for (int r = 1; r <= n; ++r) {
         for (int i = 0; i <= n - r; ++i) {
             // Vector interpolation: Q_i^r = (1-t) * Q_i^{r-1} + t * Q_{i+1}^{r-1}
-            points[i] = (1.0 - t) * points[i] + t * points[i+1];
+            scratch[i] = (1.0 - t) * scratch[i] + t * scratch[i+1];
         }
     }
-    return points[0];
+    return scratch[0];
+}
+
+// --- Helper: Bernstein sum for a single t (3D) ---
+QVector3D CurveCalculator::bezierPoint(std::span<const QVector3D> controlPoints, qreal t)
+{
+    if (controlPoints.empty()) {
+        return QVector3D(0, 0, 0);
+    }
+
+    const int n = static_cast<int>(controlPoints.size()) - 1;
+    if (n == 0 || t <= 0.0) return controlPoints.front();
+    if (t >= 1.0) return controlPoints.back();
+
+    const qreal s = 1.0 - t;
+    const qreal ratio = t / s;
+
+    // Start from the largest weight B_m^n, m = floor((n+1)t), computed through
+    // lgamma so neither C(n,m) nor t^m s^(n-m) can overflow or underflow, then
+    // walk outwards with B_{i+1}/B_i = (n-i)/(i+1) * t/s. Weights shrink
+    // monotonically away from the mode, so the walk stops once they no longer
+    // affect a double sum.
+    const int m = std::clamp(static_cast<int>(std::floor((n + 1) * t)), 0, n);
+    const qreal logMode = std::lgamma(n + 1.0) - std::lgamma(m + 1.0) - std::lgamma(n - m + 1.0)
+                        + m * std::log(t) + (n - m) * std::log(s);
+    const qreal mode = std::exp(logMode);
+    const qreal cutoff = mode * 1e-17;
+
+    qreal x = mode * controlPoints[m].x();
+    qreal y = mode * controlPoints[m].y();
+    qreal z = mode * controlPoints[m].z();
+
+    qreal b = mode;
+    for (int i = m; i < n; ++i) {
+        b *= ratio * (n - i) / (i + 1);
+        if (b < cutoff) break;
+        x += b * controlPoints[i + 1].x();
+        y += b * controlPoints[i + 1].y();
+        z += b * controlPoints[i + 1].z();
+    }
+
+    b = mode;
+    for (int i = m; i > 0; --i) {
+        b *= i / ((n - i + 1) * ratio);
+        if (b < cutoff) break;
+        x += b * controlPoints[i - 1].x();
+        y += b * controlPoints[i - 1].y();
+        z += b * controlPoints[i - 1].z();
+    }
+
+    return QVector3D(x, y, z);
 }
 
 // --- 1. Bézier Curve (3D) ---
 QVector<QVector3D> CurveCalculator::calculateBezier_DeCasteljau(const QList<QVector3D>& controlPoints)
 {
-    QVector<QVector3D> calculatedPoints;
+    return evaluateToVector(CurveType::Bezier, controlPoints);
+}
 
-    if (controlPoints.size() < 2) return controlPoints.toVector();
+qsizetype CurveCalculator::evaluateBezier(std::span<const QVector3D> controlPoints, std::span<QVector3D> out,
+                                          BasisEvaluation mode)
+{
+    if (controlPoints.size() < 2) {
+        std::copy(controlPoints.begin(), controlPoints.end(), out.begin());
+        return static_cast<qsizetype>(controlPoints.size());
+    }
 
-    qreal numSteps = static_cast<qreal>(CURVE_DETAIL);
+    const int degree = static_cast<int>(controlPoints.size()) - 1;
+    // Bézier has no vectorized kernel, so Vectorized uses the tables too
+    const std::span<const float> weights = (mode != BasisEvaluation::Direct)
+            ? CurveBasis::bernstein(degree) : std::span<const float>();
 
-    for (int i = 0; i <= numSteps; ++i) {
-        qreal t = static_cast<qreal>(i) / numSteps;
-        QVector3D curvePoint = deCasteljau(controlPoints, t);
-        calculatedPoints.append(curvePoint);
+    if (!weights.empty()) {
+        // Q(t_i) = sum_k B_k^n(t_i) * P_k
+        const float* row = weights.data();
+        for (int i = 0; i <= CURVE_DETAIL; ++i, row += degree + 1) {
+            QVector3D curvePoint = controlPoints[0] * row[0];
+            for (int k = 1; k <= degree; ++k) {
+                curvePoint += controlPoints[k] * row[k];
+            }
+            out[i] = curvePoint;
+        }
+        return SEGMENT_SAMPLES;
     }
-    return calculatedPoints;
+
+    if (mode != BasisEvaluation::Direct) {
+        // Degree too high for a cached table: O(n) per sample instead of O(n^2)
+        for (int i = 0; i <= CURVE_DETAIL; ++i) {
+            out[i] = bezierPoint(controlPoints, CurveBasis::stepParameter(i));
+        }
+        return SEGMENT_SAMPLES;
+    }
+
+    // One scratch triangle per thread, grown on demand and reused by every curve
+    thread_local QVector<QVector3D> scratch;
+    if (scratch.size() < static_cast<qsizetype>(controlPoints.size())) {
+        scratch.resize(static_cast<qsizetype>(controlPoints.size()));
+    }
+    std::span<QVector3D> scratchSpan(scratch.data(), static_cast<size_t>(scratch.size()));
+
+    for (int i = 0; i <= CURVE_DETAIL; ++i) {
+        out[i] = deCasteljau(controlPoints, CurveBasis::stepParameter(i), scratchSpan);
+    }
+    return SEGMENT_SAMPLES;
 }
 
 // --- 2. Hermite Curve (3D) ---
 QVector<QVector3D> CurveCalculator::calculateHermite_Matrix(const QVector3D& p1, const QVector3D& p4,
                                                         const QVector3D& r1, const QVector3D& r4)
 {
-    QVector<QVector3D> calculatedPoints;
-    qreal numSteps = static_cast<qreal>(CURVE_DETAIL);
+    QVector<QVector3D> calculatedPoints(SEGMENT_SAMPLES);
+    evaluateHermite(p1, p4, r1, r4, std::span<QVector3D>(calculatedPoints.data(), SEGMENT_SAMPLES));
+    return calculatedPoints;
+}
+
+void CurveCalculator::evaluateHermite(const QVector3D& p1, const QVector3D& p4,
+                                      const QVector3D& r1, const QVector3D& r4,
+                                      std::span<QVector3D> out,
+                                      BasisEvaluation mode)
+{
+    Q_ASSERT(out.size() >= SEGMENT_SAMPLES);
+
+    if (mode == BasisEvaluation::Tabulated) {
+        evaluateCubicTable(CurveBasis::hermite(), p1, p4, r1, r4, out.data());
+        return;
+    }
 
-    for (int i = 0; i <= numSteps; ++i) {
-        qreal t = static_cast<qreal>(i) / numSteps;
-        qreal t2 = t * t;
-        qreal t3 = t2 * t;
+    if (mode == BasisEvaluation::Vectorized) {
+        const float xs[4] = { p1.x(), p4.x(), r1.x(), r4.x() };
+        const float ys[4] = { p1.y(), p4.y(), r1.y(), r4.y() };
+        const float zs[4] = { p1.z(), p4.z(), r1.z(), r4.z() };
+        float outX[SEGMENT_SAMPLES], outY[SEGMENT_SAMPLES], outZ[SEGMENT_SAMPLES];
+
+        CurveKernels::evaluateSegments(CubicSegmentBasis::Hermite, SoAPoints{ xs, ys, zs, 4 },
+                                       SoAOutput{ outX, outY, outZ });
+        for (int i = 0; i <= CURVE_DETAIL; ++i) {
+            out[i] = QVector3D(outX[i], outY[i], outZ[i]);
+        }
+        return;
+    }
 
+    for (int i = 0; i <= CURVE_DETAIL; ++i) {
         // Hermite Blending Functions
-        qreal h1 = 2.0 * t3 - 3.0 * t2 + 1.0;
-        qreal h2 = -2.0 * t3 + 3.0 * t2;
-        qreal h3 = t3 - 2.0 * t2 + t;
-        qreal h4 = t3 - t2;
+        const std::array<qreal, 4> h = CurveBasis::hermiteWeights(CurveBasis::stepParameter(i));
 
         // Vector calculation: Q(t) = P1*H1 + P4*H2 + R1*H3 + R4*H4
-        QVector3D q_t = p1 * h1 + p4 * h2 + r1 * h3 + r4 * h4;
-
-        calculatedPoints.append(q_t);
+        out[i] = p1 * h[0] + p4 * h[1] + r1 * h[2] + r4 * h[3];
     }
-    return calculatedPoints;
 }
 
 // --- Helper: Catmull-Rom Segment (3D) ---
 QVector<QVector3D> CurveCalculator::calculateCatmullRomSegment(const QVector3D& p0, const QVector3D& p1,
                                                            const QVector3D& p2, const QVector3D& p3)
 {
-    qreal tau = 0.5;
+    const qreal tau = CATMULL_ROM_TAU;
 
     // Tangent R1 = (P2 - P0) * tau
     QVector3D r1 = (p2 - p0) * tau;
@@ -84,39 +296,371 @@ QVector<QVector3D> CurveCalculator::calculateCatmullRomSegment(const QVector3D&
     return calculateHermite_Matrix(p1, p2, r1, r2);
 }
 
+QVector<QVector3D> CurveCalculator::calculateCatmullRom(const QList<QVector3D>& controlPoints)
+{
+    return evaluateToVector(CurveType::Hermite, controlPoints);
+}
+
+qsizetype CurveCalculator::evaluateCatmullRom(std::span<const QVector3D> controlPoints, std::span<QVector3D> out,
+                                              BasisEvaluation mode)
+{
+    const qsizetype n = static_cast<qsizetype>(controlPoints.size());
+    if (n < 2) {
+        std::copy(controlPoints.begin(), controlPoints.end(), out.begin());
+        return n;
+    }
+
+    if (mode == BasisEvaluation::Vectorized) {
+        // Padded point i is P[i - 1] clamped to the ends, as in the scalar loop below
+        auto paddedAt = [&](qsizetype i) {
+            return controlPoints[std::clamp<qsizetype>(i - 1, 0, n - 1)];
+        };
+        return evaluateCubicVectorized(CubicSegmentBasis::CatmullRom, n - 1, paddedAt, out.data(), true);
+    }
+
+    const qreal tau = CATMULL_ROM_TAU;
+    QVector3D segment[SEGMENT_SAMPLES];
+    qsizetype written = 0;
+
+    // Endpoint padding: P0 and PN are repeated so the chain starts/ends on them
+    for (qsizetype i = 0; i < n - 1; ++i) {
+        const QVector3D& p0 = controlPoints[std::max<qsizetype>(i - 1, 0)];
+        const QVector3D& p1 = controlPoints[i];
+        const QVector3D& p2 = controlPoints[i + 1];
+        const QVector3D& p3 = controlPoints[std::min<qsizetype>(i + 2, n - 1)];
+
+        QVector3D r1 = (p2 - p0) * tau;
+        QVector3D r2 = (p3 - p1) * tau;
+        evaluateHermite(p1, p2, r1, r2, segment, mode);
+
+        // Consecutive segments share their joint, keep it only once
+        const int first = (i == 0) ? 0 : 1;
+        std::copy(segment + first, segment + SEGMENT_SAMPLES, out.begin() + written);
+        written += SEGMENT_SAMPLES - first;
+    }
+    return written;
+}
+
 // --- 3. B-Spline Curve (3D) ---
 QVector<QVector3D> CurveCalculator::calculateBSpline(const QList<QVector3D>& controlPoints, int degree)
+{
+    // No curve without a degree: same fallback as too few points
+    if (degree < 1) {
+        return QVector<QVector3D>(controlPoints.cbegin(), controlPoints.cend());
+    }
+    return evaluateToVector(CurveType::BSpline, controlPoints, degree);
+}
+
+QVector<QVector3D> CurveCalculator::calculateNurbs(const NurbsCurve& curve)
 {
     QVector<QVector3D> calculatedPoints;
+    NurbsEvaluator evaluator(curve);
+    evaluator.tessellate(calculatedPoints);
+    return calculatedPoints;
+}
+
+qsizetype CurveCalculator::evaluateBSpline(std::span<const QVector3D> controlPoints, std::span<QVector3D> out,
+                                           BasisEvaluation mode, int degree)
+{
+    const qsizetype n = static_cast<qsizetype>(controlPoints.size());
+    if (n < degree + 1) {
+        std::copy(controlPoints.begin(), controlPoints.end(), out.begin());
+        return n;
+    }
+
+    if (degree != BSPLINE_DEGREE) {
+        // De Boor, span by span; the tables and SIMD kernels are cubic only
+        for (qsizetype i = 0; i + degree < n; ++i) {
+            uniformSpanEvaluator(controlPoints.subspan(static_cast<size_t>(i), static_cast<size_t>(degree) + 1), degree)
+                .tessellateSpan(degree, out.subspan(static_cast<size_t>(i * SEGMENT_SAMPLES), SEGMENT_SAMPLES));
+        }
+        return (n - degree) * SEGMENT_SAMPLES;
+    }
 
-    if (controlPoints.size() < 4) {
-        return controlPoints.toVector();
+    if (mode == BasisEvaluation::Vectorized) {
+        auto pointAt = [&](qsizetype i) { return controlPoints[i]; };
+        return evaluateCubicVectorized(CubicSegmentBasis::UniformBSpline, n - 3, pointAt, out.data(), false);
     }
 
-    qreal numSteps = static_cast<qreal>(CURVE_DETAIL);
+    qsizetype written = 0;
 
-    for (int i = 3; i < controlPoints.size(); ++i) {
+    for (qsizetype i = 3; i < n; ++i) {
         const QVector3D& p0 = controlPoints[i-3];
         const QVector3D& p1 = controlPoints[i-2];
         const QVector3D& p2 = controlPoints[i-1];
         const QVector3D& p3 = controlPoints[i];
 
-        for (int j = 0; j <= numSteps; ++j) {
-            qreal t = static_cast<qreal>(j) / numSteps;
-            qreal t2 = t * t;
-            qreal t3 = t2 * t;
+        if (mode == BasisEvaluation::Tabulated) {
+            evaluateCubicTable(CurveBasis::uniformBSpline(), p0, p1, p2, p3, out.data() + written);
+            written += SEGMENT_SAMPLES;
+            continue;
+        }
 
+        for (int j = 0; j <= CURVE_DETAIL; ++j) {
             // Uniform Cubic B-Spline Blending Functions
-            qreal b0 = (-t3 + 3.0 * t2 - 3.0 * t + 1.0) / 6.0;
-            qreal b1 = (3.0 * t3 - 6.0 * t2 + 4.0) / 6.0;
-            qreal b2 = (-3.0 * t3 + 3.0 * t2 + 3.0 * t + 1.0) / 6.0;
-            qreal b3 = t3 / 6.0;
+            const std::array<qreal, 4> b = CurveBasis::bsplineWeights(CurveBasis::stepParameter(j));
 
             // Vector calculation: Q(t) = P0*B0 + P1*B1 + P2*B2 + P3*B3
-            QVector3D q_t = p0 * b0 + p1 * b1 + p2 * b2 + p3 * b3;
+            out[written++] = p0 * b[0] + p1 * b[1] + p2 * b[2] + p3 * b[3];
+        }
+    }
+    return written;
+}
+
+// --- Generic entry points ---
+
+QVector<QVector3D> CurveCalculator::calculate(CurveType type, const QList<QVector3D>& controlPoints)
+{
+    return evaluateToVector(type, controlPoints);
+}
+
+qsizetype CurveCalculator::outputSize(CurveType type, qsizetype pointCount, int degree)
+{
+    switch (type) {
+    case CurveType::Bezier:
+        return pointCount < 2 ? pointCount : SEGMENT_SAMPLES;
+    case CurveType::Hermite:
+        return pointCount < 2 ? pointCount : (pointCount - 1) * CURVE_DETAIL + 1;
+    case CurveType::BSpline:
+        return pointCount < degree + 1 ? pointCount : (pointCount - degree) * SEGMENT_SAMPLES;
+    }
+    return 0;
+}
+
+qsizetype CurveCalculator::evaluate(CurveType type, std::span<const QVector3D> controlPoints,
+                                    std::span<QVector3D> out,
+                                    BasisEvaluation mode, int degree)
+{
+    Q_ASSERT(degree >= 1);
+    Q_ASSERT(static_cast<qsizetype>(out.size()) >= outputSize(type, static_cast<qsizetype>(controlPoints.size()), degree));
+
+    switch (type) {
+    case CurveType::Bezier:
+        return evaluateBezier(controlPoints, out, mode);
+    case CurveType::Hermite:
+        return evaluateCatmullRom(controlPoints, out, mode);
+    case CurveType::BSpline:
+        return evaluateBSpline(controlPoints, out, mode, degree);
+    }
+    return 0;
+}
+
+// --- Segment API ---
+
+qsizetype CurveCalculator::segmentCount(CurveType type, qsizetype pointCount, int degree)
+{
+    switch (type) {
+    case CurveType::Bezier:
+        return pointCount < 2 ? 0 : 1;
+    case CurveType::Hermite:
+        return pointCount < 2 ? 0 : pointCount - 1;
+    case CurveType::BSpline:
+        return pointCount < degree + 1 ? 0 : pointCount - degree;
+    }
+    return 0;
+}
+
+QVector3D CurveCalculator::segmentPoint(CurveType type, std::span<const QVector3D> controlPoints,
+                                        qsizetype segment, qreal t, int degree)
+{
+    const qsizetype n = static_cast<qsizetype>(controlPoints.size());
+    Q_ASSERT(segment >= 0 && segment < segmentCount(type, n, degree));
 
-            calculatedPoints.append(q_t);
+    switch (type) {
+    case CurveType::Bezier:
+        return bezierPoint(controlPoints, t);
+    case CurveType::Hermite: {
+        const qreal tau = CATMULL_ROM_TAU;
+        const QVector3D& p0 = controlPoints[std::max<qsizetype>(segment - 1, 0)];
+        const QVector3D& p1 = controlPoints[segment];
+        const QVector3D& p2 = controlPoints[segment + 1];
+        const QVector3D& p3 = controlPoints[std::min<qsizetype>(segment + 2, n - 1)];
+        const std::array<qreal, 4> h = CurveBasis::hermiteWeights(t);
+        return p1 * h[0] + p2 * h[1] + (p2 - p0) * tau * h[2] + (p3 - p1) * tau * h[3];
+    }
+    case CurveType::BSpline: {
+        if (degree != BSPLINE_DEGREE) {
+            return uniformSpanPoint(controlPoints.subspan(static_cast<size_t>(segment), static_cast<size_t>(degree) + 1),
+                                    degree, t);
         }
+        const std::array<qreal, 4> b = CurveBasis::bsplineWeights(t);
+        return controlPoints[segment] * b[0] + controlPoints[segment + 1] * b[1]
+             + controlPoints[segment + 2] * b[2] + controlPoints[segment + 3] * b[3];
     }
-    return calculatedPoints;
-}
\ No newline at end of file
+    }
+    return QVector3D(0, 0, 0);
+}
+
+QVector3D CurveCalculator::segmentDerivative(CurveType type, std::span<const QVector3D> controlPoints,
+                                             qsizetype segment, qreal t, int degree)
+{
+    const qsizetype n = static_cast<qsizetype>(controlPoints.size());
+    Q_ASSERT(segment >= 0 && segment < segmentCount(type, n, degree));
+
+    switch (type) {
+    case CurveType::Bezier: {
+        // C'(t) = n * sum B_i^(n-1)(t) (P_(i+1) - P_i)
+        thread_local QVector<QVector3D> differences;
+        differences.resize(n - 1);
+        for (qsizetype i = 0; i + 1 < n; ++i) {
+            differences[i] = controlPoints[i + 1] - controlPoints[i];
+        }
+        const std::span<const QVector3D> hodograph(differences.constData(), static_cast<size_t>(n - 1));
+        return bezierPoint(hodograph, t) * static_cast<float>(n - 1);
+    }
+    case CurveType::Hermite: {
+        const qreal tau = CATMULL_ROM_TAU;
+        const QVector3D& p0 = controlPoints[std::max<qsizetype>(segment - 1, 0)];
+        const QVector3D& p1 = controlPoints[segment];
+        const QVector3D& p2 = controlPoints[segment + 1];
+        const QVector3D& p3 = controlPoints[std::min<qsizetype>(segment + 2, n - 1)];
+        const std::array<qreal, 4> h = CurveBasis::hermiteDerivativeWeights(t);
+        return p1 * h[0] + p2 * h[1] + (p2 - p0) * tau * h[2] + (p3 - p1) * tau * h[3];
+    }
+    case CurveType::BSpline: {
+        if (degree != BSPLINE_DEGREE) {
+            // Unit knot spacing: C'(t) is the degree - 1 spline of P_(i+1) - P_i
+            if (degree == 1) return controlPoints[segment + 1] - controlPoints[segment];
+            QVarLengthArray<QVector3D, 8> differences(degree);
+            for (int i = 0; i < degree; ++i) {
+                differences[i] = controlPoints[segment + i + 1] - controlPoints[segment + i];
+            }
+            return uniformSpanPoint(std::span<const QVector3D>(differences.constData(), static_cast<size_t>(degree)),
+                                    degree - 1, t);
+        }
+        const std::array<qreal, 4> b = CurveBasis::bsplineDerivativeWeights(t);
+        return controlPoints[segment] * b[0] + controlPoints[segment + 1] * b[1]
+             + controlPoints[segment + 2] * b[2] + controlPoints[segment + 3] * b[3];
+    }
+    }
+    return QVector3D(0, 0, 0);
+}
+
+void CurveCalculator::segmentSupport(CurveType type, qsizetype pointCount, qsizetype segment,
+                                     qsizetype& first, qsizetype& last, int degree)
+{
+    switch (type) {
+    case CurveType::Bezier:
+        first = 0;
+        last = pointCount - 1;
+        return;
+    case CurveType::Hermite:
+        first = std::max<qsizetype>(segment - 1, 0);
+        last = std::min<qsizetype>(segment + 2, pointCount - 1);
+        return;
+    case CurveType::BSpline:
+        first = segment;
+        last = segment + degree;
+        return;
+    }
+}
+
+void CurveCalculator::affectedSegments(CurveType type, qsizetype pointCount, qsizetype index,
+                                       qsizetype& first, qsizetype& last, int degree)
+{
+    const qsizetype segments = segmentCount(type, pointCount, degree);
+
+    switch (type) {
+    case CurveType::Bezier:
+        first = 0;
+        last = segments - 1;
+        return;
+    case CurveType::Hermite:
+        first = std::max<qsizetype>(index - 2, 0);
+        last = std::min<qsizetype>(index + 1, segments - 1);
+        return;
+    case CurveType::BSpline:
+        first = std::max<qsizetype>(index - degree, 0);
+        last = std::min<qsizetype>(index, segments - 1);
+        return;
+    }
+}
+
+qsizetype CurveCalculator::segmentVertexOffset(CurveType type, qsizetype segment)
+{
+    if (type == CurveType::Hermite && segment > 0) {
+        return SEGMENT_SAMPLES + (segment - 1) * CURVE_DETAIL;
+    }
+    return segment * SEGMENT_SAMPLES;
+}
+
+qsizetype CurveCalculator::segmentVertexCount(CurveType type, qsizetype segment)
+{
+    return (type == CurveType::Hermite && segment > 0) ? CURVE_DETAIL : SEGMENT_SAMPLES;
+}
+
+void CurveCalculator::evaluateSegment(CurveType type, std::span<const QVector3D> controlPoints,
+                                      qsizetype segment, std::span<QVector3D> out,
+                                      BasisEvaluation mode, int degree)
+{
+    const qsizetype n = static_cast<qsizetype>(controlPoints.size());
+    Q_ASSERT(segment >= 0 && segment < segmentCount(type, n, degree));
+
+    QVector3D* dst = out.data() + segmentVertexOffset(type, segment);
+
+    switch (type) {
+    case CurveType::Bezier:
+        evaluateBezier(controlPoints, out, mode);
+        return;
+    case CurveType::BSpline:
+        // A B-spline of degree + 1 points is exactly one segment
+        evaluateBSpline(controlPoints.subspan(static_cast<size_t>(segment), static_cast<size_t>(degree) + 1),
+                        std::span<QVector3D>(dst, SEGMENT_SAMPLES), mode, degree);
+        return;
+    case CurveType::Hermite:
+        break;
+    }
+
+    QVector3D samples[SEGMENT_SAMPLES];
+    if (mode == BasisEvaluation::Vectorized) {
+        auto paddedAt = [&](qsizetype i) {
+            return controlPoints[std::clamp<qsizetype>(segment + i - 1, 0, n - 1)];
+        };
+        evaluateCubicVectorized(CubicSegmentBasis::CatmullRom, 1, paddedAt, samples, false);
+    } else {
+        const qreal tau = CATMULL_ROM_TAU;
+        const QVector3D& p0 = controlPoints[std::max<qsizetype>(segment - 1, 0)];
+        const QVector3D& p1 = controlPoints[segment];
+        const QVector3D& p2 = controlPoints[segment + 1];
+        const QVector3D& p3 = controlPoints[std::min<qsizetype>(segment + 2, n - 1)];
+        evaluateHermite(p1, p2, (p2 - p0) * tau, (p3 - p1) * tau, samples, mode);
+    }
+
+    const int first = (segment == 0) ? 0 : 1;
+    std::copy(samples + first, samples + SEGMENT_SAMPLES, dst);
+}
+
+// --- Batch API ---
+
+qsizetype CurveCalculator::batchLayout(std::span<const CurveBatchItem> curves, std::span<qsizetype> offsets)
+{
+    Q_ASSERT(offsets.size() == curves.size() + 1);
+
+    qsizetype total = 0;
+    for (size_t i = 0; i < curves.size(); ++i) {
+        offsets[i] = total;
+        total += outputSize(curves[i].type, curves[i].pointCount);
+    }
+    offsets[curves.size()] = total;
+    return total;
+}
+
+void CurveCalculator::evaluateBatch(std::span<const QVector3D> controlPoints,
+                                    std::span<const CurveBatchItem> curves,
+                                    std::span<const qsizetype> offsets,
+                                    std::span<QVector3D> out,
+                                    BasisEvaluation mode)
+{
+    Q_ASSERT(offsets.size() == curves.size() + 1);
+    Q_ASSERT(static_cast<qsizetype>(out.size()) >= offsets[curves.size()]);
+
+    for (size_t i = 0; i < curves.size(); ++i) {
+        const CurveBatchItem& curve = curves[i];
+        Q_ASSERT(curve.firstPoint + curve.pointCount <= static_cast<qsizetype>(controlPoints.size()));
+
+        evaluate(curve.type,
+                 controlPoints.subspan(static_cast<size_t>(curve.firstPoint), static_cast<size_t>(curve.pointCount)),
+                 out.subspan(static_cast<size_t>(offsets[i]), static_cast<size_t>(offsets[i + 1] - offsets[i])),
+                 mode);
+    }
+}
@@ -10,10 +10,47 @@
 #include <QList>
 #include <QVector>
 
+#include <span>
+
+struct NurbsCurve;
+
+// Curve families understood by the batch API.
+enum class CurveType
+{
+    Bezier,     // One Bézier curve over all control points
+    Hermite,    // Catmull-Rom chain through all control points (Hermite segments)
+    BSpline     // Uniform B-spline, cubic unless a degree is given
+};
+
+// How fixed-resolution samples are produced
+enum class BasisEvaluation
+{
+    Direct,     // Blending polynomials / De Casteljau evaluated for every sample
+    Tabulated,  // Weighted sums over the precomputed CurveBasis tables (O(n) Bernstein sums
+                // for Bézier degrees above CurveBasis::MAX_TABULATED_DEGREE)
+    Vectorized  // CurveKernels SIMD batch kernel for cubic segments (Bézier stays tabulated)
+};
+
+// One curve inside a batch: a slice of the shared control-point span.
+struct CurveBatchItem
+{
+    CurveType type = CurveType::Bezier;
+    qsizetype firstPoint = 0;
+    qsizetype pointCount = 0;
+};
+
 class CurveCalculator
 {
 public:
     static constexpr int CURVE_DETAIL = 100;
+    // Samples written per curve or per segment (both end points included)
+    static constexpr int SEGMENT_SAMPLES = CURVE_DETAIL + 1;
+    // Tangent scale of the Catmull-Rom chain: R_i = (P_(i+1) - P_(i-1)) * tau
+    static constexpr qreal CATMULL_ROM_TAU = 0.5;
+    // Degree of CurveType::BSpline where a call does not pass one. Every span
+    // of a uniform B-spline of degree d is one segment shaped by d + 1 points,
+    // so a curve has n - d segments; the degree is ignored by the other types.
+    static constexpr int BSPLINE_DEGREE = 3;
 
     // --- Core Curve Algorithms (Use QVector3D) ---
     static QVector<QVector3D> calculateBezier_DeCasteljau(const QList<QVector3D>& controlPoints);
@@ -21,16 +58,101 @@ public:
     static QVector<QVector3D> calculateHermite_Matrix(const QVector3D& p1, const QVector3D& p4,
                                                     const QVector3D& r1, const QVector3D& r4);
 
+    // Uniform B-spline of the given degree: the tabulated path for cubics, de Boor
+    // (NurbsEvaluator) for other degrees, n - degree segments either way
     static QVector<QVector3D> calculateBSpline(const QList<QVector3D>& controlPoints, int degree);
 
+    // Non-uniform, possibly rational B-spline; see NurbsEvaluator
+    static QVector<QVector3D> calculateNurbs(const NurbsCurve& curve);
+
     // --- Helper for Hermite/Catmull-Rom ---
     static QVector<QVector3D> calculateCatmullRomSegment(const QVector3D& p0, const QVector3D& p1,
                                                        const QVector3D& p2, const QVector3D& p3);
+
+    // Whole Catmull-Rom chain, padded so that it starts at P0 and ends at PN
+    static QVector<QVector3D> calculateCatmullRom(const QList<QVector3D>& controlPoints);
+
+    static QVector<QVector3D> calculate(CurveType type, const QList<QVector3D>& controlPoints);
+
+    // --- Span API (caller owns the output, nothing is allocated) ---
+
+    // Single Bézier point in O(n) with no scratch memory; stable for any degree
+    static QVector3D bezierPoint(std::span<const QVector3D> controlPoints, qreal t);
+
+    // Number of vertices produced for a curve of the given type
+    static qsizetype outputSize(CurveType type, qsizetype pointCount, int degree = BSPLINE_DEGREE);
+
+    // Writes outputSize(type, controlPoints.size(), degree) vertices into out, returns that count
+    static qsizetype evaluate(CurveType type, std::span<const QVector3D> controlPoints,
+                              std::span<QVector3D> out,
+                              BasisEvaluation mode = BasisEvaluation::Tabulated,
+                              int degree = BSPLINE_DEGREE);
+
+    static void evaluateHermite(const QVector3D& p1, const QVector3D& p4,
+                                const QVector3D& r1, const QVector3D& r4,
+                                std::span<QVector3D> out,
+                                BasisEvaluation mode = BasisEvaluation::Tabulated);
+
+    // --- Segment API (t in [0, 1] within one segment) ---
+
+    // Bézier curves are one segment, Catmull-Rom chains n-1, B-splines n-degree
+    static qsizetype segmentCount(CurveType type, qsizetype pointCount, int degree = BSPLINE_DEGREE);
+
+    static QVector3D segmentPoint(CurveType type, std::span<const QVector3D> controlPoints,
+                                  qsizetype segment, qreal t, int degree = BSPLINE_DEGREE);
+
+    // dC/dt within the segment; Bézier curves use their hodograph, B-splines
+    // of other degrees than 3 the degree - 1 spline of the point differences
+    static QVector3D segmentDerivative(CurveType type, std::span<const QVector3D> controlPoints,
+                                       qsizetype segment, qreal t, int degree = BSPLINE_DEGREE);
+
+    // Control points [first, last] that shape a segment (local support)
+    static void segmentSupport(CurveType type, qsizetype pointCount, qsizetype segment,
+                               qsizetype& first, qsizetype& last, int degree = BSPLINE_DEGREE);
+
+    // Segments [first, last] whose shape depends on control point index
+    static void affectedSegments(CurveType type, qsizetype pointCount, qsizetype index,
+                                 qsizetype& first, qsizetype& last, int degree = BSPLINE_DEGREE);
+
+    // Where a segment's samples live inside the output of evaluate(); B-spline
+    // segments are SEGMENT_SAMPLES each whatever the degree
+    static qsizetype segmentVertexOffset(CurveType type, qsizetype segment);
+    static qsizetype segmentVertexCount(CurveType type, qsizetype segment);
+
+    // Rewrites only that segment's range of a full evaluate() output, with the
+    // same arithmetic, so patched and fully rebuilt outputs are identical.
+    static void evaluateSegment(CurveType type, std::span<const QVector3D> controlPoints,
+                                qsizetype segment, std::span<QVector3D> out,
+                                BasisEvaluation mode = BasisEvaluation::Tabulated,
+                                int degree = BSPLINE_DEGREE);
+
+    // --- Batch API ---
+
+    // Fills offsets (curves.size() + 1 entries) with the start of every curve's
+    // output range and returns the total number of vertices needed.
+    static qsizetype batchLayout(std::span<const CurveBatchItem> curves, std::span<qsizetype> offsets);
+
+    // Evaluates every curve into out[offsets[i], offsets[i + 1]).
+    static void evaluateBatch(std::span<const QVector3D> controlPoints,
+                              std::span<const CurveBatchItem> curves,
+                              std::span<const qsizetype> offsets,
+                              std::span<QVector3D> out,
+                              BasisEvaluation mode = BasisEvaluation::Tabulated);
+
 private:
     // Helper for De Casteljau (3D vector math works identically)
-    static QVector3D deCasteljau(const QList<QVector3D>& controlPoints, qreal t);
+    // scratch must hold controlPoints.size() entries
+    static QVector3D deCasteljau(std::span<const QVector3D> controlPoints, qreal t,
+                                 std::span<QVector3D> scratch);
+
+    static qsizetype evaluateBezier(std::span<const QVector3D> controlPoints, std::span<QVector3D> out,
+                                    BasisEvaluation mode);
+    static qsizetype evaluateCatmullRom(std::span<const QVector3D> controlPoints, std::span<QVector3D> out,
+                                        BasisEvaluation mode);
+    static qsizetype evaluateBSpline(std::span<const QVector3D> controlPoints, std::span<QVector3D> out,
+                                     BasisEvaluation mode, int degree);
 };
 
 
 
-#endif //CURVES3D_CURVECALCULATOR_H
\ No newline at end of file
+#endif //CURVES3D_CURVECALCULATOR_H
@@ -0,0 +1,126 @@
+//
+// CurveEvaluationWorker.cpp
+//
+
+#include "CurveEvaluationWorker.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+void CurveResult::applyTo(QVector<QVector3D>& allVertices, QVector<BoundingBox>& allBounds) const
+{
+    applySlice(allVertices, vertexCount, vertices, dirty);
+    applySlice(allBounds, segmentCount, segmentBounds, dirtyBounds);
+}
+
+CurveEvaluationWorker::CurveEvaluationWorker(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<CurveResult>();
+
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName("CurveEvaluationWorker");
+    m_thread->start();
+}
+
+CurveEvaluationWorker::~CurveEvaluationWorker()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_jobAvailable.wakeOne();
+    }
+    m_thread->wait();
+    delete m_thread;
+}
+
+quint64 CurveEvaluationWorker::submit(CurveJob job)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // A job not yet started is overwritten: only the newest edit matters. Moves
+    // build on the points of the waiting job, so those are carried over.
+    if (m_hasPendingJob && !job.resetPoints) {
+        if (m_pendingJob.resetPoints) {
+            for (qsizetype i = 0; i < job.movedIndices.size(); ++i) {
+                m_pendingJob.controlPoints[job.movedIndices[i]] = job.movedPositions[i];
+            }
+        } else {
+            m_pendingJob.movedIndices.append(job.movedIndices);
+            m_pendingJob.movedPositions.append(job.movedPositions);
+        }
+        job.resetPoints = m_pendingJob.resetPoints;
+        job.controlPoints = std::move(m_pendingJob.controlPoints);
+        job.movedIndices = std::move(m_pendingJob.movedIndices);
+        job.movedPositions = std::move(m_pendingJob.movedPositions);
+    }
+    m_pendingJob = std::move(job);
+    m_hasPendingJob = true;
+    m_jobAvailable.wakeOne();
+    return ++m_latestGeneration;
+}
+
+void CurveEvaluationWorker::run()
+{
+    // A rebuild is worth finishing only while nothing newer is waiting
+    m_cache.setInterruptCheck([this] {
+        QMutexLocker locker(&m_mutex);
+        return m_hasPendingJob || m_quit;
+    });
+
+    forever {
+        CurveJob job;
+        quint64 generation = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_hasPendingJob && !m_quit) {
+                m_jobAvailable.wait(&m_mutex);
+            }
+            if (m_quit) return;
+
+            job = std::move(m_pendingJob);
+            m_hasPendingJob = false;
+            generation = m_latestGeneration;
+        }
+
+        // The cache diffs against the last evaluated points, so skipped jobs cost nothing
+        const qint64 startNs = FrameProfiler::now();
+        m_cache.setType(job.type);
+        m_cache.setDegree(job.degree);
+        m_cache.setAdaptive(job.adaptive, job.options);
+        if (job.resetPoints) {
+            m_cache.setControlPoints(job.controlPoints);
+        } else {
+            m_cache.movePoints(job.movedIndices, job.movedPositions);
+        }
+
+        m_undeliveredDirty.unite(m_cache.takeDirtyVertices());
+        m_undeliveredBoundsDirty.unite(m_cache.takeDirtyBounds());
+        m_undeliveredLayoutChanged = m_cache.takeLayoutChanged() || m_undeliveredLayoutChanged;
+
+        // An abandoned rebuild is partial; the newer job will rebuild it anyway
+        if (!m_cache.isComplete()) continue;
+
+        // Only the changed slices are copied: the cache keeps patching its own
+        // arrays in place and never shares them with the GUI thread
+        CurveResult result;
+        result.generation = generation;
+        result.type = m_cache.type();
+        result.vertexCount = m_cache.vertices().size();
+        result.dirty = m_undeliveredDirty;
+        result.vertices = sliceOf(m_cache.vertices(), result.dirty);
+        result.segmentCount = m_cache.segmentBounds().size();
+        result.dirtyBounds = m_undeliveredBoundsDirty;
+        result.segmentBounds = sliceOf(m_cache.segmentBounds(), result.dirtyBounds);
+        result.layoutChanged = m_undeliveredLayoutChanged;
+        // Moved points re-integrate only their segments of the cached table
+        result.length = m_cache.arcLength().totalLength();
+        result.evaluationStartNs = startNs;
+        result.evaluationNs = FrameProfiler::now() - startNs;
+        m_undeliveredDirty = {};
+        m_undeliveredBoundsDirty = {};
+        m_undeliveredLayoutChanged = false;
+
+        emit resultReady(result);
+    }
+}
@@ -0,0 +1,103 @@
+//
+// CurveEvaluationWorker.h
+//
+
+#ifndef CURVES3D_CURVEEVALUATIONWORKER_H
+#define CURVES3D_CURVEEVALUATIONWORKER_H
+
+#include "CurveCache.h"
+#include "FrameProfiler.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QWaitCondition>
+
+class QThread;
+
+// What to tessellate; each submission supersedes every earlier one. The
+// points travel either as a snapshot the job owns (resetPoints) or as moves
+// relative to the previous job, never as the model's own list: sharing it
+// would make every later edit copy the whole list on the GUI thread.
+struct CurveJob
+{
+    CurveType type = CurveType::Bezier;
+    int degree = CurveCalculator::BSPLINE_DEGREE;
+    bool adaptive = false;
+    TessellationOptions options;
+    bool resetPoints = false;
+    QList<QVector3D> controlPoints;   // With resetPoints
+    QList<qsizetype> movedIndices;    // Otherwise
+    QList<QVector3D> movedPositions;
+};
+
+// Tessellated curve handed back to the GUI thread. Only what changed since
+// the previous delivered result travels, including jobs that were dropped:
+// vertices holds [dirty.first, dirty.end()) of the curve and segmentBounds
+// the boxes in dirtyBounds, both copied out of the worker's cache so no
+// array is shared between the threads.
+struct CurveResult
+{
+    quint64 generation = 0;
+    CurveType type = CurveType::Bezier;
+    qsizetype vertexCount = 0;
+    QVector<QVector3D> vertices;
+    IndexRange dirty;
+    qsizetype segmentCount = 0; // 0 for adaptive tessellation, which has no boxes
+    qreal length = 0.0;         // Arc length of the curve itself, whatever the tessellation
+    QVector<BoundingBox> segmentBounds;
+    IndexRange dirtyBounds;
+    bool layoutChanged = false;
+    // When the delivered job started and how long it took, on FrameProfiler::now()'s clock
+    qint64 evaluationStartNs = 0;
+    qint64 evaluationNs = 0;
+
+    // Brings the receiver's copy of the curve up to date
+    void applyTo(QVector<QVector3D>& allVertices, QVector<BoundingBox>& allBounds) const;
+};
+
+Q_DECLARE_METATYPE(CurveResult)
+
+// Evaluates curves on a dedicated thread with latest-wins semantics: a job
+// still waiting is replaced by a newer submission (moves are folded into
+// it, since they are relative to it), and an adaptive rebuild
+// in progress is abandoned as soon as a newer job arrives. submit() only
+// swaps a pending slot under a mutex, so the GUI thread never waits on the
+// curve math. Completed results are delivered in order through resultReady,
+// queued to the receiver's thread; receivers must apply every one of them,
+// since each carries only the vertices changed since the last. Long fixed
+// rebuilds are abandoned the same way as adaptive ones.
+class CurveEvaluationWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CurveEvaluationWorker(QObject *parent = nullptr);
+    ~CurveEvaluationWorker() override;
+
+    // Returns the generation the eventual result will carry; results with an
+    // older generation are intermediate states of the curve
+    quint64 submit(CurveJob job);
+
+signals:
+    void resultReady(const CurveResult& result);
+
+private:
+    void run();
+
+    QThread *m_thread = nullptr;
+
+    QMutex m_mutex;
+    QWaitCondition m_jobAvailable;
+    CurveJob m_pendingJob;
+    bool m_hasPendingJob = false;
+    bool m_quit = false;
+    quint64 m_latestGeneration = 0;
+
+    // Worker thread only
+    CurveCache m_cache;
+    IndexRange m_undeliveredDirty;
+    IndexRange m_undeliveredBoundsDirty;
+    bool m_undeliveredLayoutChanged = false;
+};
+
+#endif //CURVES3D_CURVEEVALUATIONWORKER_H
@@ -0,0 +1,274 @@
+//
+// CurveKernels.cpp
+//
+
+#include "CurveKernels.h"
+#include "CurveBasis.h"
+
+#include <QByteArray>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CURVES3D_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CURVES3D_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CURVES3D_TARGET_AVX2
+#endif
+
+namespace {
+
+constexpr int SAMPLES = CurveCalculator::SEGMENT_SAMPLES;
+// Rounded up to whole AVX2 registers so aligned loads never leave the table
+constexpr int PADDED_SAMPLES = (SAMPLES + 7) / 8 * 8;
+
+// One basis table transposed to SoA: w[k][s] is the weight of P_k at step s
+struct SoATable
+{
+    alignas(32) float w[4][PADDED_SAMPLES];
+};
+
+constexpr SoATable transpose(const CurveBasis::CubicTable& table)
+{
+    SoATable soa{};
+    for (int s = 0; s < SAMPLES; ++s) {
+        for (int k = 0; k < 4; ++k) {
+            soa.w[k][s] = table[s][k];
+        }
+    }
+    return soa;
+}
+
+constexpr SoATable s_hermiteTable = transpose(CurveBasis::hermite());
+constexpr SoATable s_catmullRomTable = transpose(CurveBasis::catmullRom());
+constexpr SoATable s_bsplineTable = transpose(CurveBasis::uniformBSpline());
+
+const SoATable& tableFor(CubicSegmentBasis basis)
+{
+    switch (basis) {
+    case CubicSegmentBasis::Hermite:
+        return s_hermiteTable;
+    case CubicSegmentBasis::CatmullRom:
+        return s_catmullRomTable;
+    case CubicSegmentBasis::UniformBSpline:
+        break;
+    }
+    return s_bsplineTable;
+}
+
+// Distance in points between the first coefficients of consecutive segments
+qsizetype strideFor(CubicSegmentBasis basis)
+{
+    return basis == CubicSegmentBasis::Hermite ? 4 : 1;
+}
+
+// Reference expression shared by every ISA (also used for the vector tails)
+inline void evaluateAxisScalar(const SoATable& table, const float* c, float* out, int from)
+{
+    for (int s = from; s < SAMPLES; ++s) {
+        out[s] = c[0] * table.w[0][s] + c[1] * table.w[1][s] + c[2] * table.w[2][s] + c[3] * table.w[3][s];
+    }
+}
+
+void evaluateScalar(const SoATable& table, const SoAPoints& points, qsizetype segments, qsizetype stride,
+                    const SoAOutput& out)
+{
+    const float* in[3] = { points.x, points.y, points.z };
+    float* dst[3] = { out.x, out.y, out.z };
+
+    for (qsizetype seg = 0; seg < segments; ++seg) {
+        for (int axis = 0; axis < 3; ++axis) {
+            evaluateAxisScalar(table, in[axis] + seg * stride, dst[axis] + seg * SAMPLES, 0);
+        }
+    }
+}
+
+#ifdef CURVES3D_X86_64
+
+void evaluateSse2(const SoATable& table, const SoAPoints& points, qsizetype segments, qsizetype stride,
+                  const SoAOutput& out)
+{
+    constexpr int lanes = 4;
+    constexpr int vectorEnd = SAMPLES / lanes * lanes;
+    const float* in[3] = { points.x, points.y, points.z };
+    float* dst[3] = { out.x, out.y, out.z };
+
+    for (qsizetype seg = 0; seg < segments; ++seg) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const float* c = in[axis] + seg * stride;
+            float* o = dst[axis] + seg * SAMPLES;
+            const __m128 c0 = _mm_set1_ps(c[0]);
+            const __m128 c1 = _mm_set1_ps(c[1]);
+            const __m128 c2 = _mm_set1_ps(c[2]);
+            const __m128 c3 = _mm_set1_ps(c[3]);
+
+            for (int s = 0; s < vectorEnd; s += lanes) {
+                __m128 acc = _mm_mul_ps(c0, _mm_load_ps(&table.w[0][s]));
+                acc = _mm_add_ps(acc, _mm_mul_ps(c1, _mm_load_ps(&table.w[1][s])));
+                acc = _mm_add_ps(acc, _mm_mul_ps(c2, _mm_load_ps(&table.w[2][s])));
+                acc = _mm_add_ps(acc, _mm_mul_ps(c3, _mm_load_ps(&table.w[3][s])));
+                _mm_storeu_ps(o + s, acc);
+            }
+            evaluateAxisScalar(table, c, o, vectorEnd);
+        }
+    }
+}
+
+CURVES3D_TARGET_AVX2
+void evaluateAvx2(const SoATable& table, const SoAPoints& points, qsizetype segments, qsizetype stride,
+                  const SoAOutput& out)
+{
+    constexpr int lanes = 8;
+    constexpr int vectorEnd = SAMPLES / lanes * lanes;
+    const float* in[3] = { points.x, points.y, points.z };
+    float* dst[3] = { out.x, out.y, out.z };
+
+    for (qsizetype seg = 0; seg < segments; ++seg) {
+        for (int axis = 0; axis < 3; ++axis) {
+            const float* c = in[axis] + seg * stride;
+            float* o = dst[axis] + seg * SAMPLES;
+            const __m256 c0 = _mm256_set1_ps(c[0]);
+            const __m256 c1 = _mm256_set1_ps(c[1]);
+            const __m256 c2 = _mm256_set1_ps(c[2]);
+            const __m256 c3 = _mm256_set1_ps(c[3]);
+
+            for (int s = 0; s < vectorEnd; s += lanes) {
+                __m256 acc = _mm256_mul_ps(c0, _mm256_load_ps(&table.w[0][s]));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(c1, _mm256_load_ps(&table.w[1][s])));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(c2, _mm256_load_ps(&table.w[2][s])));
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(c3, _mm256_load_ps(&table.w[3][s])));
+                _mm256_storeu_ps(o + s, acc);
+            }
+            evaluateAxisScalar(table, c, o, vectorEnd);
+        }
+    }
+}
+
+bool cpuHasAvx2()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // AVX state must be enabled by the OS (OSXSAVE + XCR0 bits 1 and 2)
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+#endif // CURVES3D_X86_64
+
+SimdIsa detectIsa()
+{
+    SimdIsa best = SimdIsa::Scalar;
+    if (CurveKernels::isSupported(SimdIsa::AVX2)) best = SimdIsa::AVX2;
+    else if (CurveKernels::isSupported(SimdIsa::SSE2)) best = SimdIsa::SSE2;
+
+    // Lets benchmarks and bug reports pin a narrower path
+    const QByteArray forced = qgetenv("CURVES3D_SIMD").toLower();
+    if (forced == "scalar") return SimdIsa::Scalar;
+    if (forced == "sse2" && CurveKernels::isSupported(SimdIsa::SSE2)) return SimdIsa::SSE2;
+    if (forced == "avx2" && CurveKernels::isSupported(SimdIsa::AVX2)) return SimdIsa::AVX2;
+    return best;
+}
+
+}
+
+SimdIsa CurveKernels::activeIsa()
+{
+    static const SimdIsa isa = detectIsa();
+    return isa;
+}
+
+bool CurveKernels::isSupported(SimdIsa isa)
+{
+    switch (isa) {
+    case SimdIsa::Scalar:
+        return true;
+#ifdef CURVES3D_X86_64
+    case SimdIsa::SSE2:
+        return true;    // Baseline on x86-64
+    case SimdIsa::AVX2: {
+        static const bool avx2 = cpuHasAvx2();
+        return avx2;
+    }
+#else
+    case SimdIsa::SSE2:
+    case SimdIsa::AVX2:
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char* CurveKernels::isaName(SimdIsa isa)
+{
+    switch (isa) {
+    case SimdIsa::Scalar:
+        return "scalar";
+    case SimdIsa::SSE2:
+        return "sse2";
+    case SimdIsa::AVX2:
+        return "avx2";
+    }
+    return "unknown";
+}
+
+qsizetype CurveKernels::segmentCount(CubicSegmentBasis basis, qsizetype pointCount)
+{
+    if (basis == CubicSegmentBasis::Hermite) {
+        return pointCount / 4;
+    }
+    return pointCount < 4 ? 0 : pointCount - 3;
+}
+
+qsizetype CurveKernels::evaluateSegments(CubicSegmentBasis basis, const SoAPoints& points, const SoAOutput& out)
+{
+    return evaluateSegments(basis, points, out, activeIsa());
+}
+
+qsizetype CurveKernels::evaluateSegments(CubicSegmentBasis basis, const SoAPoints& points, const SoAOutput& out,
+                                         SimdIsa isa)
+{
+    const qsizetype segments = segmentCount(basis, points.size);
+    if (segments == 0) {
+        return 0;
+    }
+
+    const SoATable& table = tableFor(basis);
+    const qsizetype stride = strideFor(basis);
+
+    if (!isSupported(isa)) {
+        isa = SimdIsa::Scalar;
+    }
+
+    switch (isa) {
+#ifdef CURVES3D_X86_64
+    case SimdIsa::AVX2:
+        evaluateAvx2(table, points, segments, stride, out);
+        break;
+    case SimdIsa::SSE2:
+        evaluateSse2(table, points, segments, stride, out);
+        break;
+#endif
+    default:
+        evaluateScalar(table, points, segments, stride, out);
+        break;
+    }
+    return segments * SAMPLES;
+}
@@ -0,0 +1,66 @@
+//
+// CurveKernels.h
+//
+
+#ifndef CURVES3D_CURVEKERNELS_H
+#define CURVES3D_CURVEKERNELS_H
+
+#include <QtGlobal>
+
+// Instruction set used by the batch kernels. Scalar is always available;
+// the x86 paths are compiled in on x86-64 and picked at runtime.
+enum class SimdIsa
+{
+    Scalar,
+    SSE2,   // 4 samples per instruction
+    AVX2    // 8 samples per instruction
+};
+
+// Structure-of-arrays control points: x[i], y[i], z[i] form point i
+struct SoAPoints
+{
+    const float* x = nullptr;
+    const float* y = nullptr;
+    const float* z = nullptr;
+    qsizetype size = 0;
+};
+
+struct SoAOutput
+{
+    float* x = nullptr;
+    float* y = nullptr;
+    float* z = nullptr;
+};
+
+enum class CubicSegmentBasis
+{
+    Hermite,        // Points come in groups of 4: P1, P4, R1, R4 per segment
+    CatmullRom,     // Sliding window P[i..i+3], no end padding
+    UniformBSpline  // Sliding window P[i..i+3]
+};
+
+// Vectorized evaluation of cubic segments at the CURVE_DETAIL steps of CurveBasis.
+//
+// Every sample is P0*W0 + P1*W1 + P2*W2 + P3*W3 multiplied and summed in that
+// order on every ISA, and CurveKernels.cpp is built without FP contraction, so
+// all ISAs produce bit-identical results. Hermite and B-spline output is also
+// bit-identical to CurveCalculator; Catmull-Rom uses point-form weights and
+// differs from the tangent form by less than 1e-6 of the largest coordinate.
+class CurveKernels
+{
+public:
+    // Best ISA of this CPU, or the one forced by CURVES3D_SIMD=scalar|sse2|avx2
+    static SimdIsa activeIsa();
+    static bool isSupported(SimdIsa isa);
+    static const char* isaName(SimdIsa isa);
+
+    static qsizetype segmentCount(CubicSegmentBasis basis, qsizetype pointCount);
+
+    // Writes segmentCount() * SEGMENT_SAMPLES samples per axis; consecutive
+    // segments keep both end points, exactly like CurveCalculator::calculateBSpline.
+    static qsizetype evaluateSegments(CubicSegmentBasis basis, const SoAPoints& points, const SoAOutput& out);
+    static qsizetype evaluateSegments(CubicSegmentBasis basis, const SoAPoints& points, const SoAOutput& out,
+                                      SimdIsa isa);
+};
+
+#endif //CURVES3D_CURVEKERNELS_H
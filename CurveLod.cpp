@@ -0,0 +1,163 @@
+//
+// CurveLod.cpp
+//
+
+#include "CurveLod.h"
+
+#include <cmath>
+
+namespace {
+
+// Intervals a segment may be drawn with, ascending: the divisors of CURVE_DETAIL
+const QVector<int>& intervalLevels()
+{
+    static const QVector<int> levels = [] {
+        QVector<int> divisors;
+        for (int d = 1; d <= CurveCalculator::CURVE_DETAIL; ++d) {
+            if (CurveCalculator::CURVE_DETAIL % d == 0) divisors.append(d);
+        }
+        return divisors;
+    }();
+    return levels;
+}
+
+// First vertex of a segment's samples; Catmull-Rom segments after the first
+// share their start with the previous segment's end
+qsizetype segmentStart(CurveType type, qsizetype segment)
+{
+    const qsizetype offset = CurveCalculator::segmentVertexOffset(type, segment);
+    return (type == CurveType::Hermite && segment > 0) ? offset - 1 : offset;
+}
+
+qsizetype fixedVertexCount(CurveType type, qsizetype segments)
+{
+    return segments == 0 ? 0 : segmentStart(type, segments - 1) + CurveCalculator::SEGMENT_SAMPLES;
+}
+
+void beginRun(LodDrawList& out)
+{
+    out.runFirsts.append(static_cast<int>(out.indices.size()));
+    out.runCounts.append(0);
+}
+
+void endRun(LodDrawList& out)
+{
+    out.runCounts.last() = static_cast<int>(out.indices.size()) - out.runFirsts.last();
+    // A single vertex draws nothing as a line strip
+    if (out.runCounts.last() < 2) {
+        out.indices.resize(out.runFirsts.last());
+        out.runFirsts.removeLast();
+        out.runCounts.removeLast();
+    }
+}
+
+}
+
+void LodDrawList::clear()
+{
+    indices.clear();
+    runFirsts.clear();
+    runCounts.clear();
+    visibleSegments = 0;
+    culledSegments = 0;
+}
+
+CurveLod::CurveLod(const QMatrix4x4& viewProjection, const QSizeF& viewportSize, float pixelsPerInterval)
+    : m_viewProjection(viewProjection), m_viewportSize(viewportSize), m_pixelsPerInterval(pixelsPerInterval)
+{
+    // Gribb/Hartmann: the clip planes are sums and differences of the matrix rows
+    const QVector4D r0 = viewProjection.row(0);
+    const QVector4D r1 = viewProjection.row(1);
+    const QVector4D r2 = viewProjection.row(2);
+    const QVector4D r3 = viewProjection.row(3);
+    m_planes = { r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2 };
+}
+
+bool CurveLod::isVisible(const BoundingBox& box) const
+{
+    if (box.isEmpty()) return false;
+
+    for (const QVector4D& plane : m_planes) {
+        // The box corner furthest along the plane normal
+        const QVector3D corner(plane.x() >= 0.0f ? box.max.x() : box.min.x(),
+                               plane.y() >= 0.0f ? box.max.y() : box.min.y(),
+                               plane.z() >= 0.0f ? box.max.z() : box.min.z());
+        if (QVector4D::dotProduct(plane, QVector4D(corner, 1.0f)) < 0.0f) return false;
+    }
+    return true;
+}
+
+int CurveLod::intervalsFor(const BoundingBox& box) const
+{
+    const int fullDetail = CurveCalculator::CURVE_DETAIL;
+
+    float minX = std::numeric_limits<float>::max();
+    float minY = minX;
+    float maxX = -minX;
+    float maxY = -minX;
+    for (int i = 0; i < 8; ++i) {
+        const QVector3D corner((i & 1) ? box.max.x() : box.min.x(),
+                               (i & 2) ? box.max.y() : box.min.y(),
+                               (i & 4) ? box.max.z() : box.min.z());
+        const QVector4D clip = m_viewProjection * QVector4D(corner, 1.0f);
+        // Reaching behind the eye: the projected size is unbounded
+        if (clip.w() <= 0.0f) return fullDetail;
+
+        const float x = (clip.x() / clip.w() + 1.0f) * 0.5f * static_cast<float>(m_viewportSize.width());
+        const float y = (1.0f - clip.y() / clip.w()) * 0.5f * static_cast<float>(m_viewportSize.height());
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    // Width plus height bounds the projected length of a curve that does not loop inside its box
+    const float pixels = (maxX - minX) + (maxY - minY);
+    const int needed = static_cast<int>(std::ceil(pixels / m_pixelsPerInterval));
+    for (int level : intervalLevels()) {
+        if (level >= needed) return level;
+    }
+    return fullDetail;
+}
+
+void CurveLod::appendCurve(CurveType type, std::span<const BoundingBox> segmentBounds,
+                           quint32 baseVertex, qsizetype vertexCount, LodDrawList& out) const
+{
+    const qsizetype segments = static_cast<qsizetype>(segmentBounds.size());
+    if (segments == 0 || fixedVertexCount(type, segments) != vertexCount) {
+        if (vertexCount < 2) return;
+        beginRun(out);
+        for (qsizetype i = 0; i < vertexCount; ++i) {
+            out.indices.append(baseVertex + static_cast<quint32>(i));
+        }
+        endRun(out);
+        return;
+    }
+
+    bool inRun = false;
+    for (qsizetype segment = 0; segment < segments; ++segment) {
+        if (!isVisible(segmentBounds[segment])) {
+            ++out.culledSegments;
+            if (inRun) endRun(out);
+            inRun = false;
+            continue;
+        }
+        ++out.visibleSegments;
+
+        const int step = CurveCalculator::CURVE_DETAIL / intervalsFor(segmentBounds[segment]);
+        const quint32 start = baseVertex + static_cast<quint32>(segmentStart(type, segment));
+
+        // A continuing run already ends on this segment's first sample
+        int sample = 0;
+        if (inRun) {
+            sample = step;
+        } else {
+            beginRun(out);
+            inRun = true;
+        }
+        for (; sample <= CurveCalculator::CURVE_DETAIL; sample += step) {
+            out.indices.append(start + static_cast<quint32>(sample));
+        }
+    }
+    if (inRun) endRun(out);
+}
@@ -0,0 +1,57 @@
+//
+// CurveLod.h
+//
+
+#ifndef CURVES3D_CURVELOD_H
+#define CURVES3D_CURVELOD_H
+
+#include <QMatrix4x4>
+#include <QSizeF>
+#include <QVector4D>
+
+#include <array>
+
+#include "CurveBounds.h"
+
+// Index lists for GL_LINE_STRIP draws of fixed-resolution curves: one strip
+// per run of consecutive visible segments, each given by its range in indices
+struct LodDrawList
+{
+    QVector<quint32> indices;
+    QVector<int> runFirsts; // In indices, not bytes
+    QVector<int> runCounts;
+    qsizetype visibleSegments = 0;
+    qsizetype culledSegments = 0;
+
+    void clear();
+};
+
+// Picks what to draw of curves tessellated by CurveCalculator::evaluate():
+// segments whose box is outside the view frustum are skipped, and the
+// others draw every k-th of their samples, with k chosen so that the box's
+// projected size gets about one line piece per pixelsPerInterval pixels.
+// k divides CURVE_DETAIL, so segment end points are always kept and
+// neighbouring segments still meet.
+class CurveLod
+{
+public:
+    CurveLod(const QMatrix4x4& viewProjection, const QSizeF& viewportSize, float pixelsPerInterval = 4.0f);
+
+    bool isVisible(const BoundingBox& box) const;
+    // Line pieces to draw for a visible segment: a divisor of CURVE_DETAIL
+    int intervalsFor(const BoundingBox& box) const;
+
+    // Appends a curve whose vertices start at baseVertex. Curves without
+    // segment boxes, or whose vertexCount does not match the fixed layout
+    // (adaptive tessellation), are drawn whole.
+    void appendCurve(CurveType type, std::span<const BoundingBox> segmentBounds,
+                     quint32 baseVertex, qsizetype vertexCount, LodDrawList& out) const;
+
+private:
+    QMatrix4x4 m_viewProjection;
+    QSizeF m_viewportSize;
+    float m_pixelsPerInterval;
+    std::array<QVector4D, 6> m_planes; // Inside where dot(plane, (p, 1)) >= 0
+};
+
+#endif //CURVES3D_CURVELOD_H
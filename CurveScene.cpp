@@ -0,0 +1,207 @@
+//
+// CurveScene.cpp
+//
+
+#include "CurveScene.h"
+
+#include <algorithm>
+
+qsizetype CurveScene::addCurve(CurveType type, const QList<QVector3D>& controlPoints)
+{
+    CurveBatchItem curve;
+    curve.type = type;
+    curve.firstPoint = m_controlPoints.size();
+    curve.pointCount = controlPoints.size();
+
+    m_controlPoints.append(controlPoints);
+    m_curves.append(curve);
+    m_curveDirty.append(true);
+    m_needsRelayout = true;
+    return m_curves.size() - 1;
+}
+
+QList<QVector3D> CurveScene::curvePoints(qsizetype curve) const
+{
+    const CurveBatchItem& item = m_curves[curve];
+    return m_controlPoints.mid(item.firstPoint, item.pointCount);
+}
+
+void CurveScene::setCurveType(qsizetype curve, CurveType type)
+{
+    if (m_curves[curve].type == type) return;
+
+    // Another type generally means another vertex count
+    m_curves[curve].type = type;
+    m_curveDirty[curve] = true;
+    m_needsRelayout = true;
+}
+
+void CurveScene::setCurvePoints(qsizetype curve, const QList<QVector3D>& controlPoints)
+{
+    CurveBatchItem& item = m_curves[curve];
+
+    if (controlPoints.size() == item.pointCount) {
+        std::copy(controlPoints.cbegin(), controlPoints.cend(), m_controlPoints.begin() + item.firstPoint);
+        m_curveDirty[curve] = true;
+        return;
+    }
+
+    // The packed point array shifts; every later curve moves with it
+    const qsizetype delta = controlPoints.size() - item.pointCount;
+    m_controlPoints.remove(item.firstPoint, item.pointCount);
+    m_controlPoints.insert(item.firstPoint, controlPoints.size(), QVector3D());
+    std::copy(controlPoints.cbegin(), controlPoints.cend(), m_controlPoints.begin() + item.firstPoint);
+    item.pointCount = controlPoints.size();
+
+    for (qsizetype i = curve + 1; i < m_curves.size(); ++i) {
+        m_curves[i].firstPoint += delta;
+    }
+    m_curveDirty[curve] = true;
+    m_needsRelayout = true;
+}
+
+void CurveScene::removeCurve(qsizetype curve)
+{
+    const CurveBatchItem item = m_curves[curve];
+    m_controlPoints.remove(item.firstPoint, item.pointCount);
+
+    m_curves.removeAt(curve);
+    m_curveDirty.removeAt(curve);
+    for (qsizetype i = curve; i < m_curves.size(); ++i) {
+        m_curves[i].firstPoint -= item.pointCount;
+    }
+    m_needsRelayout = true;
+}
+
+void CurveScene::clear()
+{
+    m_controlPoints.clear();
+    m_curves.clear();
+    m_curveDirty.clear();
+    m_needsRelayout = true;
+}
+
+void CurveScene::setCurves(const QVector<CurveBatchItem>& curves, const QVector<QVector3D>& controlPoints)
+{
+    bool sameLayout = curves.size() == m_curves.size();
+    for (qsizetype i = 0; sameLayout && i < curves.size(); ++i) {
+        sameLayout = curves[i].type == m_curves[i].type && curves[i].pointCount == m_curves[i].pointCount;
+    }
+    if (!sameLayout) {
+        m_curves = curves;
+        m_controlPoints = controlPoints;
+        m_curveDirty.fill(true, m_curves.size());
+        m_needsRelayout = true;
+        return;
+    }
+
+    // Same packing: compare curve by curve
+    for (qsizetype i = 0; i < m_curves.size(); ++i) {
+        const auto first = controlPoints.cbegin() + m_curves[i].firstPoint;
+        const auto last = first + m_curves[i].pointCount;
+        const auto current = m_controlPoints.begin() + m_curves[i].firstPoint;
+        if (!std::equal(first, last, current)) {
+            std::copy(first, last, current);
+            m_curveDirty[i] = true;
+        }
+    }
+}
+
+void CurveScene::relayout()
+{
+    m_offsets.resize(m_curves.size() + 1);
+    const qsizetype total = CurveCalculator::batchLayout(
+        std::span<const CurveBatchItem>(m_curves.constData(), static_cast<size_t>(m_curves.size())),
+        std::span<qsizetype>(m_offsets.data(), static_cast<size_t>(m_offsets.size())));
+
+    m_layoutChanged = true;
+    m_geometry.vertices.resize(total);
+
+    m_geometry.drawFirsts.resize(m_curves.size());
+    m_geometry.drawCounts.resize(m_curves.size());
+    m_geometry.curveTypes.resize(m_curves.size());
+    for (qsizetype i = 0; i < m_curves.size(); ++i) {
+        m_geometry.drawFirsts[i] = static_cast<int>(m_offsets[i]);
+        m_geometry.drawCounts[i] = static_cast<int>(m_offsets[i + 1] - m_offsets[i]);
+        m_geometry.curveTypes[i] = m_curves[i].type;
+    }
+
+    QVector<qsizetype>& boundsOffsets = m_geometry.boundsOffsets;
+    boundsOffsets.resize(m_curves.size() + 1);
+    boundsOffsets[0] = 0;
+    for (qsizetype i = 0; i < m_curves.size(); ++i) {
+        boundsOffsets[i + 1] = boundsOffsets[i] + CurveCalculator::segmentCount(m_curves[i].type, m_curves[i].pointCount);
+    }
+    m_geometry.segmentBounds.resize(boundsOffsets.last());
+
+    // Slices moved: resolve every curve's kernel once and re-evaluate them all
+    m_evaluators.resize(m_curves.size());
+    for (qsizetype i = 0; i < m_curves.size(); ++i) {
+        m_evaluators[i] = FixedDegreeKernels::find(m_curves[i].type, m_curves[i].pointCount);
+        evaluateCurve(i);
+    }
+
+    m_curveDirty.fill(false);
+    m_dirty = { 0, m_geometry.vertices.size() };
+    m_boundsDirty = { 0, m_geometry.segmentBounds.size() };
+}
+
+void CurveScene::update()
+{
+    if (m_needsRelayout) {
+        m_needsRelayout = false;
+        relayout();
+        return;
+    }
+
+    const QVector<qsizetype>& boundsOffsets = m_geometry.boundsOffsets;
+    for (qsizetype i = 0; i < m_curves.size(); ++i) {
+        if (!m_curveDirty[i]) continue;
+
+        evaluateCurve(i);
+        m_curveDirty[i] = false;
+        m_dirty.unite({ m_offsets[i], m_offsets[i + 1] - m_offsets[i] });
+        m_boundsDirty.unite({ boundsOffsets[i], boundsOffsets[i + 1] - boundsOffsets[i] });
+    }
+}
+
+void CurveScene::evaluateCurve(qsizetype curve)
+{
+    const CurveBatchItem& item = m_curves[curve];
+    const std::span<const QVector3D> points(m_controlPoints.constData() + item.firstPoint,
+                                            static_cast<size_t>(item.pointCount));
+    const std::span<QVector3D> out(m_geometry.vertices.data() + m_offsets[curve],
+                                   static_cast<size_t>(m_offsets[curve + 1] - m_offsets[curve]));
+
+    if (m_evaluators[curve]) {
+        m_evaluators[curve](points, out);
+    } else {
+        CurveCalculator::evaluate(item.type, points, out);
+    }
+
+    const QVector<qsizetype>& boundsOffsets = m_geometry.boundsOffsets;
+    CurveBounds::compute(item.type, points,
+                         std::span<BoundingBox>(m_geometry.segmentBounds.data() + boundsOffsets[curve],
+                                                static_cast<size_t>(boundsOffsets[curve + 1] - boundsOffsets[curve])));
+}
+
+IndexRange CurveScene::takeDirtyVertices()
+{
+    const IndexRange dirty = m_dirty;
+    m_dirty = {};
+    return dirty;
+}
+
+IndexRange CurveScene::takeDirtyBounds()
+{
+    const IndexRange dirty = m_boundsDirty;
+    m_boundsDirty = {};
+    return dirty;
+}
+
+bool CurveScene::takeLayoutChanged()
+{
+    const bool changed = m_layoutChanged;
+    m_layoutChanged = false;
+    return changed;
+}
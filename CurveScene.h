@@ -0,0 +1,82 @@
+//
+// CurveScene.h
+//
+
+#ifndef CURVES3D_CURVESCENE_H
+#define CURVES3D_CURVESCENE_H
+
+#include "CurveBounds.h"
+#include "CurveCalculator.h"
+#include "FixedDegreeKernels.h"
+#include "IndexRange.h"
+
+// Tessellated scene: all curves back to back, plus GL-ready draw ranges
+struct SceneGeometry
+{
+    QVector<QVector3D> vertices;
+    QVector<int> drawFirsts;
+    QVector<int> drawCounts;
+    QVector<CurveType> curveTypes;
+    // Segment boxes of every curve, packed in curve order; curve i owns
+    // [boundsOffsets[i], boundsOffsets[i + 1])
+    QVector<BoundingBox> segmentBounds;
+    QVector<qsizetype> boundsOffsets;
+};
+
+// Many independent curves tessellated into one shared vertex array. Every
+// curve owns a contiguous slice (its range in drawFirsts()/drawCounts()),
+// so the whole scene is one buffer and one glMultiDrawArrays call no matter
+// how many curves it holds. Edits mark curves dirty; update() re-evaluates
+// only those, unless a point count changed and the slices have to move.
+class CurveScene
+{
+public:
+    qsizetype curveCount() const { return m_curves.size(); }
+    CurveType curveType(qsizetype curve) const { return m_curves[curve].type; }
+    QList<QVector3D> curvePoints(qsizetype curve) const;
+    // Every curve's slice of the packed control points
+    const QVector<CurveBatchItem>& curves() const { return m_curves; }
+    const QVector<QVector3D>& controlPoints() const { return m_controlPoints; }
+
+    // Returns the new curve's index
+    qsizetype addCurve(CurveType type, const QList<QVector3D>& controlPoints);
+    void setCurveType(qsizetype curve, CurveType type);
+    void setCurvePoints(qsizetype curve, const QList<QVector3D>& controlPoints);
+    void removeCurve(qsizetype curve);
+    void clear();
+    // Replaces every curve, as from curves() and controlPoints() of another
+    // scene; if the types and point counts match, only curves whose points
+    // differ are re-evaluated
+    void setCurves(const QVector<CurveBatchItem>& curves, const QVector<QVector3D>& controlPoints);
+
+    // Tessellates whatever changed since the last call
+    void update();
+
+    // Valid after update()
+    const SceneGeometry& geometry() const { return m_geometry; }
+
+    IndexRange takeDirtyVertices();
+    IndexRange takeDirtyBounds();
+    // True after a relayout: the draw ranges, types and bounds offsets changed
+    bool takeLayoutChanged();
+
+private:
+    void relayout();
+    void evaluateCurve(qsizetype curve);
+
+    // Control points of all curves, packed in curve order
+    QVector<QVector3D> m_controlPoints;
+    QVector<CurveBatchItem> m_curves;
+    QVector<FixedDegreeKernels::Evaluator> m_evaluators; // Resolved in relayout()
+    QVector<bool> m_curveDirty;
+    bool m_needsRelayout = false;
+
+    QVector<qsizetype> m_offsets;
+    SceneGeometry m_geometry;
+
+    IndexRange m_dirty;
+    IndexRange m_boundsDirty;
+    bool m_layoutChanged = true;
+};
+
+#endif //CURVES3D_CURVESCENE_H
@@ -3,281 +3,513 @@
 //
 
 #include "DrawingArea.h"
+#include "PointModel.h"
+#include "SurfaceModel.h"
 #include <QMouseEvent>
 #include <QOpenGLFunctions>
 #include <QOpenGLContext>
 #include <QtMath>
 #include <QColor>
+#include <QLabel>
 
 #include "CurveCalculator.h"
-#include <QMouseEvent>
-#include <QOpenGLVertexArrayObject>
+#include "AdaptiveTessellator.h"
 #include <QScreen>
-#include <QVector4D>
-
-// --- Shaders ---
-const char *vertexShaderSource =
-    "attribute vec3 position;\n"
-    "uniform mat4 matrix;\n"
-    "void main() {\n"
-    "    gl_Position = matrix * vec4(position, 1.0);\n"
-    "}\n";
-
-const char *fragmentShaderSource =
-    "uniform vec4 color;\n"
-    "void main() {\n"
-    "    gl_FragColor = color;\n"
-    "}\n";
 
 // --- Class Implementation ---
 
 DrawingArea::DrawingArea(QWidget *parent)
-    : QOpenGLWidget(parent), m_currentCurveType("Bézier Curve (De Casteljau)")
+    : QOpenGLWidget(parent)
 {
     setMouseTracking(true);
+
+    m_profilerOverlay = new QLabel(this);
+    m_profilerOverlay->setStyleSheet("QLabel { background: rgba(0, 0, 0, 160); color: white;"
+                                     " font-family: monospace; padding: 4px; }");
+    m_profilerOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_profilerOverlay->move(8, 8);
+    m_profilerOverlay->hide();
+    m_renderer.setProfiler(&m_profiler);
+
+    connect(&m_curveWorker, &CurveEvaluationWorker::resultReady, this, &DrawingArea::applyCurveResult);
+    connect(&m_sceneWorker, &SceneEvaluationWorker::resultReady, this, &DrawingArea::applySceneResult);
+    connect(&m_surfaceWorker, &SurfaceTessellationWorker::resultReady, this, &DrawingArea::applySurfaceResult);
 }
 
-void DrawingArea::setCurrentCurveType(const QString &type)
+DrawingArea::~DrawingArea()
 {
-    if (m_currentCurveType != type) {
-        m_currentCurveType = type;
-        calculateAndStoreCurve();
-        update();
-    }
+    // GL objects must be released with their context current
+    makeCurrent();
+    m_renderer.destroy();
+    doneCurrent();
 }
 
-void DrawingArea::updateCurve(const QList<QVector3D>& points)
+void DrawingArea::setCurveType(CurveType type)
 {
-    m_controlPoints = points;
-    calculateAndStoreCurve();
-    update();
+    if (m_curveType != type) {
+        m_curveType = type;
+        requestCurve();
+    }
 }
 
-void DrawingArea::calculateAndStoreCurve()
+void DrawingArea::setBSplineDegree(int degree)
 {
-    m_calculatedCurvePoints.clear();
-    const QList<QVector3D>& points = m_controlPoints;
-
-    if (points.isEmpty()) return;
-
-    if (m_currentCurveType == "Bézier Curve (De Casteljau)") {
-        m_calculatedCurvePoints = CurveCalculator::calculateBezier_DeCasteljau(points);
+    if (m_bsplineDegree != degree) {
+        m_bsplineDegree = degree;
+        requestCurve();
     }
-    else if (m_currentCurveType == "B-Spline Curve") {
-        m_calculatedCurvePoints = CurveCalculator::calculateBSpline(points, 3);
+}
+
+void DrawingArea::setPointModel(PointModel *model)
+{
+    if (m_pointModel) disconnect(m_pointModel, nullptr, this, nullptr);
+    m_pointModel = model;
+    if (m_pointModel) {
+        connect(m_pointModel, &PointModel::pointsMoved, this, &DrawingArea::onPointsMoved);
+        connect(m_pointModel, &PointModel::pointsInserted, this, [this](int first, int count) {
+            shiftPointIndices(first, count);
+            onPointsInsertedOrRemoved(first);
+        });
+        connect(m_pointModel, &PointModel::pointsRemoved, this, [this](int first, int count) {
+            shiftPointIndices(first, -count);
+            onPointsInsertedOrRemoved(first);
+        });
+        connect(m_pointModel, &PointModel::pointsReset, this, &DrawingArea::onPointsReset);
     }
-    else if (m_currentCurveType == "Hermite Curve (Matricielle)") {
-        if (points.size() < 2) {
-            m_calculatedCurvePoints = points.toVector();
-            return;
-        }
+    onPointsReset();
+}
 
-        // Apply endpoint padding for Catmull-Rom to start/end at P0/PN
-        QList<QVector3D> tempPoints = points;
-        tempPoints.prepend(points.first());
-        tempPoints.append(points.last());
+void DrawingArea::setSurfaceModel(SurfaceModel *model)
+{
+    if (m_surfaceModel) disconnect(m_surfaceModel, nullptr, this, nullptr);
+    m_surfaceModel = model;
+    if (m_surfaceModel) {
+        connect(m_surfaceModel, &SurfaceModel::gridMoved, this, &DrawingArea::onGridMoved);
+        connect(m_surfaceModel, &SurfaceModel::gridsReset, this, &DrawingArea::onGridsReset);
+    }
+    onGridsReset();
+}
 
-        if (tempPoints.size() < 4) {
-             m_calculatedCurvePoints = points.toVector();
-             return;
-        }
+void DrawingArea::onGridMoved(int index)
+{
+    if (!m_movedGrids.contains(index)) m_movedGrids.append(index);
+    m_surfaceJobPending = true;
+    update();
+}
 
-        for (int i = 1; i < tempPoints.size() - 2; ++i) {
-            QVector<QVector3D> segment = CurveCalculator::calculateCatmullRomSegment(
-                tempPoints[i-1], tempPoints[i], tempPoints[i+1], tempPoints[i+2]
-            );
+void DrawingArea::onGridsReset()
+{
+    m_surfacesReset = true;
+    m_movedGrids.clear();
+    m_surfaceJobPending = true;
+    update();
+}
 
-            if (!m_calculatedCurvePoints.isEmpty() && i != 1) {
-                segment.removeFirst();
-            }
-            m_calculatedCurvePoints.append(segment);
+void DrawingArea::submitSurfaceJob()
+{
+    // The worker gets its own copies of the grids that changed
+    static const QList<ControlGrid> noGrids;
+    const QList<ControlGrid> &grids = m_surfaceModel ? m_surfaceModel->grids() : noGrids;
+
+    SurfaceJob job;
+    job.reset = m_surfacesReset;
+    if (m_surfacesReset) {
+        job.grids.reserve(grids.size());
+        for (const ControlGrid &grid : grids) {
+            job.grids.append(SurfaceJob::detachedCopy(grid));
+        }
+    } else {
+        job.gridIndices = m_movedGrids;
+        job.grids.reserve(m_movedGrids.size());
+        for (int index : m_movedGrids) {
+            job.grids.append(SurfaceJob::detachedCopy(grids[index]));
         }
     }
-    // VBOs must be updated after calculation
-    setupVBOs();
-}
+    m_surfacesReset = false;
+    m_movedGrids.clear();
 
-// --- Shader and VBO Management ---
+    m_surfaceWorker.submit(std::move(job));
+    m_surfaceJobPending = false;
+}
 
-void DrawingArea::initializeShaders()
+void DrawingArea::applySurfaceResult(const SurfaceResult &result)
 {
-    if (!m_program.addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource)) close();
-    if (!m_program.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource)) close();
-    if (!m_program.link()) close();
+    // Uploaded with the other buffers in paintGL()
+    result.applyTo(m_surfaceMesh);
+    m_surfaceDirty.unite(result.dirty);
+    m_surfaceLayoutChanged = m_surfaceLayoutChanged || result.layoutChanged;
+    m_profiler.addEvent("Tessellate surfaces", ProfileEvent::Worker, result.evaluationStartNs, result.evaluationNs);
+    update();
+}
 
-    m_posAttr = m_program.attributeLocation("position");
-    m_matrixUniform = m_program.uniformLocation("matrix");
-    m_colorUniform = m_program.uniformLocation("color");
+const QList<QVector3D>& DrawingArea::controlPoints() const
+{
+    static const QList<QVector3D> noPoints;
+    return m_pointModel ? m_pointModel->controlPoints() : noPoints;
 }
 
-void DrawingArea::setupVBOs()
+// Model notifications only record what changed; the work happens once per frame
+void DrawingArea::onPointsMoved(int first, int count)
 {
-    // Set up Curve VBO
-    if (m_curveVbo.isCreated()) m_curveVbo.destroy();
-    if (m_calculatedCurvePoints.size() > 1) {
-        m_curveVbo.create();
-        m_curveVbo.bind();
-        m_curveVbo.allocate(m_calculatedCurvePoints.constData(), m_calculatedCurvePoints.size() * sizeof(QVector3D));
-        m_curveVbo.release();
+    for (int i = first; i < first + count; ++i) {
+        m_picker.pointMoved(i);
     }
+    m_pointsDirty.unite({ first, count });
+    m_curvePointsMoved.unite({ first, count });
+    requestCurve();
+}
 
-    // Set up Points VBO (for control points)
-    if (m_pointsVbo.isCreated()) m_pointsVbo.destroy();
-    if (!m_controlPoints.isEmpty()) {
-        m_pointsVbo.create();
-        m_pointsVbo.bind();
-        QVector<QVector3D> pointVector = m_controlPoints.toVector();
-        m_pointsVbo.allocate(pointVector.constData(), pointVector.size() * sizeof(QVector3D));
-        m_pointsVbo.release();
-    }
+void DrawingArea::onPointsInsertedOrRemoved(int first)
+{
+    // Points before the edit keep their place in the buffer; the rest shift
+    m_picker.setPoints(controlPoints());
+    m_pointsDirty.unite({ first, controlPoints().size() - first });
+    m_curvePointsReset = true;
+    requestCurve();
 }
 
-// --- OpenGL Overrides ---
+// Keeps hover, highlight and drag on the same points when delta points were
+// inserted (delta > 0) or removed (delta < 0) at first; removed points lose them
+void DrawingArea::shiftPointIndices(int first, int delta)
+{
+    for (int *index : { &m_hoveredPointIndex, &m_highlightedPointIndex, &m_draggingPointIndex }) {
+        if (*index < first) continue;
+        *index = (delta < 0 && *index < first - delta) ? -1 : *index + delta;
+    }
+}
 
-void DrawingArea::initializeGL()
+void DrawingArea::onPointsReset()
 {
-    initializeOpenGLFunctions();
-    initializeShaders();
+    // No point is known to survive a reset
+    m_hoveredPointIndex = -1;
+    m_highlightedPointIndex = -1;
+    m_draggingPointIndex = -1;
+    m_picker.setPoints(controlPoints());
+    m_pointsLayoutChanged = true;
+    m_curvePointsReset = true;
+    requestCurve();
+}
 
-    //glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
-    glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_PROGRAM_POINT_SIZE);
+void DrawingArea::sceneChanged()
+{
+    // paintGL() sends the worker one snapshot however often this is called
+    m_sceneJobPending = true;
+    update();
 }
 
-void DrawingArea::resizeGL(int w, int h)
+void DrawingArea::applySceneResult(const SceneResult &result)
 {
-    glViewport(0, 0, w, h);
-    m_projection.setToIdentity();
-    m_projection.perspective(45.0f, (float)w / (float)h, 0.1f, 1000.0f);
+    // Uploaded with the other buffers in paintGL()
+    result.applyTo(m_sceneGeometry);
+    m_sceneDirty.unite(result.dirty);
+    m_sceneBoundsDirty.unite(result.dirtyBounds);
+    m_sceneLayoutChanged = m_sceneLayoutChanged || result.layoutChanged;
+    m_profiler.addEvent("Tessellate scene", ProfileEvent::Worker, result.evaluationStartNs, result.evaluationNs);
+    update();
 }
 
-void DrawingArea::drawAxes()
+void DrawingArea::setHighlightedPoint(int index)
 {
-    QVector<QVector3D> axesData = {
-        QVector3D(0.0f, 0.0f, 0.0f), QVector3D(30.0f, 0.0f, 0.0f), // X (Red)
-        QVector3D(0.0f, 0.0f, 0.0f), QVector3D(0.0f, 30.0f, 0.0f), // Y (Green)
-        QVector3D(0.0f, 0.0f, 0.0f), QVector3D(0.0f, 0.0f, 30.0f)  // Z (Blue)
-    };
+    if (m_highlightedPointIndex != index) {
+        const int previous = m_highlightedPointIndex;
+        m_highlightedPointIndex = index;
+        refreshPointState(previous);
+        refreshPointState(index);
+        update();
+    }
+}
 
-    QOpenGLBuffer axesVbo(QOpenGLBuffer::VertexBuffer);
-    axesVbo.create();
-    axesVbo.bind();
-    axesVbo.allocate(axesData.constData(), axesData.size() * sizeof(QVector3D));
+void DrawingArea::setProceduralGrid(bool enabled)
+{
+    if (m_proceduralGrid != enabled) {
+        m_proceduralGrid = enabled;
+        update();
+    }
+}
 
-    m_program.bind();
-    QMatrix4x4 combined = m_projection * m_view;
-    m_program.setUniformValue(m_matrixUniform, combined);
+void DrawingArea::setLevelOfDetail(bool enabled)
+{
+    m_renderer.setLevelOfDetail(enabled);
+    update();
+}
 
-    m_program.enableAttributeArray(m_posAttr);
-    m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+void DrawingArea::setGpuEvaluation(bool enabled)
+{
+    if (m_gpuEvaluation != enabled) {
+        // Back on the CPU path the worker catches up with every edit made meanwhile
+        m_gpuEvaluation = enabled;
+        requestCurve();
+    }
+}
 
-    glLineWidth(2.0f);
+void DrawingArea::setProfilerEnabled(bool enabled)
+{
+    if (m_profiler.isEnabled() == enabled) return;
 
-    // X-Axis (Red)
-    m_program.setUniformValue(m_colorUniform, QVector4D(1.0f, 0.0f, 0.0f, 1.0f));
-    glDrawArrays(GL_LINES, 0, 2);
+    m_profiler.setEnabled(enabled);
+    m_profilerOverlay->setVisible(enabled);
+    m_overlayTimer.invalidate();
+    update();
+}
 
-    // Y-Axis (Green)
-    m_program.setUniformValue(m_colorUniform, QVector4D(0.0f, 1.0f, 0.0f, 1.0f));
-    glDrawArrays(GL_LINES, 2, 2);
+bool DrawingArea::exportProfilerTrace(const QString &path, QString *errorString) const
+{
+    return m_profiler.writeChromeTrace(path, errorString);
+}
 
-    // Z-Axis (Blue)
-    m_program.setUniformValue(m_colorUniform, QVector4D(0.0f, 0.0f, 1.0f, 1.0f));
-    glDrawArrays(GL_LINES, 4, 2);
+void DrawingArea::setAdaptiveTessellation(bool enabled)
+{
+    if (m_adaptiveTessellation != enabled) {
+        // Error-bounded: flat stretches get few vertices, bends get many
+        m_adaptiveTessellation = enabled;
+        requestCurve();
+    }
+}
 
-    m_program.disableAttributeArray(m_posAttr);
-    axesVbo.release();
-    axesVbo.destroy();
-    m_program.release();
+void DrawingArea::setTessellationTolerance(double pixels)
+{
+    if (m_tessellationTolerance != static_cast<float>(pixels)) {
+        m_tessellationTolerance = static_cast<float>(pixels);
+        if (m_adaptiveTessellation) requestCurve();
+    }
 }
 
-void DrawingArea::drawCurve()
+void DrawingArea::requestCurve()
 {
-    if (m_curveVbo.isCreated() && m_calculatedCurvePoints.size() > 1) {
+    // However many edits arrive before the next frame, paintGL() submits one job
+    m_curveJobPending = true;
+    update();
+}
 
-        m_program.bind();
-        QMatrix4x4 combined = m_projection * m_view;
-        m_program.setUniformValue(m_matrixUniform, combined);
+void DrawingArea::submitCurveJob()
+{
+    // Tessellation runs on the worker; the GUI thread only hands over the current state
+    CurveJob job;
+    job.type = m_curveType;
+    job.degree = m_bsplineDegree;
+    job.adaptive = m_adaptiveTessellation;
+    if (m_adaptiveTessellation) {
+        // Flatness in pixels: zoomed-out curves get few vertices, close-ups many
+        job.options.space = TessellationOptions::Space::Screen;
+        job.options.tolerance = m_tessellationTolerance;
+        job.options.viewProjection = m_projection * m_view;
+        job.options.viewportSize = size();
+        m_adaptiveViewProjection = job.options.viewProjection;
+    }
 
-        // Draw Control Polygon (Gray Line)
-        m_pointsVbo.bind();
-        m_program.enableAttributeArray(m_posAttr);
-        m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+    // Moved points are copied out one by one; a structural change, or moves
+    // touching much of the curve, send a snapshot the worker owns
+    const QList<QVector3D>& points = controlPoints();
+    if (m_curvePointsReset || m_curvePointsMoved.count > points.size() / 4) {
+        job.resetPoints = true;
+        job.controlPoints = QList<QVector3D>(points.cbegin(), points.cend());
+    } else {
+        job.movedIndices.reserve(m_curvePointsMoved.count);
+        job.movedPositions.reserve(m_curvePointsMoved.count);
+        for (qsizetype i = m_curvePointsMoved.first; i < m_curvePointsMoved.end(); ++i) {
+            job.movedIndices.append(i);
+            job.movedPositions.append(points[i]);
+        }
+    }
+    m_curvePointsReset = false;
+    m_curvePointsMoved = {};
 
-        m_program.setUniformValue(m_colorUniform, QVector4D(0.6f, 0.6f, 0.6f, 1.0f));
-        glLineWidth(1.0f);
-        glDrawArrays(GL_LINE_STRIP, 0, m_controlPoints.size());
-        m_pointsVbo.release();
+    m_curveGeneration = m_curveWorker.submit(std::move(job));
+    m_curveJobPending = false;
+}
 
-        // Draw Calculated Curve (Blue Line)
-        m_curveVbo.bind();
-        m_program.enableAttributeArray(m_posAttr);
-        m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+void DrawingArea::applyCurveResult(const CurveResult &result)
+{
+    // Ranges accumulate until paintGL(), where the context is current to upload them
+    result.applyTo(m_curveVertices, m_curveBounds);
+    m_curveVerticesType = result.type;
+    m_curveDirty.unite(result.dirty);
+    m_curveBoundsDirty.unite(result.dirtyBounds);
+    m_curveLayoutChanged = m_curveLayoutChanged || result.layoutChanged;
+    m_profiler.addEvent("Evaluate curve", ProfileEvent::Worker, result.evaluationStartNs, result.evaluationNs);
+
+    // Intermediate results are drawn, but only the latest edit's count is reported
+    if (result.generation == m_curveGeneration) {
+        emit curveTessellated(m_curveVertices.size());
+        emit curveLengthChanged(result.length);
+    }
+    update();
+}
 
-        m_program.setUniformValue(m_colorUniform, QVector4D(0.0f, 0.0f, 1.0f, 1.0f));
-        glLineWidth(3.0f);
-        glDrawArrays(GL_LINE_STRIP, 0, m_calculatedCurvePoints.size());
+// --- Shader and VBO Management ---
 
-        m_program.disableAttributeArray(m_posAttr);
-        m_curveVbo.release();
-        m_program.release();
+void DrawingArea::setupVBOs()
+{
+    // Only what changed since the last frame is uploaded; static frames send nothing
+    m_renderer.updateCurve(m_curveVerticesType, m_curveVertices, m_curveDirty,
+                           m_curveBounds, m_curveBoundsDirty, m_curveLayoutChanged);
+    m_curveDirty = {};
+    m_curveBoundsDirty = {};
+    m_curveLayoutChanged = false;
+
+    m_renderer.updatePoints(controlPoints(), m_pointsDirty, m_pointsLayoutChanged);
+    m_pointsDirty = {};
+
+    // Point states follow the point layout; hover/drag changes touch single entries
+    bool statesLayoutChanged = m_pointsLayoutChanged;
+    if (m_pointsLayoutChanged || m_pointStates.size() != controlPoints().size()) {
+        m_pointStates.resize(controlPoints().size());
+        for (int i = 0; i < m_pointStates.size(); ++i) {
+            m_pointStates[i] = pointState(i);
+        }
+        statesLayoutChanged = true;
+    }
+    m_renderer.updatePointStates(m_pointStates, m_pointStatesDirty, statesLayoutChanged);
+    m_pointStatesDirty = {};
+    m_pointsLayoutChanged = false;
+
+    // Scene curves: only curves the worker re-tessellated are uploaded
+    if (m_sceneLayoutChanged || !m_sceneDirty.isEmpty() || !m_sceneBoundsDirty.isEmpty()) {
+        m_renderer.updateScene(m_sceneGeometry, m_sceneDirty, m_sceneBoundsDirty, m_sceneLayoutChanged);
+        m_sceneDirty = {};
+        m_sceneBoundsDirty = {};
+        m_sceneLayoutChanged = false;
     }
+
+    updateSurfaces();
 }
 
-void DrawingArea::drawPoints()
+void DrawingArea::updateSurfaces()
 {
-    if (m_pointsVbo.isCreated() && !m_controlPoints.isEmpty()) {
-        m_program.bind();
-        QMatrix4x4 combined = m_projection * m_view;
-        m_program.setUniformValue(m_matrixUniform, combined);
+    if (!m_surfaceLayoutChanged && m_surfaceDirty.isEmpty()) return;
 
-        m_pointsVbo.bind();
-        m_program.enableAttributeArray(m_posAttr);
-        m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+    m_renderer.updateSurfaces(m_surfaceMesh, m_surfaceDirty, m_surfaceLayoutChanged);
+    m_surfaceDirty = {};
+    m_surfaceLayoutChanged = false;
+}
 
-        // --- Ensure Point Size is Set for Visibility ---
-        glPointSize(10.0f); // <-- This sets the size of the dots
+DrawingArea::PointState DrawingArea::pointState(int index) const
+{
+    if (index == m_draggingPointIndex) return SceneRenderer::PointDragged;
+    if (index == m_highlightedPointIndex) return SceneRenderer::PointHighlighted;
+    if (index == m_hoveredPointIndex) return SceneRenderer::PointHovered;
+    return SceneRenderer::PointNormal;
+}
 
-        // Draw each point individually to set color based on dragging state
-        for (int i = 0; i < m_controlPoints.size(); ++i) {
-            if (i == m_draggingPointIndex) {
-                // Orange for the currently dragged point
-                m_program.setUniformValue(m_colorUniform, QVector4D(1.0f, 0.5f, 0.0f, 1.0f));
-            } else {
-                // Red for all other control points
-                m_program.setUniformValue(m_colorUniform, QVector4D(1.0f, 0.0f, 0.0f, 1.0f));
-            }
-            glDrawArrays(GL_POINTS, i, 1);
-        }
+void DrawingArea::refreshPointState(int index)
+{
+    if (index < 0 || index >= m_pointStates.size()) return;
 
-        m_program.disableAttributeArray(m_posAttr);
-        m_pointsVbo.release();
-        m_program.release();
+    const quint8 state = pointState(index);
+    if (m_pointStates[index] != state) {
+        m_pointStates[index] = state;
+        m_pointStatesDirty.unite({ index, 1 });
     }
 }
 
+int DrawingArea::pickPoint(const QPointF &pos)
+{
+    // Nearest point under the cursor by depth; the grid only rebuilds after the camera moved
+    m_picker.setCamera(m_projection * m_view, size());
+    const qreal HIT_RADIUS = 10.0;
+    return static_cast<int>(m_picker.pick(pos, HIT_RADIUS));
+}
+
+// --- OpenGL Overrides ---
+
+void DrawingArea::initializeGL()
+{
+    initializeOpenGLFunctions();
+    if (!m_renderer.initialize(context())) close();
+}
+
+void DrawingArea::resizeGL(int w, int h)
+{
+    m_renderer.setViewport(QSize(w, h));
+    m_projection = m_camera.projectionMatrix(QSize(w, h));
+}
+
 void DrawingArea::paintGL()
 {
+    m_profiler.beginFrame();
+
     // 1. Update Camera
-    m_view.setToIdentity();
-    m_view.translate(0.0, 0.0, m_zoomDistance);
-    m_view.rotate(m_rotationX, 1, 0, 0);
-    m_view.rotate(m_rotationY, 0, 1, 0);
+    m_view = m_camera.viewMatrix();
+    if (m_adaptiveTessellation && m_projection * m_view != m_adaptiveViewProjection) {
+        // Screen-space tolerance: the adaptive curve follows the camera
+        m_curveJobPending = true;
+    }
 
-    // 2. Clear Scene
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_DEPTH_TEST);
+    // 2. Edits since the last frame become one job per worker and one upload pass
+    // On the GPU path the shader evaluates the uploaded points and no job is needed
+    const qsizetype pointCount = controlPoints().size();
+    const bool gpuCurve = m_gpuEvaluation && m_renderer.supportsGpuCurve(m_curveType, pointCount, m_bsplineDegree);
+    m_renderer.setGpuCurve(gpuCurve, m_curveType);
+    if (m_curveJobPending && gpuCurve) {
+        // The worker misses these edits; its next job starts from a snapshot
+        m_curveJobPending = false;
+        m_curvePointsReset = true;
+        m_curvePointsMoved = {};
+        emit curveTessellated(CurveCalculator::segmentCount(m_curveType, pointCount, m_bsplineDegree)
+                              * CurveCalculator::SEGMENT_SAMPLES);
+        emit curveLengthChanged(-1.0);
+    } else if (m_curveJobPending) {
+        ProfileScope scope(&m_profiler, "Submit curve job");
+        submitCurveJob();
+    }
+    if (m_sceneJobPending) {
+        ProfileScope scope(&m_profiler, "Submit scene job");
+        m_sceneWorker.submit(SceneJob::snapshot(m_scene));
+        m_sceneJobPending = false;
+    }
+    if (m_surfaceJobPending) {
+        ProfileScope scope(&m_profiler, "Submit surface job");
+        submitSurfaceJob();
+    }
+    {
+        ProfileScope scope(&m_profiler, "Upload buffers");
+        setupVBOs();
+    }
 
-    setupVBOs();
+    // 3. Clear and draw grid, axes, surfaces, scene, curve and points
+    m_renderer.render(m_projection, m_view, m_proceduralGrid);
 
-    // 3. Draw Grid (Floor) <-- NEW CALL
-    drawGrid();
+    recordFrameCounters();
+    m_profiler.endFrame();
+    updateProfilerOverlay();
+}
+
+void DrawingArea::recordFrameCounters()
+{
+    const qint64 bytesUploaded = m_renderer.totalBytesUploaded();
+    m_profiler.setCounter("Draw calls", m_renderer.lastStats().drawCalls);
+    m_profiler.setCounter("Vertices", m_renderer.lastStats().vertices);
+    m_profiler.setCounter("Culled segments", m_renderer.lastStats().culledSegments);
+    m_profiler.setCounter("Surface triangles", m_surfaceMesh.triangleCount());
+    m_profiler.setCounter("Bytes uploaded", bytesUploaded - m_bytesUploadedBefore);
+    m_bytesUploadedBefore = bytesUploaded;
+}
+
+void DrawingArea::updateProfilerOverlay()
+{
+    const qint64 OVERLAY_INTERVAL_MS = 250;
+    const quint64 OVERLAY_FRAMES = 60;
+    if (!m_profiler.isEnabled()) return;
+    if (m_overlayTimer.isValid() && m_overlayTimer.elapsed() < OVERLAY_INTERVAL_MS) return;
+    m_overlayTimer.start();
+
+    static const char *const TRACK_LABELS[] = { "cpu", "worker", "gpu" };
+    QStringList lines;
+    lines << QString("Frame %1 ms (last %2 frames)")
+                 .arg(m_profiler.averageFrameMs(OVERLAY_FRAMES), 0, 'f', 2).arg(OVERLAY_FRAMES);
+    for (const ProfileStageSummary &stage : m_profiler.summary(OVERLAY_FRAMES)) {
+        lines << QString("%1 %2 %3 ms  max %4")
+                     .arg(QString::fromLatin1(stage.name), -18)
+                     .arg(QString::fromLatin1(TRACK_LABELS[stage.track]), -6)
+                     .arg(stage.averageMs, 7, 'f', 3)
+                     .arg(stage.maxMs, 7, 'f', 3);
+    }
+    for (const ProfileCounter &counter : m_profiler.lastCounters()) {
+        lines << QString("%1 %2").arg(QString::fromLatin1(counter.name), -18).arg(counter.value);
+    }
 
-    // 4. Draw Elements
-    drawAxes();
-    drawCurve();
-    drawPoints();
+    m_profilerOverlay->setText(lines.join('\n'));
+    m_profilerOverlay->adjustSize();
 }
 
 // --- Mouse Events for Camera Control and Dragging ---
@@ -287,29 +519,11 @@ void DrawingArea::mousePressEvent(QMouseEvent *event)
     m_lastMousePos = event->pos();
 
     if (event->button() == Qt::LeftButton) {
-        // Simplified 3D Point Selection (2D hit test on projected 3D points)
-        QMatrix4x4 combined = m_projection * m_view;
-
-        for (int i = 0; i < m_controlPoints.size(); ++i) {
-            QVector4D p4D(m_controlPoints[i], 1.0f);
-            QVector4D projected = combined * p4D;
-
-            if (projected.w() <= 0) continue; // Skip points behind the camera
-
-            QPointF projected2D(projected.x() / projected.w(), projected.y() / projected.w());
-
-            QPointF pixelPos( (projected2D.x() + 1.0) * width() / 2.0,
-                              (1.0 - projected2D.y()) * height() / 2.0);
-
-            QPointF diff = pixelPos - event->pos();
-            qreal distance = qSqrt(diff.x() * diff.x() + diff.y() * diff.y());
-
-            const qreal HIT_RADIUS = 10.0;
-            if (distance <= HIT_RADIUS) {
-                m_draggingPointIndex = i;
-                update();
-                return;
-            }
+        const int hit = pickPoint(event->position());
+        if (hit != -1) {
+            m_draggingPointIndex = hit;
+            refreshPointState(hit);
+            update();
         }
     }
 }
@@ -323,22 +537,18 @@ void DrawingArea::mouseMoveEvent(QMouseEvent *event)
         // Simplified 3D Dragging: Move on XY Plane relative to camera view
         const qreal DRAG_SENSITIVITY = 0.5;
 
-        QVector3D currentPoint = m_controlPoints[m_draggingPointIndex];
+        QVector3D currentPoint = m_pointModel->point(m_draggingPointIndex);
         currentPoint.setX(currentPoint.x() + dx * DRAG_SENSITIVITY);
         currentPoint.setY(currentPoint.y() - dy * DRAG_SENSITIVITY);
 
-        m_controlPoints[m_draggingPointIndex] = currentPoint;
-
-        // Re-calculate and redraw
-        setupVBOs();
-        calculateAndStoreCurve();
-        update();
-        emit controlPointsMoved(m_controlPoints);
+        // The model is the only copy; its pointsMoved marks the point and the
+        // curve for the next frame, so fast mouse events add no extra work
+        m_pointModel->setPoint(m_draggingPointIndex, currentPoint);
     }
     else if (event->buttons() & Qt::RightButton) {
         // Camera Rotation (Orbit)
-        m_rotationX += dy * 0.5;
-        m_rotationY += dx * 0.5;
+        m_camera.rotationX += dy * 0.5;
+        m_camera.rotationY += dx * 0.5;
         update();
     }
     else if (event->buttons() & Qt::MiddleButton) { // <-- NEW: Panning (Translate)
@@ -349,15 +559,27 @@ void DrawingArea::mouseMoveEvent(QMouseEvent *event)
         m_view.translate(dx * PAN_SENSITIVITY, -dy * PAN_SENSITIVITY, 0.0);
         update();
     }
+    else {
+        // Hover feedback only rewrites the state of the two points involved
+        const int hovered = pickPoint(event->position());
+        if (hovered != m_hoveredPointIndex) {
+            const int previous = m_hoveredPointIndex;
+            m_hoveredPointIndex = hovered;
+            refreshPointState(previous);
+            refreshPointState(hovered);
+            update();
+        }
+    }
     m_lastMousePos = event->pos();
 }
 
 void DrawingArea::mouseReleaseEvent(QMouseEvent *event)
 {
     if (m_draggingPointIndex != -1) {
+        const int released = m_draggingPointIndex;
         m_draggingPointIndex = -1;
+        refreshPointState(released);
         update();
-        emit controlPointsMoved(m_controlPoints);
     }
     QWidget::mouseReleaseEvent(event);
 }
@@ -370,64 +592,15 @@ void DrawingArea::wheelEvent(QWheelEvent *event)
 
     const qreal ZOOM_INCREMENT = 20.0;
 
-    // Decrease m_zoomDistance (make it more negative) to zoom out.
-    // Increase m_zoomDistance (make it less negative/closer to zero) to zoom in.
-    m_zoomDistance += numSteps * ZOOM_INCREMENT;
+    // Decrease zoomDistance (make it more negative) to zoom out.
+    // Increase zoomDistance (make it less negative/closer to zero) to zoom in.
+    m_camera.zoomDistance += numSteps * ZOOM_INCREMENT;
 
     // Optional: Clamp the zoom distance to prevent going too far in or out
-    if (m_zoomDistance > -50.0) m_zoomDistance = -50.0;
-    if (m_zoomDistance < -1000.0) m_zoomDistance = -1000.0;
+    if (m_camera.zoomDistance > -50.0) m_camera.zoomDistance = -50.0;
+    if (m_camera.zoomDistance < -1000.0) m_camera.zoomDistance = -1000.0;
 
     update(); // Request a redraw with the new distance
     event->accept();
 }
 
-void DrawingArea::drawGrid()
-{
-    QVector<QVector3D> gridData;
-    const int GRID_SIZE = 100; // Total extent in one direction (e.g., -100 to +100)
-    const int GRID_SPACING = 20; // Distance between lines (e.g., one tile size)
-    const float HALF_SIZE = (float)GRID_SIZE / 2.0f;
-
-    // Generate lines parallel to the Z-axis (varying X)
-    for (int i = -GRID_SIZE / 2; i <= GRID_SIZE / 2; ++i) {
-        float x = (float)i * GRID_SPACING;
-        gridData.append(QVector3D(x, 0.0f, -HALF_SIZE * GRID_SPACING));
-        gridData.append(QVector3D(x, 0.0f, HALF_SIZE * GRID_SPACING));
-    }
-
-    // Generate lines parallel to the X-axis (varying Z)
-    for (int i = -GRID_SIZE / 2; i <= GRID_SIZE / 2; ++i) {
-        float z = (float)i * GRID_SPACING;
-        gridData.append(QVector3D(-HALF_SIZE * GRID_SPACING, 0.0f, z));
-        gridData.append(QVector3D(HALF_SIZE * GRID_SPACING, 0.0f, z));
-    }
-
-    // --- Draw using the Shader Program ---
-
-    QOpenGLBuffer gridVbo(QOpenGLBuffer::VertexBuffer);
-    gridVbo.create();
-    gridVbo.bind();
-    gridVbo.allocate(gridData.constData(), gridData.size() * sizeof(QVector3D));
-
-    m_program.bind();
-    QMatrix4x4 combined = m_projection * m_view;
-    m_program.setUniformValue(m_matrixUniform, combined);
-
-    m_program.enableAttributeArray(m_posAttr);
-    m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
-
-    glLineWidth(1.0f);
-
-    // Set grid color (Darker gray/cyan for visibility against axes)
-    m_program.setUniformValue(m_colorUniform, QVector4D(0.3f, 0.3f, 0.4f, 1.0f));
-
-    // Draw all generated lines
-    glDrawArrays(GL_LINES, 0, gridData.size());
-
-    m_program.disableAttributeArray(m_posAttr);
-    gridVbo.release();
-    gridVbo.destroy();
-    m_program.release();
-}
-
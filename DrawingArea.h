@@ -7,26 +7,70 @@
 
 #include <QOpenGLWidget>
 #include <QOpenGLFunctions>
-#include <QOpenGLShaderProgram>
-#include <QOpenGLBuffer>
 #include <QVector3D>
 #include <QVector>
 #include <QMatrix4x4>
 #include <QString>
+#include <QElapsedTimer>
+
+#include "CurveCache.h"
+#include "CurveEvaluationWorker.h"
+#include "CurveScene.h"
+#include "PointPicker.h"
+#include "SceneEvaluationWorker.h"
+#include "SceneRenderer.h"
+#include "SurfaceTessellationWorker.h"
+
+class PointModel;
+class SurfaceModel;
+class QLabel;
 
 class DrawingArea : public QOpenGLWidget, protected QOpenGLFunctions
 {
     Q_OBJECT
 
 public:
+    using PointState = SceneRenderer::PointState;
+
     explicit DrawingArea(QWidget *parent = nullptr);
+    ~DrawingArea() override;
+
+    // The model is the only copy of the control points: drags write to it, and
+    // its change notifications are collected into one recompute and upload per frame
+    void setPointModel(PointModel *model);
+
+    // Surfaces drawn with the curves; grids that moved are re-tessellated in place by a worker
+    void setSurfaceModel(SurfaceModel *model);
+
+    // Independent curves drawn alongside the edited one; call sceneChanged()
+    // after editing. This copy only holds the curves: they are tessellated by a worker.
+    CurveScene &scene() { return m_scene; }
+
+    // Stage timings and counters of recent frames, recorded while the profiler is enabled
+    const FrameProfiler &profiler() const { return m_profiler; }
+    bool exportProfilerTrace(const QString &path, QString *errorString = nullptr) const;
 
 public slots:
-    void setCurrentCurveType(const QString &type);
-    void updateCurve(const QList<QVector3D>& points);
+    void setCurveType(CurveType type);
+    // Degree of the B-spline curve type, cubic by default
+    void setBSplineDegree(int degree);
+    void setAdaptiveTessellation(bool enabled);
+    // Adaptive flatness tolerance in pixels, measured with the current camera
+    void setTessellationTolerance(double pixels);
+    void setProceduralGrid(bool enabled);
+    // Frustum culling and projected-size level of detail for the curves
+    void setLevelOfDetail(bool enabled);
+    // Evaluates the edited curve in the vertex shader where SceneRenderer supports it
+    void setGpuEvaluation(bool enabled);
+    void setHighlightedPoint(int index);
+    void sceneChanged();
+    // Records frames and shows their timings over the view
+    void setProfilerEnabled(bool enabled);
 
     signals:
-        void controlPointsMoved(const QList<QVector3D>& newPoints);
+        void curveTessellated(qsizetype vertexCount);
+        // Arc length of the edited curve; negative when unknown (GPU evaluation)
+        void curveLengthChanged(qreal length);
 
 protected:
     void initializeGL() override;
@@ -39,40 +83,102 @@ protected:
     void wheelEvent(QWheelEvent *event) override;
 
 private:
-    QString m_currentCurveType;
-    QList<QVector3D> m_controlPoints;
-    QVector<QVector3D> m_calculatedCurvePoints;
+    CurveType m_curveType = CurveType::Bezier;
+    int m_bsplineDegree = CurveCalculator::BSPLINE_DEGREE;
+    PointModel *m_pointModel = nullptr;
+
+    // --- Curve Evaluation (off the GUI thread) ---
+    CurveEvaluationWorker m_curveWorker;
+    QVector<QVector3D> m_curveVertices; // Delivered results applied in order
+    QVector<BoundingBox> m_curveBounds;
+    CurveType m_curveVerticesType = CurveType::Bezier;
+    IndexRange m_curveDirty;
+    IndexRange m_curveBoundsDirty;
+    bool m_curveLayoutChanged = true;
+    bool m_curveJobPending = false; // Submitted at the start of the next frame
+    quint64 m_curveGeneration = 0;  // Of the latest submitted job
+    // Edits since the last job: moved points travel alone, anything else as a snapshot
+    IndexRange m_curvePointsMoved;
+    bool m_curvePointsReset = true;
+    bool m_gpuEvaluation = false;
+
+    // --- Multi-Curve Scene (one buffer, one multi-draw, tessellated off the GUI thread) ---
+    CurveScene m_scene;
+    SceneEvaluationWorker m_sceneWorker;
+    SceneGeometry m_sceneGeometry; // Delivered results applied in order
+    IndexRange m_sceneDirty;
+    IndexRange m_sceneBoundsDirty;
+    bool m_sceneLayoutChanged = false;
+    bool m_sceneJobPending = false; // Submitted at the start of the next frame
+
+    // --- Surfaces (tessellated off the GUI thread, parallel across patches) ---
+    SurfaceModel *m_surfaceModel = nullptr;
+    SurfaceTessellationWorker m_surfaceWorker;
+    SurfaceMesh m_surfaceMesh; // Delivered results applied in order
+    IndexRange m_surfaceDirty;
+    bool m_surfaceLayoutChanged = false;
+    // Edits since the last job, submitted at the start of the next frame
+    QList<int> m_movedGrids;
+    bool m_surfacesReset = true;
+    bool m_surfaceJobPending = false;
+
+    // --- Tessellation Settings ---
+    bool m_adaptiveTessellation = false;
+    float m_tessellationTolerance = 0.5f; // Pixels
+    // Camera the adaptive curve was last tessellated for; screen-space
+    // tolerance needs a new tessellation when it changes
+    QMatrix4x4 m_adaptiveViewProjection;
+
+    // --- Pending Control Point Uploads ---
+    IndexRange m_pointsDirty;
+    bool m_pointsLayoutChanged = true;
 
     // --- 3D Camera/View State ---
     QMatrix4x4 m_projection;
     QMatrix4x4 m_view;
 
+    SceneCamera m_camera;
     QPoint m_lastMousePos;
-    qreal m_rotationX = 3.0;
-    qreal m_rotationY = -45.0;
-    qreal m_zoomDistance = -300.0;
 
     // --- Dragging State Variables ---
+    PointPicker m_picker;
     int m_draggingPointIndex = -1;
+    int m_hoveredPointIndex = -1;
+    int m_highlightedPointIndex = -1;
+    QVector<quint8> m_pointStates;
+    IndexRange m_pointStatesDirty;
 
-    // --- Modern OpenGL Members ---
-    QOpenGLShaderProgram m_program;
-    QOpenGLBuffer m_curveVbo;
-    QOpenGLBuffer m_pointsVbo;
+    // --- Rendering (shaders, buffers, draw calls) ---
+    SceneRenderer m_renderer;
+    bool m_proceduralGrid = false;
 
-    // Shader Locations
-    int m_posAttr;
-    int m_matrixUniform;
-    int m_colorUniform;
+    // --- Profiling ---
+    FrameProfiler m_profiler;
+    QLabel *m_profilerOverlay = nullptr;
+    QElapsedTimer m_overlayTimer; // Limits overlay text updates
+    qint64 m_bytesUploadedBefore = 0;
 
     // --- Private Methods ---
-    void calculateAndStoreCurve();
-    void initializeShaders();
+    const QList<QVector3D>& controlPoints() const;
+    void requestCurve();
+    void submitCurveJob();
+    void applyCurveResult(const CurveResult &result);
+    void onPointsMoved(int first, int count);
+    void onPointsInsertedOrRemoved(int first);
+    void shiftPointIndices(int first, int delta);
+    void onPointsReset();
+    void applySceneResult(const SceneResult &result);
+    void onGridMoved(int index);
+    void onGridsReset();
+    void submitSurfaceJob();
+    void applySurfaceResult(const SurfaceResult &result);
+    void updateSurfaces();
     void setupVBOs();
-    void drawAxes();
-    void drawCurve();
-    void drawPoints();
-    void drawGrid();
+    PointState pointState(int index) const;
+    void refreshPointState(int index);
+    int pickPoint(const QPointF &pos);
+    void recordFrameCounters();
+    void updateProfilerOverlay();
 };
 
 
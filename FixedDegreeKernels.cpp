@@ -0,0 +1,53 @@
+//
+// FixedDegreeKernels.cpp
+//
+
+#include "FixedDegreeKernels.h"
+
+namespace {
+
+template <int Degree>
+qsizetype evaluateBezier(std::span<const QVector3D> controlPoints, std::span<QVector3D> out)
+{
+    Q_ASSERT(controlPoints.size() == Degree + 1 && out.size() >= CurveCalculator::SEGMENT_SAMPLES);
+    BezierKernel<Degree>::evaluate(controlPoints.data(), out.data());
+    return CurveCalculator::SEGMENT_SAMPLES;
+}
+
+qsizetype evaluateBSpline(std::span<const QVector3D> controlPoints, std::span<QVector3D> out)
+{
+    const qsizetype pointCount = static_cast<qsizetype>(controlPoints.size());
+    Q_ASSERT(pointCount >= 4);
+    CubicBSplineKernel<>::evaluate(controlPoints.data(), pointCount, out.data());
+    return (pointCount - 3) * CurveCalculator::SEGMENT_SAMPLES;
+}
+
+// Indexed by degree - MIN_BEZIER_DEGREE
+template <int... Degree>
+constexpr std::array<FixedDegreeKernels::Evaluator, sizeof...(Degree)> bezierRegistry(
+        std::integer_sequence<int, Degree...>)
+{
+    return { &evaluateBezier<Degree + FixedDegreeKernels::MIN_BEZIER_DEGREE>... };
+}
+
+constexpr auto s_bezierEvaluators = bezierRegistry(std::make_integer_sequence<int,
+        FixedDegreeKernels::MAX_BEZIER_DEGREE - FixedDegreeKernels::MIN_BEZIER_DEGREE + 1>());
+
+}
+
+FixedDegreeKernels::Evaluator FixedDegreeKernels::find(CurveType type, qsizetype pointCount)
+{
+    switch (type) {
+    case CurveType::Bezier:
+        if (pointCount - 1 >= MIN_BEZIER_DEGREE && pointCount - 1 <= MAX_BEZIER_DEGREE) {
+            return s_bezierEvaluators[pointCount - 1 - MIN_BEZIER_DEGREE];
+        }
+        return nullptr;
+    case CurveType::BSpline:
+        return pointCount >= 4 ? &evaluateBSpline : nullptr;
+    case CurveType::Hermite:
+        // Catmull-Rom goes through explicit tangents; the generic path already is cubic-only
+        return nullptr;
+    }
+    return nullptr;
+}
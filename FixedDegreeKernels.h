@@ -0,0 +1,111 @@
+//
+// FixedDegreeKernels.h
+//
+
+#ifndef CURVES3D_FIXEDDEGREEKERNELS_H
+#define CURVES3D_FIXEDDEGREEKERNELS_H
+
+#include "CurveBasis.h"
+
+#include <utility>
+
+// Curve evaluators specialized at compile time on degree and point type.
+// The Bernstein rows are constexpr tables (same recurrence and rounding as
+// CurveBasis::bernstein) and the weighted sums are fold expressions, so each
+// sample is a fixed sequence of multiply-adds with no loop over the degree
+// and no table lookup by degree. Summation order matches the runtime
+// Tabulated path, so results are bit-identical to it.
+
+namespace FixedDegreeDetail {
+
+template <int Degree>
+using BernsteinTable = std::array<std::array<float, Degree + 1>, CurveCalculator::SEGMENT_SAMPLES>;
+
+template <int Degree>
+constexpr BernsteinTable<Degree> makeBernsteinTable()
+{
+    BernsteinTable<Degree> table{};
+    for (int step = 0; step < CurveCalculator::SEGMENT_SAMPLES; ++step) {
+        const qreal t = CurveBasis::stepParameter(step);
+        const qreal s = 1.0 - t;
+
+        std::array<qreal, Degree + 1> b{};
+        b[0] = 1.0;
+        for (int k = 1; k <= Degree; ++k) {
+            b[k] = t * b[k - 1];
+            for (int i = k - 1; i >= 1; --i) {
+                b[i] = s * b[i] + t * b[i - 1];
+            }
+            b[0] *= s;
+        }
+
+        for (int i = 0; i <= Degree; ++i) {
+            table[step][i] = static_cast<float>(b[i]);
+        }
+    }
+    return table;
+}
+
+template <int Degree>
+inline constexpr BernsteinTable<Degree> bernsteinTable = makeBernsteinTable<Degree>();
+
+// P[0]*w[0] + P[1]*w[1] + ... accumulated left to right
+template <typename Point, typename Weights, size_t... K>
+inline Point weightedSum(const Point *points, const Weights &w, std::index_sequence<K...>)
+{
+    Point sum = points[0] * w[0];
+    ((sum += points[K + 1] * w[K + 1]), ...);
+    return sum;
+}
+
+}
+
+// Bézier curve of a fixed degree (Degree + 1 control points)
+template <int Degree, typename Point = QVector3D>
+class BezierKernel
+{
+public:
+    static_assert(Degree >= 1, "a Bézier curve needs at least two control points");
+    static constexpr int POINT_COUNT = Degree + 1;
+
+    // Writes SEGMENT_SAMPLES points
+    static void evaluate(const Point *controlPoints, Point *out)
+    {
+        for (const auto &row : FixedDegreeDetail::bernsteinTable<Degree>) {
+            *out++ = FixedDegreeDetail::weightedSum(controlPoints, row, std::make_index_sequence<Degree>());
+        }
+    }
+};
+
+// Uniform cubic B-spline, one segment per window of four control points
+template <typename Point = QVector3D>
+class CubicBSplineKernel
+{
+public:
+    // Writes SEGMENT_SAMPLES points per segment (pointCount - 3 segments)
+    static void evaluate(const Point *controlPoints, qsizetype pointCount, Point *out)
+    {
+        for (qsizetype i = 3; i < pointCount; ++i) {
+            for (const CurveBasis::CubicWeights &w : CurveBasis::uniformBSpline()) {
+                *out++ = FixedDegreeDetail::weightedSum(controlPoints + i - 3, w, std::make_index_sequence<3>());
+            }
+        }
+    }
+};
+
+// Dispatch by curve type and point count, resolved once per curve (when the
+// type or the point count changes) rather than on every recompute.
+class FixedDegreeKernels
+{
+public:
+    static constexpr int MIN_BEZIER_DEGREE = 2;
+    static constexpr int MAX_BEZIER_DEGREE = 7;
+
+    // Same contract as CurveCalculator::evaluate() with BasisEvaluation::Tabulated
+    using Evaluator = qsizetype (*)(std::span<const QVector3D> controlPoints, std::span<QVector3D> out);
+
+    // nullptr when no specialization exists: fall back to CurveCalculator::evaluate()
+    static Evaluator find(CurveType type, qsizetype pointCount);
+};
+
+#endif //CURVES3D_FIXEDDEGREEKERNELS_H
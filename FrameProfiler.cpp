@@ -0,0 +1,215 @@
+//
+// FrameProfiler.cpp
+//
+
+#include "FrameProfiler.h"
+
+#include <QSaveFile>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char *const FRAME_EVENT = "Frame";
+
+// Chrome trace thread ids, one per ProfileEvent::Track
+const char *const TRACK_NAMES[] = { "GUI thread", "Curve worker", "GPU" };
+
+bool isFrameEvent(const ProfileEvent& event)
+{
+    return event.track == ProfileEvent::Cpu && std::strcmp(event.name, FRAME_EVENT) == 0;
+}
+
+QString microseconds(qint64 ns)
+{
+    return QString::number(ns / 1000.0, 'f', 3);
+}
+
+}
+
+qint64 FrameProfiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FrameProfiler::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+void FrameProfiler::beginFrame()
+{
+    if (!m_enabled) return;
+
+    ++m_frame;
+    m_frameStartNs = now();
+    m_frameStarts[m_frame % HISTORY_FRAMES] = FrameStart{ m_frame, m_frameStartNs };
+    dropOldFrames();
+}
+
+void FrameProfiler::endFrame()
+{
+    if (!m_enabled || m_frameStartNs == 0) return;
+
+    addEvent(FRAME_EVENT, ProfileEvent::Cpu, m_frameStartNs, now() - m_frameStartNs);
+    m_frameStartNs = 0;
+}
+
+void FrameProfiler::addEvent(const char *name, ProfileEvent::Track track, qint64 startNs, qint64 durationNs)
+{
+    if (!m_enabled) return;
+    m_events.append(ProfileEvent{ name, track, m_frame, startNs, durationNs });
+}
+
+void FrameProfiler::addGpuEvent(const char *name, quint64 frame, qint64 offsetNs, qint64 durationNs)
+{
+    if (!m_enabled) return;
+
+    const qint64 start = frameStart(frame);
+    if (start == 0) return; // Frame already dropped from the history
+    m_events.append(ProfileEvent{ name, ProfileEvent::Gpu, frame, start + offsetNs, durationNs });
+}
+
+void FrameProfiler::setCounter(const char *name, qint64 value)
+{
+    if (!m_enabled) return;
+    m_counters.append(ProfileCounter{ name, m_frame, now(), value });
+}
+
+qint64 FrameProfiler::frameStart(quint64 frame) const
+{
+    // The events list interleaves GPU batches of older frames with the current
+    // frame's events, so it cannot be searched by frame order
+    const FrameStart& entry = m_frameStarts[frame % HISTORY_FRAMES];
+    return entry.frame == frame ? entry.startNs : 0;
+}
+
+void FrameProfiler::dropOldFrames()
+{
+    // Trimmed in batches so the lists are not shifted every frame
+    if (m_frame < HISTORY_FRAMES + HISTORY_FRAMES / 4) return;
+    const quint64 oldest = m_frame - HISTORY_FRAMES;
+
+    if (!m_events.isEmpty() && m_events.first().frame + HISTORY_FRAMES / 4 < oldest) {
+        const auto end = std::find_if(m_events.begin(), m_events.end(),
+                                      [oldest](const ProfileEvent& e) { return e.frame >= oldest; });
+        m_events.erase(m_events.begin(), end);
+    }
+    if (!m_counters.isEmpty() && m_counters.first().frame + HISTORY_FRAMES / 4 < oldest) {
+        const auto end = std::find_if(m_counters.begin(), m_counters.end(),
+                                      [oldest](const ProfileCounter& c) { return c.frame >= oldest; });
+        m_counters.erase(m_counters.begin(), end);
+    }
+}
+
+QList<ProfileStageSummary> FrameProfiler::summary(quint64 frames) const
+{
+    QList<ProfileStageSummary> stages;
+    QList<int> counts;
+
+    for (const ProfileEvent& event : m_events) {
+        if (event.frame + frames <= m_frame || isFrameEvent(event)) continue;
+
+        auto it = std::find_if(stages.begin(), stages.end(), [&event](const ProfileStageSummary& s) {
+            return s.track == event.track && std::strcmp(s.name, event.name) == 0;
+        });
+        if (it == stages.end()) {
+            stages.append(ProfileStageSummary{ event.name, event.track, 0.0, 0.0 });
+            counts.append(0);
+            it = stages.end() - 1;
+        }
+        const double ms = event.durationNs / 1.0e6;
+        it->averageMs += ms;
+        it->maxMs = std::max(it->maxMs, ms);
+        ++counts[it - stages.begin()];
+    }
+
+    // Averaged over the frames a stage ran in: curve evaluation only runs on edits
+    for (qsizetype i = 0; i < stages.size(); ++i) {
+        stages[i].averageMs /= counts[i];
+    }
+    return stages;
+}
+
+QList<ProfileCounter> FrameProfiler::lastCounters() const
+{
+    const quint64 frame = m_frameStartNs == 0 ? m_frame : m_frame - 1;
+    QList<ProfileCounter> counters;
+    for (auto it = m_counters.crbegin(); it != m_counters.crend() && it->frame >= frame; ++it) {
+        if (it->frame == frame) counters.prepend(*it);
+    }
+    return counters;
+}
+
+double FrameProfiler::averageFrameMs(quint64 frames) const
+{
+    qint64 total = 0;
+    int count = 0;
+    for (auto it = m_events.crbegin(); it != m_events.crend() && it->frame + frames > m_frame; ++it) {
+        if (isFrameEvent(*it)) {
+            total += it->durationNs;
+            ++count;
+        }
+    }
+    return count > 0 ? total / 1.0e6 / count : 0.0;
+}
+
+bool FrameProfiler::writeChromeTrace(const QString& path, QString* errorString) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+
+    qint64 origin = std::numeric_limits<qint64>::max();
+    for (const ProfileEvent& event : m_events) origin = std::min(origin, event.startNs);
+    for (const ProfileCounter& counter : m_counters) origin = std::min(origin, counter.timeNs);
+
+    QTextStream out(&file);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+    auto separator = [&out, &first] {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    for (int track = 0; track < 3; ++track) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track + 1
+            << ",\"args\":{\"name\":\"" << TRACK_NAMES[track] << "\"}}";
+    }
+    for (const ProfileEvent& event : m_events) {
+        separator();
+        out << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.track + 1
+            << ",\"ts\":" << microseconds(event.startNs - origin) << ",\"dur\":" << microseconds(event.durationNs)
+            << ",\"args\":{\"frame\":" << event.frame << "}}";
+    }
+    for (const ProfileCounter& counter : m_counters) {
+        separator();
+        out << "{\"name\":\"" << counter.name << "\",\"ph\":\"C\",\"pid\":1"
+            << ",\"ts\":" << microseconds(counter.timeNs - origin)
+            << ",\"args\":{\"value\":" << counter.value << "}}";
+    }
+    out << "\n]}\n";
+    out.flush();
+
+    if (!file.commit()) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void FrameProfiler::clear()
+{
+    m_events.clear();
+    m_counters.clear();
+    m_frameStarts.fill(FrameStart{});
+}
@@ -0,0 +1,126 @@
+//
+// FrameProfiler.h
+//
+
+#ifndef CURVES3D_FRAMEPROFILER_H
+#define CURVES3D_FRAMEPROFILER_H
+
+#include <QList>
+#include <QString>
+
+#include <array>
+
+// One timed stage of a frame. Times are nanoseconds on FrameProfiler::now()'s
+// clock; GPU stages are placed at the CPU start of the frame they belong to.
+struct ProfileEvent
+{
+    enum Track : quint8 { Cpu, Worker, Gpu };
+
+    const char *name = nullptr; // Static string
+    Track track = Cpu;
+    quint64 frame = 0;
+    qint64 startNs = 0;
+    qint64 durationNs = 0;
+};
+
+// Per-frame value such as draw calls or bytes uploaded
+struct ProfileCounter
+{
+    const char *name = nullptr;
+    quint64 frame = 0;
+    qint64 timeNs = 0;
+    qint64 value = 0;
+};
+
+// Averages of one stage over the recent frames, for the overlay
+struct ProfileStageSummary
+{
+    const char *name = nullptr;
+    ProfileEvent::Track track = ProfileEvent::Cpu;
+    double averageMs = 0.0;
+    double maxMs = 0.0;
+};
+
+// Collects stage timings and counters for the last HISTORY_FRAMES frames.
+// Disabled it records nothing, so scopes left in the code cost one branch.
+// Used from the GUI thread only: work done on other threads is recorded
+// here by the thread that receives its result.
+class FrameProfiler
+{
+public:
+    static constexpr quint64 HISTORY_FRAMES = 600;
+
+    // Monotonic clock shared by every thread
+    static qint64 now();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // Frames are numbered from 1; events recorded between the calls belong to the current one
+    void beginFrame();
+    void endFrame();
+    quint64 currentFrame() const { return m_frame; }
+
+    void addEvent(const char *name, ProfileEvent::Track track, qint64 startNs, qint64 durationNs);
+    // GPU results arrive a few frames late, so they name the frame they belong to
+    void addGpuEvent(const char *name, quint64 frame, qint64 offsetNs, qint64 durationNs);
+    void setCounter(const char *name, qint64 value);
+
+    // Stages other than the frame itself, in first-recorded order
+    QList<ProfileStageSummary> summary(quint64 frames) const;
+    // Counter values of the last completed frame
+    QList<ProfileCounter> lastCounters() const;
+    double averageFrameMs(quint64 frames) const;
+
+    // Chrome trace event format, viewable in chrome://tracing or Perfetto
+    bool writeChromeTrace(const QString& path, QString* errorString = nullptr) const;
+    void clear();
+
+private:
+    qint64 frameStart(quint64 frame) const;
+    void dropOldFrames();
+
+    bool m_enabled = false;
+    quint64 m_frame = 0;
+    qint64 m_frameStartNs = 0;
+
+    // Start time of each recent frame, indexed by frame % HISTORY_FRAMES, for
+    // placing GPU results that arrive after later frames' events
+    struct FrameStart
+    {
+        quint64 frame = 0;
+        qint64 startNs = 0;
+    };
+    std::array<FrameStart, HISTORY_FRAMES> m_frameStarts{};
+
+    QList<ProfileEvent> m_events;     // In recording order
+    QList<ProfileCounter> m_counters;
+};
+
+// Times the enclosing block as a CPU stage of the current frame
+class ProfileScope
+{
+public:
+    ProfileScope(FrameProfiler *profiler, const char *name)
+        : m_profiler(profiler && profiler->isEnabled() ? profiler : nullptr), m_name(name),
+          m_startNs(m_profiler ? FrameProfiler::now() : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (m_profiler) {
+            m_profiler->addEvent(m_name, ProfileEvent::Cpu, m_startNs, FrameProfiler::now() - m_startNs);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    FrameProfiler *m_profiler;
+    const char *m_name;
+    qint64 m_startNs;
+};
+
+#endif //CURVES3D_FRAMEPROFILER_H
@@ -0,0 +1,100 @@
+//
+// GpuBuffer.cpp
+//
+
+#include "GpuBuffer.h"
+
+namespace {
+
+// Grow by half again so appending points does not reallocate every edit
+qsizetype grownCapacity(qsizetype current, qsizetype needed)
+{
+    return std::max(needed, current + current / 2);
+}
+
+}
+
+GpuBuffer::GpuBuffer(QOpenGLBuffer::UsagePattern usage, QOpenGLBuffer::Type type)
+    : m_buffer(type), m_usage(usage)
+{
+}
+
+void GpuBuffer::markDirty(const IndexRange& range)
+{
+    m_dirty.unite(range);
+}
+
+void GpuBuffer::markAllDirty()
+{
+    m_allDirty = true;
+}
+
+qint64 GpuBuffer::sync(const void* data, qsizetype count, qsizetype elementSize)
+{
+    const qsizetype previousCount = m_count;
+    m_count = count;
+
+    if (count > previousCount) {
+        m_dirty.unite({ previousCount, count - previousCount });
+    }
+
+    const bool allDirty = m_allDirty;
+    const IndexRange dirty = m_dirty;
+    m_allDirty = false;
+    m_dirty = {};
+
+    if (count == 0 || (!allDirty && dirty.isEmpty())) {
+        return 0;
+    }
+
+    if (!m_buffer.isCreated()) {
+        m_buffer.create();
+        m_buffer.setUsagePattern(m_usage);
+    }
+    m_buffer.bind();
+
+    const char* bytes = static_cast<const char*>(data);
+    const qsizetype neededBytes = count * elementSize;
+    qint64 uploaded = 0;
+
+    if (neededBytes > m_capacityBytes || allDirty) {
+        // Orphan: fresh storage (grown if needed), the GPU keeps reading the old one
+        if (neededBytes > m_capacityBytes) {
+            m_capacityBytes = grownCapacity(m_capacityBytes, neededBytes);
+        }
+        m_buffer.allocate(static_cast<int>(m_capacityBytes));
+        m_buffer.write(0, bytes, static_cast<int>(neededBytes));
+        uploaded = neededBytes;
+    } else {
+        const qsizetype first = std::min(dirty.first, count);
+        const qsizetype end = std::min(dirty.end(), count);
+        if (end > first) {
+            m_buffer.write(static_cast<int>(first * elementSize), bytes + first * elementSize,
+                           static_cast<int>((end - first) * elementSize));
+            uploaded = (end - first) * elementSize;
+        }
+    }
+
+    m_buffer.release();
+    m_totalBytesUploaded += uploaded;
+    return uploaded;
+}
+
+bool GpuBuffer::bind()
+{
+    return m_buffer.isCreated() && m_buffer.bind();
+}
+
+void GpuBuffer::release()
+{
+    m_buffer.release();
+}
+
+void GpuBuffer::destroy()
+{
+    m_buffer.destroy();
+    m_count = 0;
+    m_capacityBytes = 0;
+    m_dirty = {};
+    m_allDirty = true;
+}
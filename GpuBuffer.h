@@ -0,0 +1,58 @@
+//
+// GpuBuffer.h
+//
+
+#ifndef CURVES3D_GPUBUFFER_H
+#define CURVES3D_GPUBUFFER_H
+
+#include <QOpenGLBuffer>
+#include <QVector>
+
+#include "IndexRange.h"
+
+// Persistent vertex (or index) buffer with dirty tracking. The GL buffer is created
+// once and grows geometrically; full rewrites orphan the old storage so the
+// driver never stalls on a buffer the GPU is still reading, and partial
+// edits are sent with glBufferSubData. A frame with nothing marked dirty
+// uploads zero bytes. Must be synced with the owning context current.
+class GpuBuffer
+{
+public:
+    explicit GpuBuffer(QOpenGLBuffer::UsagePattern usage = QOpenGLBuffer::DynamicDraw,
+                       QOpenGLBuffer::Type type = QOpenGLBuffer::VertexBuffer);
+
+    // Element ranges changed since the last sync (indices in elements, not bytes)
+    void markDirty(const IndexRange& range);
+    void markAllDirty();
+
+    // Makes the GPU copy match data[0, count); elements past the previous count
+    // are implicitly dirty. Returns the number of bytes sent.
+    qint64 sync(const void* data, qsizetype count, qsizetype elementSize);
+
+    template <typename T>
+    qint64 sync(const QVector<T>& data)
+    {
+        return sync(data.constData(), data.size(), static_cast<qsizetype>(sizeof(T)));
+    }
+
+    bool bind();
+    void release();
+    void destroy();
+
+    bool isCreated() const { return m_buffer.isCreated(); }
+    qsizetype count() const { return m_count; }
+    qsizetype capacityBytes() const { return m_capacityBytes; }
+    qint64 totalBytesUploaded() const { return m_totalBytesUploaded; }
+
+private:
+    QOpenGLBuffer m_buffer;
+    QOpenGLBuffer::UsagePattern m_usage;
+
+    qsizetype m_count = 0;
+    qsizetype m_capacityBytes = 0;
+    IndexRange m_dirty;
+    bool m_allDirty = true;
+    qint64 m_totalBytesUploaded = 0;
+};
+
+#endif //CURVES3D_GPUBUFFER_H
@@ -0,0 +1,70 @@
+//
+// GpuStageTimer.cpp
+//
+
+#include "GpuStageTimer.h"
+
+bool GpuStageTimer::create(int stageCount)
+{
+    m_available = true;
+    for (Slot& slot : m_slots) {
+        slot.monitor = std::make_unique<QOpenGLTimeMonitor>();
+        slot.monitor->setSampleCount(stageCount + 1);
+        m_available = m_available && slot.monitor->create();
+    }
+    if (!m_available) destroy();
+    return m_available;
+}
+
+void GpuStageTimer::destroy()
+{
+    for (Slot& slot : m_slots) {
+        if (slot.monitor) slot.monitor->destroy();
+        slot.monitor.reset();
+        slot.pending = false;
+    }
+    m_available = false;
+    m_recording = false;
+}
+
+void GpuStageTimer::beginFrame(quint64 frame)
+{
+    Slot& slot = m_slots[m_next];
+    m_recording = m_available && !slot.pending;
+    if (!m_recording) return;
+
+    slot.monitor->reset();
+    slot.frame = frame;
+    slot.monitor->recordSample();
+}
+
+void GpuStageTimer::endStage()
+{
+    if (m_recording) m_slots[m_next].monitor->recordSample();
+}
+
+void GpuStageTimer::endFrame()
+{
+    if (!m_recording) return;
+
+    m_slots[m_next].pending = true;
+    m_next = (m_next + 1) % LATENCY_FRAMES;
+    m_recording = false;
+}
+
+void GpuStageTimer::collect(const ResultHandler& handler)
+{
+    // The slot recorded next is the oldest one
+    for (int i = 0; i < LATENCY_FRAMES; ++i) {
+        Slot& slot = m_slots[(m_next + i) % LATENCY_FRAMES];
+        if (!slot.pending || !slot.monitor->isResultAvailable()) continue;
+
+        const QList<GLuint64> samples = slot.monitor->waitForSamples();
+        for (qsizetype stage = 0; stage + 1 < samples.size(); ++stage) {
+            handler(slot.frame, static_cast<int>(stage),
+                    static_cast<qint64>(samples[stage] - samples[0]),
+                    static_cast<qint64>(samples[stage + 1] - samples[stage]));
+        }
+        slot.pending = false;
+    }
+}
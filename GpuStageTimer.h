@@ -0,0 +1,51 @@
+//
+// GpuStageTimer.h
+//
+
+#ifndef CURVES3D_GPUSTAGETIMER_H
+#define CURVES3D_GPUSTAGETIMER_H
+
+#include <QOpenGLTimeMonitor>
+
+#include <array>
+#include <functional>
+#include <memory>
+
+// GPU time of consecutive stages of a frame, from timestamp queries. Each
+// frame records into the next of LATENCY_FRAMES monitors and results are
+// read only once the GPU has finished, so timing never stalls the pipeline;
+// a frame that finds its monitor still busy simply goes untimed. Without
+// timer query support create() fails and every call does nothing.
+class GpuStageTimer
+{
+public:
+    static constexpr int LATENCY_FRAMES = 4;
+
+    // Needs a current context; every frame must end the same number of stages
+    bool create(int stageCount);
+    void destroy();
+    bool isAvailable() const { return m_available; }
+
+    void beginFrame(quint64 frame);
+    void endStage();
+    void endFrame();
+
+    // Reports every finished frame once, oldest first; offsets are from the frame's first sample
+    using ResultHandler = std::function<void(quint64 frame, int stage, qint64 offsetNs, qint64 durationNs)>;
+    void collect(const ResultHandler& handler);
+
+private:
+    struct Slot
+    {
+        std::unique_ptr<QOpenGLTimeMonitor> monitor;
+        quint64 frame = 0;
+        bool pending = false;
+    };
+
+    std::array<Slot, LATENCY_FRAMES> m_slots;
+    int m_next = 0;
+    bool m_recording = false;
+    bool m_available = false;
+};
+
+#endif //CURVES3D_GPUSTAGETIMER_H
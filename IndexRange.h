@@ -0,0 +1,56 @@
+//
+// IndexRange.h
+//
+
+#ifndef CURVES3D_INDEXRANGE_H
+#define CURVES3D_INDEXRANGE_H
+
+#include <QtGlobal>
+#include <QVector>
+
+#include <algorithm>
+
+// Half-open index range [first, first + count)
+struct IndexRange
+{
+    qsizetype first = 0;
+    qsizetype count = 0;
+
+    bool isEmpty() const { return count <= 0; }
+    qsizetype end() const { return first + count; }
+
+    void unite(const IndexRange& other)
+    {
+        if (other.isEmpty()) return;
+        if (isEmpty()) {
+            *this = other;
+            return;
+        }
+        const qsizetype newEnd = std::max(end(), other.end());
+        first = std::min(first, other.first);
+        count = newEnd - first;
+    }
+};
+
+// Copy of [range.first, range.end()) clamped to the array, for handing the
+// changed part of an array to another thread: ranges accumulated across
+// dropped jobs may reach past an array that has since shrunk
+template <typename T>
+QVector<T> sliceOf(const QVector<T>& all, IndexRange& range)
+{
+    const qsizetype first = std::min(range.first, all.size());
+    const qsizetype end = std::min(range.end(), all.size());
+    range = { first, end - first };
+    return QVector<T>(all.cbegin() + first, all.cbegin() + end);
+}
+
+// Resizes all to size and writes a slice taken by sliceOf() back into it
+template <typename T>
+void applySlice(QVector<T>& all, qsizetype size, const QVector<T>& slice, const IndexRange& range)
+{
+    all.resize(size);
+    Q_ASSERT(slice.size() == range.count && range.end() <= size);
+    std::copy(slice.cbegin(), slice.cend(), all.begin() + range.first);
+}
+
+#endif //CURVES3D_INDEXRANGE_H
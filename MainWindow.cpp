@@ -5,12 +5,22 @@
 #include "MainWindow.h"
 #include "DrawingArea.h"
 #include "PointModel.h"
+#include "PointImporter.h"
+#include "SceneFile.h"
+#include "PointTableModel.h"
+#include "SurfaceModel.h"
+#include "CoordinateDelegate.h"
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QLineEdit>
 #include <QDebug>
-#include <QDoubleValidator>
-#include <QScrollBar>
+#include <QHeaderView>
+#include <QMenuBar>
+#include <QStatusBar>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QRandomGenerator>
+#include <cmath>
 #include <cstdlib> // For qrand in initialization
 
 MainWindow::MainWindow(QWidget *parent)
@@ -20,10 +30,21 @@ MainWindow::MainWindow(QWidget *parent)
     resize(1000, 700);
 
     m_pointModel = new PointModel(this);
+    m_importer = new PointImporter(this);
+    m_surfaceModel = new SurfaceModel(this);
     drawingArea = new DrawingArea;
 
-    connect(m_pointModel, &PointModel::pointsChanged, drawingArea, &DrawingArea::updateCurve);
-    connect(drawingArea, &DrawingArea::controlPointsMoved, this, &MainWindow::syncUIFromDrawingArea);
+    drawingArea->setPointModel(m_pointModel);
+    drawingArea->setSurfaceModel(m_surfaceModel);
+
+    connect(m_importer, &PointImporter::pointsRead, this, &MainWindow::importChunk);
+    connect(m_importer, &PointImporter::finished, this, &MainWindow::importFinished);
+    connect(m_importer, &PointImporter::progress, this, [this](qint64 bytesRead, qint64 bytesTotal) {
+        const int percent = bytesTotal > 0 ? static_cast<int>(100 * bytesRead / bytesTotal) : 0;
+        statusBar()->showMessage(QString("Importing: %1 points (%2%)").arg(m_pointModel->count()).arg(percent));
+    });
+
+    createFileMenu();
 
     // 1. Set the central widget (the Drawing Area takes the full space)
     setCentralWidget(drawingArea);
@@ -38,15 +59,33 @@ MainWindow::MainWindow(QWidget *parent)
     drawingArea->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
     handleCurveSelection(curveDropdown->currentIndex());
-    // Initial data setup
+    // Initial data setup, announced to the views as a single change
+    m_pointModel->beginBatch();
     for (int i = 0; i < 4; ++i) { addPointEntry(); }
-    updateModelFromUI();
+    m_pointModel->endBatch();
 }
 
 MainWindow::~MainWindow() {}
 
 // --- Setup Methods ---
 
+void MainWindow::createFileMenu()
+{
+    QMenu *fileMenu = menuBar()->addMenu("&File");
+
+    QAction *openAction = fileMenu->addAction("&Open...");
+    openAction->setShortcut(QKeySequence::Open);
+    connect(openAction, &QAction::triggered, this, &MainWindow::openFile);
+
+    QAction *saveAction = fileMenu->addAction("&Save Scene...");
+    saveAction->setShortcut(QKeySequence::Save);
+    connect(saveAction, &QAction::triggered, this, &MainWindow::saveScene);
+
+    fileMenu->addSeparator();
+    QAction *traceAction = fileMenu->addAction("Export Profiler &Trace...");
+    connect(traceAction, &QAction::triggered, this, &MainWindow::exportProfilerTrace);
+}
+
 QDockWidget* MainWindow::createControlPanel()
 {
     // ... (Control panel setup)
@@ -65,43 +104,143 @@ QDockWidget* MainWindow::createControlPanel()
 
     vLayout->addWidget(new QLabel("Curve Type:"));
     curveDropdown = new QComboBox;
-    curveDropdown->addItem("Bézier Curve (De Casteljau)");
-    curveDropdown->addItem("Hermite Curve (Matricielle)");
-    curveDropdown->addItem("B-Spline Curve");
+    // The type travels as item data: no name comparisons when it changes
+    curveDropdown->addItem("Bézier Curve (De Casteljau)", static_cast<int>(CurveType::Bezier));
+    curveDropdown->addItem("Hermite Curve (Matricielle)", static_cast<int>(CurveType::Hermite));
+    curveDropdown->addItem("B-Spline Curve", static_cast<int>(CurveType::BSpline));
     vLayout->addWidget(curveDropdown);
     connect(curveDropdown, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::handleCurveSelection);
 
+    // Only the B-spline takes a degree; each one needs degree + 1 points
+    QHBoxLayout *degreeLayout = new QHBoxLayout;
+    degreeLayout->addWidget(new QLabel("Degree:"));
+    degreeSpinBox = new QSpinBox;
+    degreeSpinBox->setRange(1, 7);
+    degreeSpinBox->setValue(CurveCalculator::BSPLINE_DEGREE);
+    degreeSpinBox->setToolTip("Degree of the B-spline; needs at least degree + 1 control points");
+    degreeSpinBox->setEnabled(false);
+    degreeLayout->addWidget(degreeSpinBox);
+    vLayout->addLayout(degreeLayout);
+    connect(degreeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            drawingArea, &DrawingArea::setBSplineDegree);
+
+    adaptiveCheckBox = new QCheckBox("Adaptive tessellation");
+    adaptiveCheckBox->setToolTip("Subdivide by flatness instead of a fixed number of samples per segment");
+    vLayout->addWidget(adaptiveCheckBox);
+    connect(adaptiveCheckBox, &QCheckBox::toggled, drawingArea, &DrawingArea::setAdaptiveTessellation);
+
+    // Flatness is measured on screen, so zooming in refines the curve
+    QHBoxLayout *toleranceLayout = new QHBoxLayout;
+    toleranceLayout->addWidget(new QLabel("Tolerance:"));
+    toleranceSpinBox = new QDoubleSpinBox;
+    toleranceSpinBox->setRange(0.05, 20.0);
+    toleranceSpinBox->setSingleStep(0.25);
+    toleranceSpinBox->setValue(0.5);
+    toleranceSpinBox->setSuffix(" px");
+    toleranceSpinBox->setToolTip("Largest distance in pixels between the adaptive polyline and the curve");
+    toleranceSpinBox->setEnabled(false);
+    toleranceLayout->addWidget(toleranceSpinBox);
+    vLayout->addLayout(toleranceLayout);
+    connect(adaptiveCheckBox, &QCheckBox::toggled, toleranceSpinBox, &QDoubleSpinBox::setEnabled);
+    connect(toleranceSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            drawingArea, &DrawingArea::setTessellationTolerance);
+
+    proceduralGridCheckBox = new QCheckBox("Procedural grid");
+    proceduralGridCheckBox->setToolTip("Draw an infinite shader grid instead of the cached line grid");
+    vLayout->addWidget(proceduralGridCheckBox);
+    connect(proceduralGridCheckBox, &QCheckBox::toggled, drawingArea, &DrawingArea::setProceduralGrid);
+
+    levelOfDetailCheckBox = new QCheckBox("Culling and level of detail");
+    levelOfDetailCheckBox->setToolTip("Skip off-screen curve segments and draw small ones with fewer samples");
+    levelOfDetailCheckBox->setChecked(true);
+    vLayout->addWidget(levelOfDetailCheckBox);
+    connect(levelOfDetailCheckBox, &QCheckBox::toggled, drawingArea, &DrawingArea::setLevelOfDetail);
+
+    gpuEvaluationCheckBox = new QCheckBox("Evaluate curve on GPU");
+    gpuEvaluationCheckBox->setToolTip(QString("Evaluate the curve in the vertex shader from the control points"
+                                              " (Bézier up to %1 points); edits upload only the moved points")
+                                          .arg(SceneRenderer::MAX_GPU_BEZIER_POINTS));
+    vLayout->addWidget(gpuEvaluationCheckBox);
+    connect(gpuEvaluationCheckBox, &QCheckBox::toggled, drawingArea, &DrawingArea::setGpuEvaluation);
+
+    profilerCheckBox = new QCheckBox("Profiler overlay");
+    profilerCheckBox->setToolTip("Time every frame stage on the CPU and GPU; export with File > Export Profiler Trace");
+    vLayout->addWidget(profilerCheckBox);
+    connect(profilerCheckBox, &QCheckBox::toggled, drawingArea, &DrawingArea::setProfilerEnabled);
+
+    vertexCountLabel = new QLabel("Vertices: 0");
+    vLayout->addWidget(vertexCountLabel);
+    connect(drawingArea, &DrawingArea::curveTessellated, this, [this](qsizetype vertexCount) {
+        vertexCountLabel->setText(QString("Vertices: %1").arg(vertexCount));
+    });
+
+    curveLengthLabel = new QLabel("Length: 0");
+    vLayout->addWidget(curveLengthLabel);
+    connect(drawingArea, &DrawingArea::curveLengthChanged, this, [this](qreal length) {
+        curveLengthLabel->setText(length < 0.0 ? QString("Length: -")
+                                               : QString("Length: %1").arg(length, 0, 'f', 2));
+    });
+
+    // Extra random curves, all drawn from one buffer with a single multi-draw
+    QHBoxLayout *sceneLayout = new QHBoxLayout;
+    sceneLayout->addWidget(new QLabel("Scene curves:"));
+    sceneCurvesSpinBox = new QSpinBox;
+    sceneCurvesSpinBox->setRange(0, 10000);
+    sceneCurvesSpinBox->setSingleStep(100);
+    sceneLayout->addWidget(sceneCurvesSpinBox);
+    vLayout->addLayout(sceneLayout);
+    connect(sceneCurvesSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::populateScene);
+
+    // A generated patch network; at 200 x 200 patches it is about 20 million triangles
+    QHBoxLayout *surfaceLayout = new QHBoxLayout;
+    surfaceLayout->addWidget(new QLabel("Surface:"));
+    surfaceDropdown = new QComboBox;
+    surfaceDropdown->addItem("None", -1);
+    surfaceDropdown->addItem("B-Spline", static_cast<int>(SurfaceType::BSpline));
+    surfaceDropdown->addItem("Bézier", static_cast<int>(SurfaceType::Bezier));
+    surfaceLayout->addWidget(surfaceDropdown);
+    surfacePatchesSpinBox = new QSpinBox;
+    surfacePatchesSpinBox->setRange(1, 200);
+    surfacePatchesSpinBox->setValue(8);
+    surfacePatchesSpinBox->setSuffix(" patches");
+    surfacePatchesSpinBox->setToolTip("Patches along each side of the surface");
+    surfaceLayout->addWidget(surfacePatchesSpinBox);
+    vLayout->addLayout(surfaceLayout);
+    connect(surfaceDropdown, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::populateSurface);
+    connect(surfacePatchesSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::populateSurface);
+
     vLayout->addSpacing(15);
     vLayout->addWidget(new QLabel("Control Points (X, Y, Z Coords):"));
     vLayout->addSpacing(5);
 
-    // Header for coordinates
-    QHBoxLayout *headerLayout = new QHBoxLayout;
-    headerLayout->addSpacing(25);
-    headerLayout->addWidget(new QLabel("X"));
-    headerLayout->addWidget(new QLabel("Y"));
-    headerLayout->addWidget(new QLabel("Z"));
-    headerLayout->addStretch(1);
-    vLayout->addLayout(headerLayout);
-
-    scrollArea = new QScrollArea;
-    scrollArea->setWidgetResizable(true);
-    scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-
-    pointsContainer = new QWidget;
-    pointsLayout = new QVBoxLayout(pointsContainer);
-    pointsLayout->setAlignment(Qt::AlignTop);
-    pointsLayout->setSpacing(5);
-    pointsLayout->setContentsMargins(0, 0, 0, 0);
-    pointsLayout->addStretch(1);
-
-    scrollArea->setWidget(pointsContainer);
-    vLayout->addWidget(scrollArea);
-
+    // Only the rows on screen are materialized; cells are edited through the delegate
+    m_pointTableModel = new PointTableModel(m_pointModel, this);
+    pointsTable = new QTableView;
+    pointsTable->setModel(m_pointTableModel);
+    pointsTable->setItemDelegate(new CoordinateDelegate(pointsTable));
+    pointsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    pointsTable->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed
+                                 | QAbstractItemView::AnyKeyPressed);
+    pointsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    // Fixed row heights let the view place rows without measuring any of them
+    pointsTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    pointsTable->verticalHeader()->setDefaultSectionSize(pointsTable->fontMetrics().height() + 6);
+    vLayout->addWidget(pointsTable);
+    connect(pointsTable->selectionModel(), &QItemSelectionModel::currentRowChanged, this,
+            [this](const QModelIndex &current) {
+        drawingArea->setHighlightedPoint(current.isValid() ? current.row() : -1);
+    });
+
+    QHBoxLayout *pointButtonsLayout = new QHBoxLayout;
     addPointButton = new QPushButton("Add Point (+)");
     connect(addPointButton, &QPushButton::clicked, this, &MainWindow::addPointEntry);
-    vLayout->addWidget(addPointButton);
+    pointButtonsLayout->addWidget(addPointButton);
+
+    removePointButton = new QPushButton("Remove Selected (-)");
+    connect(removePointButton, &QPushButton::clicked, this, &MainWindow::removePointEntry);
+    pointButtonsLayout->addWidget(removePointButton);
+    vLayout->addLayout(pointButtonsLayout);
 
     // --- End existing control setup ---
 
@@ -113,147 +252,213 @@ QDockWidget* MainWindow::createControlPanel()
     return dock;
 }
 
-QWidget* MainWindow::createPointEntryWidget()
+void MainWindow::addPointEntry()
 {
-    QWidget *widget = new QWidget;
-    QHBoxLayout *hLayout = new QHBoxLayout(widget);
-    hLayout->setContentsMargins(0, 0, 0, 0);
-
-    int count = pointRows.size();
-
-    QLabel *label = new QLabel(QString("P%1:").arg(count));
-    label->setFixedWidth(25);
-    hLayout->addWidget(label);
-
-    QDoubleValidator *validator = new QDoubleValidator(-999.0, 999.0, 1, this);
-
-    // X Field
-    QLineEdit *xField = new QLineEdit;
-    xField->setPlaceholderText("X");
-    xField->setFixedWidth(60);
-    xField->setValidator(validator);
-    xField->setText(QString::number(-50.0 + count * 30));
-    hLayout->addWidget(xField);
-
-    // Y Field
-    QLineEdit *yField = new QLineEdit;
-    yField->setPlaceholderText("Y");
-    yField->setFixedWidth(60);
-    yField->setValidator(validator);
-    yField->setText(QString::number(rand() % 40 - 20)); // Random Y for spread
-    hLayout->addWidget(yField);
-
-    // Z Field (NEW)
-    QLineEdit *zField = new QLineEdit;
-    zField->setPlaceholderText("Z");
-    zField->setFixedWidth(60);
-    zField->setValidator(validator);
-    zField->setText(QString::number(rand() % 40 - 20)); // Random Z for depth
-    hLayout->addWidget(zField);
-
-    // Remove Button
-    QPushButton *removeButton = new QPushButton("-");
-    removeButton->setFixedSize(20, 20);
-    connect(removeButton, &QPushButton::clicked, this, &MainWindow::removePointEntry);
-    hLayout->addWidget(removeButton);
-
-    hLayout->addStretch(1);
-
-    xFields.append(xField);
-    yFields.append(yField);
-    zFields.append(zField);
-    connectEntryFields(xField, yField, zField);
-    pointRows.append(widget);
-
-    return widget;
+    // Spread along X, random Y and Z for depth; the table row appears through the model
+    const int count = m_pointModel->count();
+    m_pointModel->appendPoint(QVector3D(-50.0 + count * 30, rand() % 40 - 20, rand() % 40 - 20));
 }
 
-void MainWindow::connectEntryFields(QLineEdit *xField, QLineEdit *yField, QLineEdit *zField)
+void MainWindow::removePointEntry()
 {
-    connect(xField, &QLineEdit::textEdited, this, &MainWindow::updateModelFromUI);
-    connect(yField, &QLineEdit::textEdited, this, &MainWindow::updateModelFromUI);
-    connect(zField, &QLineEdit::textEdited, this, &MainWindow::updateModelFromUI);
+    QModelIndexList selected = pointsTable->selectionModel()->selectedRows();
+    if (selected.isEmpty()) return;
+
+    // Back to front so the remaining indices stay valid, adjacent rows removed as
+    // one range, and the views told once
+    std::sort(selected.begin(), selected.end(),
+              [](const QModelIndex &a, const QModelIndex &b) { return a.row() > b.row(); });
+
+    m_pointModel->beginBatch();
+    int first = selected.first().row();
+    int end = first + 1;
+    for (qsizetype i = 1; i < selected.size(); ++i) {
+        const int row = selected[i].row();
+        if (row != first - 1) {
+            m_pointModel->removePoints(first, end - first);
+            end = row + 1;
+        }
+        first = row;
+    }
+    m_pointModel->removePoints(first, end - first);
+    m_pointModel->endBatch();
 }
 
-void MainWindow::addPointEntry()
+void MainWindow::populateScene(int curveCount)
 {
-    QWidget *row = createPointEntryWidget();
-    // Insert the new point entry before the stretch added earlier
-    pointsLayout->insertWidget(pointRows.size() - 1, row);
+    CurveScene &scene = drawingArea->scene();
+    const CurveType types[] = { CurveType::Bezier, CurveType::Hermite, CurveType::BSpline };
+
+    // Keep existing curves, only add or drop at the end
+    while (scene.curveCount() > curveCount) {
+        scene.removeCurve(scene.curveCount() - 1);
+    }
+    while (scene.curveCount() < curveCount) {
+        // Seeded per curve: curve i looks the same however the count got there
+        QRandomGenerator random(SCENE_SEED + static_cast<quint32>(scene.curveCount()));
+        QList<QVector3D> points;
+        QVector3D p(random.bounded(-800, 800), random.bounded(0, 200), random.bounded(-800, 800));
+        const int pointCount = random.bounded(4, 9);
+        for (int i = 0; i < pointCount; ++i) {
+            points.append(p);
+            p += QVector3D(random.bounded(-30, 30), random.bounded(-20, 20), random.bounded(-30, 30));
+        }
+        scene.addCurve(types[scene.curveCount() % 3], points);
+    }
 
-    // Renumbering P# labels is omitted for simplicity, but is recommended.
+    drawingArea->sceneChanged();
 }
 
-void MainWindow::removePointEntry()
+void MainWindow::populateSurface()
 {
-    QPushButton *button = qobject_cast<QPushButton*>(sender());
-    if (!button) return;
-
-    int index = -1;
-    for (int i = 0; i < pointRows.size(); ++i) {
-        if (pointRows[i] == button->parentWidget()) {
-            index = i;
-            break;
+    const int typeData = surfaceDropdown->currentData().toInt();
+    if (typeData < 0) {
+        m_surfaceModel->clear();
+        return;
+    }
+
+    // Rolling hills over a square of fixed size, whatever the patch count
+    const int patches = surfacePatchesSpinBox->value();
+    const float EXTENT = 800.0f;
+    const float HEIGHT = 40.0f;
+
+    ControlGrid grid;
+    grid.type = static_cast<SurfaceType>(typeData);
+    grid.rows = grid.type == SurfaceType::Bezier ? 3 * patches + 1 : patches + 3;
+    grid.columns = grid.rows;
+    grid.points.reserve(grid.rows * grid.columns);
+    const float spacing = EXTENT / (grid.columns - 1);
+    for (int row = 0; row < grid.rows; ++row) {
+        for (int column = 0; column < grid.columns; ++column) {
+            const float x = column * spacing - EXTENT / 2;
+            const float z = row * spacing - EXTENT / 2;
+            const float y = HEIGHT * std::sin(x / 60.0f) * std::cos(z / 80.0f) - HEIGHT;
+            grid.points.append(QVector3D(x, y, z));
         }
     }
 
-    if (index != -1) {
-        QWidget *rowWidget = pointRows.takeAt(index);
-        pointsLayout->removeWidget(rowWidget);
-        delete rowWidget;
+    if (m_surfaceModel->count() == 1) {
+        m_surfaceModel->setGrid(0, grid);
+    } else {
+        m_surfaceModel->clear();
+        m_surfaceModel->addGrid(grid);
+    }
+}
 
-        // Remove associated QLineEdits
-        xFields.removeAt(index);
-        yFields.removeAt(index);
-        zFields.removeAt(index);
+void MainWindow::openFile()
+{
+    const QString path = QFileDialog::getOpenFileName(this, "Open", QString(),
+        QString("Curve scenes (*.%1);;Point files (*.csv *.txt *.xyz *.ply);;All files (*)").arg(SceneFile::SUFFIX));
+    if (path.isEmpty()) return;
 
-        updateModelFromUI();
+    if (QFileInfo(path).suffix().compare(SceneFile::SUFFIX, Qt::CaseInsensitive) == 0) {
+        loadScene(path);
+        return;
     }
-}
 
+    // Imported points replace the current ones and show up chunk by chunk
+    m_pointModel->setControlPoints({});
+    statusBar()->showMessage(QString("Importing %1...").arg(QFileInfo(path).fileName()));
+    m_importer->start(path);
+}
 
-void MainWindow::updateModelFromUI()
+void MainWindow::loadScene(const QString &path)
 {
-    QList<QVector3D> newPoints;
+    QList<SceneCurve> curves;
+    QString error;
+    if (!SceneFile::load(path, curves, &error)) {
+        QMessageBox::warning(this, "Open Scene", QString("Could not open %1:\n%2").arg(path, error));
+        return;
+    }
+    if (curves.isEmpty()) return;
 
-    for (int i = 0; i < xFields.size(); ++i) {
-        bool xOk, yOk, zOk;
-        qreal x = xFields[i]->text().toDouble(&xOk);
-        qreal y = yFields[i]->text().toDouble(&yOk);
-        qreal z = zFields[i]->text().toDouble(&zOk);
+    m_importer->cancel();
 
-        if (xOk && yOk && zOk) {
-            newPoints.append(QVector3D(x, y, z));
-        }
+    // The first curve is the editable one, the rest form the background scene
+    const SceneCurve &edited = curves.first();
+    curveDropdown->setCurrentIndex(curveDropdown->findData(static_cast<int>(edited.type)));
+    m_pointModel->setControlPoints(edited.controlPoints);
+
+    CurveScene &scene = drawingArea->scene();
+    scene.clear();
+    for (qsizetype i = 1; i < curves.size(); ++i) {
+        scene.addCurve(curves[i].type, curves[i].controlPoints);
     }
+    drawingArea->sceneChanged();
 
-    m_pointModel->setControlPoints(newPoints);
+    sceneCurvesSpinBox->blockSignals(true);
+    sceneCurvesSpinBox->setMaximum(std::max<int>(sceneCurvesSpinBox->maximum(), scene.curveCount()));
+    sceneCurvesSpinBox->setValue(scene.curveCount());
+    sceneCurvesSpinBox->blockSignals(false);
+
+    statusBar()->showMessage(QString("Loaded %1 curves").arg(curves.size()), 5000);
 }
 
-void MainWindow::syncUIFromDrawingArea(const QList<QVector3D>& newPoints)
+void MainWindow::saveScene()
 {
-    m_pointModel->setControlPoints(newPoints);
+    QString path = QFileDialog::getSaveFileName(this, "Save Scene", QString(),
+                                                QString("Curve scenes (*.%1)").arg(SceneFile::SUFFIX));
+    if (path.isEmpty()) return;
+    if (QFileInfo(path).suffix().isEmpty()) {
+        path += QString(".") + SceneFile::SUFFIX;
+    }
 
-    for (int i = 0; i < newPoints.size(); ++i) {
-        if (i < xFields.size()) {
-            xFields[i]->blockSignals(true);
-            yFields[i]->blockSignals(true);
-            zFields[i]->blockSignals(true);
+    const CurveScene &scene = drawingArea->scene();
+    QList<SceneCurve> curves;
+    curves.reserve(scene.curveCount() + 1);
+    curves.append(SceneCurve{ static_cast<CurveType>(curveDropdown->currentData().toInt()), m_pointModel->controlPoints() });
+    for (qsizetype i = 0; i < scene.curveCount(); ++i) {
+        curves.append(SceneCurve{ scene.curveType(i), scene.curvePoints(i) });
+    }
 
-            xFields[i]->setText(QString::number(newPoints[i].x(), 'f', 1));
-            yFields[i]->setText(QString::number(newPoints[i].y(), 'f', 1));
-            zFields[i]->setText(QString::number(newPoints[i].z(), 'f', 1));
+    QString error;
+    if (!SceneFile::save(path, std::span<const SceneCurve>(curves.constData(), static_cast<size_t>(curves.size())), &error)) {
+        QMessageBox::warning(this, "Save Scene", QString("Could not save %1:\n%2").arg(path, error));
+        return;
+    }
+    statusBar()->showMessage(QString("Saved %1 curves").arg(curves.size()), 5000);
+}
 
-            xFields[i]->blockSignals(false);
-            yFields[i]->blockSignals(false);
-            zFields[i]->blockSignals(false);
-        }
+void MainWindow::exportProfilerTrace()
+{
+    if (drawingArea->profiler().currentFrame() == 0) {
+        QMessageBox::information(this, "Export Profiler Trace", "Enable the profiler overlay to record frames first.");
+        return;
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, "Export Profiler Trace", QString(),
+                                                "Chrome trace (*.json)");
+    if (path.isEmpty()) return;
+    if (QFileInfo(path).suffix().isEmpty()) {
+        path += ".json";
+    }
+
+    QString error;
+    if (!drawingArea->exportProfilerTrace(path, &error)) {
+        QMessageBox::warning(this, "Export Profiler Trace", QString("Could not write %1:\n%2").arg(path, error));
+        return;
+    }
+    statusBar()->showMessage(QString("Exported profiler trace to %1").arg(path), 5000);
+}
+
+void MainWindow::importChunk(const QList<QVector3D> &points)
+{
+    m_pointModel->insertPoints(m_pointModel->count(), points);
+}
+
+void MainWindow::importFinished(bool ok, const QString &errorString)
+{
+    if (ok) {
+        statusBar()->showMessage(QString("Imported %1 points").arg(m_pointModel->count()), 5000);
+    } else {
+        statusBar()->clearMessage();
+        QMessageBox::warning(this, "Import", errorString);
     }
 }
 
 void MainWindow::handleCurveSelection(int index)
 {
-    QString type = curveDropdown->itemText(index);
-    drawingArea->setCurrentCurveType(type);
-    updateModelFromUI();
+    CurveType type = static_cast<CurveType>(curveDropdown->itemData(index).toInt());
+    drawingArea->setCurveType(type);
+    degreeSpinBox->setEnabled(type == CurveType::BSpline);
 }
\ No newline at end of file
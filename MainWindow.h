@@ -13,14 +13,20 @@
 #include <QComboBox>
 #include <QPushButton>
 #include <QVBoxLayout>
-#include <QScrollArea>
-#include <QLineEdit>
+#include <QTableView>
 #include <QVector3D>
 #include <QDockWidget>
+#include <QCheckBox>
+#include <QLabel>
+#include <QSpinBox>
+#include <QDoubleSpinBox>
 
 // Forward Declarations
 class DrawingArea;
 class PointModel;
+class PointImporter;
+class PointTableModel;
+class SurfaceModel;
 
 class MainWindow : public QMainWindow
 {
@@ -33,28 +39,45 @@ public:
 private slots:
     void addPointEntry();
     void removePointEntry();
-    void updateModelFromUI();
     void handleCurveSelection(int index);
-    void syncUIFromDrawingArea(const QList<QVector3D>& newPoints);
+    void populateScene(int curveCount);
+    void populateSurface();
+    void openFile();
+    void saveScene();
+    void exportProfilerTrace();
+    void importChunk(const QList<QVector3D> &points);
+    void importFinished(bool ok, const QString &errorString);
 
 private:
     PointModel *m_pointModel;
+    PointTableModel *m_pointTableModel;
+    PointImporter *m_importer;
+    SurfaceModel *m_surfaceModel;
     DrawingArea *drawingArea;
 
     QComboBox *curveDropdown;
+    QSpinBox *degreeSpinBox;
+    QCheckBox *adaptiveCheckBox;
+    QDoubleSpinBox *toleranceSpinBox;
+    QCheckBox *proceduralGridCheckBox;
+    QCheckBox *profilerCheckBox;
+    QCheckBox *levelOfDetailCheckBox;
+    QCheckBox *gpuEvaluationCheckBox;
+    QLabel *vertexCountLabel;
+    QLabel *curveLengthLabel;
+    QSpinBox *sceneCurvesSpinBox;
+    QComboBox *surfaceDropdown;
+    QSpinBox *surfacePatchesSpinBox;
     QPushButton *addPointButton;
-    QScrollArea *scrollArea;
-    QWidget *pointsContainer;
-    QVBoxLayout *pointsLayout;
+    QPushButton *removePointButton;
+    QTableView *pointsTable;
 
-    QList<QLineEdit*> xFields;
-    QList<QLineEdit*> yFields;
-    QList<QLineEdit*> zFields; // NEW
-    QList<QWidget*> pointRows;
+    // Fixed seed keeps generated scenes the same from run to run
+    static constexpr quint32 SCENE_SEED = 2;
 
+    void createFileMenu();
     QDockWidget* createControlPanel();
-    QWidget* createPointEntryWidget();
-    void connectEntryFields(QLineEdit *xField, QLineEdit *yField, QLineEdit *zField);
+    void loadScene(const QString &path);
 };
 
 #endif // MAINWINDOW_H
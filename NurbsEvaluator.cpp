@@ -0,0 +1,202 @@
+//
+// NurbsEvaluator.cpp
+//
+
+#include "NurbsEvaluator.h"
+
+#include <algorithm>
+
+bool NurbsCurve::isValid() const
+{
+    const qsizetype n = controlPoints.size();
+    if (degree < 1 || n < degree + 1 || knots.size() != n + degree + 1) return false;
+    if (!weights.isEmpty() && weights.size() != n) return false;
+
+    for (qsizetype i = 1; i < knots.size(); ++i) {
+        if (knots[i] < knots[i - 1]) return false;
+    }
+    for (qreal w : weights) {
+        if (!(w > 0.0)) return false;
+    }
+    // Empty domain: nothing to evaluate
+    return knots[n] > knots[degree];
+}
+
+QList<qreal> NurbsCurve::uniformKnots(qsizetype pointCount, int degree)
+{
+    QList<qreal> knots(pointCount + degree + 1);
+    for (qsizetype i = 0; i < knots.size(); ++i) {
+        knots[i] = static_cast<qreal>(i);
+    }
+    return knots;
+}
+
+QList<qreal> NurbsCurve::clampedUniformKnots(qsizetype pointCount, int degree)
+{
+    QList<qreal> knots(pointCount + degree + 1);
+    const qsizetype spans = std::max<qsizetype>(pointCount - degree, 1);
+    for (qsizetype i = 0; i < knots.size(); ++i) {
+        knots[i] = static_cast<qreal>(std::clamp<qsizetype>(i - degree, 0, spans)) / spans;
+    }
+    return knots;
+}
+
+NurbsEvaluator::NurbsEvaluator(const NurbsCurve& curve)
+    : m_degree(curve.degree), m_valid(curve.isValid()), m_rational(curve.isRational())
+{
+    if (!m_valid) return;
+
+    m_knots = QVector<qreal>(curve.knots.cbegin(), curve.knots.cend());
+    m_homogeneous.reserve(curve.controlPoints.size());
+    for (qsizetype i = 0; i < curve.controlPoints.size(); ++i) {
+        const float w = m_rational ? static_cast<float>(curve.weights[i]) : 1.0f;
+        m_homogeneous.append(QVector4D(curve.controlPoints[i] * w, w));
+    }
+
+    m_basis.resize(m_degree + 1);
+    m_left.resize(m_degree + 1);
+    m_right.resize(m_degree + 1);
+}
+
+void NurbsEvaluator::setControlPoints(std::span<const QVector3D> controlPoints)
+{
+    Q_ASSERT(static_cast<qsizetype>(controlPoints.size()) == m_homogeneous.size());
+    for (qsizetype i = 0; i < m_homogeneous.size(); ++i) {
+        const float w = m_homogeneous[i].w();
+        m_homogeneous[i] = QVector4D(controlPoints[i] * w, w);
+    }
+}
+
+qreal NurbsEvaluator::domainStart() const
+{
+    return m_valid ? m_knots[m_degree] : 0.0;
+}
+
+qreal NurbsEvaluator::domainEnd() const
+{
+    return m_valid ? m_knots[m_homogeneous.size()] : 0.0;
+}
+
+qsizetype NurbsEvaluator::findSpan(qreal u)
+{
+    const qsizetype n = m_homogeneous.size();
+
+    // The domain end belongs to the last non-empty span
+    if (u >= m_knots[n]) {
+        qsizetype span = n - 1;
+        while (span > m_degree && m_knots[span] == m_knots[span + 1]) --span;
+        return m_spanHint = span;
+    }
+    if (u <= m_knots[m_degree]) {
+        qsizetype span = m_degree;
+        while (span < n - 1 && m_knots[span + 1] <= u) ++span;
+        return m_spanHint = span;
+    }
+
+    // Sweeps stay in the same span or move to the next one
+    if (m_spanHint >= m_degree && m_spanHint < n) {
+        if (m_knots[m_spanHint] <= u && u < m_knots[m_spanHint + 1]) return m_spanHint;
+        if (m_spanHint + 1 < n && m_knots[m_spanHint + 1] <= u && u < m_knots[m_spanHint + 2]) {
+            return ++m_spanHint;
+        }
+    }
+
+    // knots[span] <= u < knots[span + 1]
+    const auto it = std::upper_bound(m_knots.cbegin() + m_degree, m_knots.cbegin() + n + 1, u);
+    return m_spanHint = static_cast<qsizetype>(it - m_knots.cbegin()) - 1;
+}
+
+void NurbsEvaluator::basisFunctions(qsizetype span, qreal u)
+{
+    // Cox-de Boor triangle: the degree + 1 functions non-zero on this span
+    m_basis[0] = 1.0;
+    for (int j = 1; j <= m_degree; ++j) {
+        m_left[j] = u - m_knots[span + 1 - j];
+        m_right[j] = m_knots[span + j] - u;
+
+        qreal saved = 0.0;
+        for (int r = 0; r < j; ++r) {
+            const qreal temp = m_basis[r] / (m_right[r + 1] + m_left[j - r]);
+            m_basis[r] = saved + m_right[r + 1] * temp;
+            saved = m_left[j - r] * temp;
+        }
+        m_basis[j] = saved;
+    }
+}
+
+void NurbsEvaluator::accumulate(qsizetype span, qreal u, qreal sum[4])
+{
+    basisFunctions(span, u);
+
+    sum[0] = sum[1] = sum[2] = sum[3] = 0.0;
+    const QVector4D* points = m_homogeneous.constData() + span - m_degree;
+    for (int i = 0; i <= m_degree; ++i) {
+        sum[0] += m_basis[i] * points[i].x();
+        sum[1] += m_basis[i] * points[i].y();
+        sum[2] += m_basis[i] * points[i].z();
+        sum[3] += m_basis[i] * points[i].w();
+    }
+}
+
+QVector4D NurbsEvaluator::homogeneousPoint(qreal u)
+{
+    if (!m_valid) return QVector4D();
+
+    qreal sum[4];
+    accumulate(findSpan(u), u, sum);
+    return QVector4D(sum[0], sum[1], sum[2], sum[3]);
+}
+
+QVector3D NurbsEvaluator::spanPoint(qsizetype span, qreal u)
+{
+    qreal sum[4];
+    accumulate(span, u, sum);
+
+    // Non-rational: the weights sum to 1 (partition of unity), no divide needed
+    if (!m_rational) return QVector3D(sum[0], sum[1], sum[2]);
+    return QVector3D(sum[0] / sum[3], sum[1] / sum[3], sum[2] / sum[3]);
+}
+
+QVector3D NurbsEvaluator::point(qreal u)
+{
+    if (!m_valid) return QVector3D();
+    return spanPoint(findSpan(u), u);
+}
+
+qsizetype NurbsEvaluator::tessellate(QVector<QVector3D>& out, int samplesPerSpan)
+{
+    if (!m_valid || samplesPerSpan < 1) return 0;
+
+    const qsizetype n = m_homogeneous.size();
+    const qsizetype oldSize = out.size();
+    bool first = true;
+
+    for (qsizetype span = m_degree; span < n; ++span) {
+        const qreal a = m_knots[span];
+        const qreal b = m_knots[span + 1];
+        if (!(b > a)) continue;
+
+        // Consecutive spans share their joint, keep it only once
+        for (int i = first ? 0 : 1; i <= samplesPerSpan; ++i) {
+            const qreal u = (i == samplesPerSpan) ? b : a + (b - a) * i / samplesPerSpan;
+            out.append(spanPoint(span, u));
+        }
+        first = false;
+    }
+    m_spanHint = n - 1;
+    return out.size() - oldSize;
+}
+
+void NurbsEvaluator::tessellateSpan(qsizetype span, std::span<QVector3D> out, int samplesPerSpan)
+{
+    Q_ASSERT(m_valid && span >= m_degree && span < m_homogeneous.size());
+    Q_ASSERT(static_cast<qsizetype>(out.size()) >= samplesPerSpan + 1);
+
+    const qreal a = m_knots[span];
+    const qreal b = m_knots[span + 1];
+    for (int i = 0; i <= samplesPerSpan; ++i) {
+        const qreal u = (i == samplesPerSpan) ? b : a + (b - a) * i / samplesPerSpan;
+        out[i] = spanPoint(span, u);
+    }
+    m_spanHint = span;
+}
@@ -0,0 +1,85 @@
+//
+// NurbsEvaluator.h
+//
+
+#ifndef CURVES3D_NURBSEVALUATOR_H
+#define CURVES3D_NURBSEVALUATOR_H
+
+#include "CurveCalculator.h"
+
+#include <QVarLengthArray>
+#include <QVector4D>
+
+// B-spline of any degree with an arbitrary (non-decreasing) knot vector and
+// optional rational weights, i.e. a NURBS curve as exported by CAD tools.
+struct NurbsCurve
+{
+    int degree = 3;
+    QList<QVector3D> controlPoints;
+    QList<qreal> weights;  // One per control point; empty means all 1 (non-rational)
+    QList<qreal> knots;    // controlPoints.size() + degree + 1 values
+
+    bool isRational() const { return !weights.isEmpty(); }
+    bool isValid() const;
+
+    // 0, 1, 2, ...: the curve starts and ends inside the control polygon
+    static QList<qreal> uniformKnots(qsizetype pointCount, int degree);
+    // degree + 1 repeated end knots: the curve interpolates the end points
+    static QList<qreal> clampedUniformKnots(qsizetype pointCount, int degree);
+};
+
+// de Boor / Cox-de Boor evaluation of one NurbsCurve. The knot span of the
+// previous sample is kept and tried first, so sweeping the parameter is O(1)
+// per span lookup instead of a binary search; the basis-function scratch is
+// sized once per evaluator and reused by every sample. Rational curves are
+// summed as homogeneous 4D points (w*P, w) and divided once per sample.
+// Not thread-safe: use one evaluator per thread.
+class NurbsEvaluator
+{
+public:
+    explicit NurbsEvaluator(const NurbsCurve& curve);
+
+    bool isValid() const { return m_valid; }
+    int degree() const { return m_degree; }
+
+    // Swaps in new control points, same count, keeping knots and weights; lets
+    // one evaluator serve many curves of the same shape without reallocating
+    void setControlPoints(std::span<const QVector3D> controlPoints);
+
+    // Parameter domain [knots[degree], knots[n]]
+    qreal domainStart() const;
+    qreal domainEnd() const;
+
+    QVector3D point(qreal u);
+
+    // Homogeneous point (w*P, w); w is 1 for non-rational curves
+    QVector4D homogeneousPoint(qreal u);
+
+    // Appends samplesPerSpan + 1 samples per non-empty knot span, joints kept
+    // once, and returns the number of vertices appended
+    qsizetype tessellate(QVector<QVector3D>& out, int samplesPerSpan = CurveCalculator::CURVE_DETAIL);
+
+    // Writes samplesPerSpan + 1 samples of knot span [knots[span], knots[span + 1]],
+    // both ends included, with the same parameters as tessellate()
+    void tessellateSpan(qsizetype span, std::span<QVector3D> out, int samplesPerSpan = CurveCalculator::CURVE_DETAIL);
+
+private:
+    qsizetype findSpan(qreal u);
+    void basisFunctions(qsizetype span, qreal u);
+    void accumulate(qsizetype span, qreal u, qreal sum[4]);
+    QVector3D spanPoint(qsizetype span, qreal u);
+
+    int m_degree = 0;
+    bool m_valid = false;
+    bool m_rational = false;
+    QVector<qreal> m_knots;
+    QVector<QVector4D> m_homogeneous; // (w*P, w) per control point
+
+    // Reused between samples
+    qsizetype m_spanHint = -1;
+    QVarLengthArray<qreal, 8> m_basis;
+    QVarLengthArray<qreal, 8> m_left;
+    QVarLengthArray<qreal, 8> m_right;
+};
+
+#endif //CURVES3D_NURBSEVALUATOR_H
@@ -0,0 +1,136 @@
+//
+// OffscreenRenderer.cpp
+//
+
+#include "OffscreenRenderer.h"
+
+#include <QElapsedTimer>
+#include <QOpenGLFunctions>
+
+namespace {
+
+constexpr int FRAMEBUFFER_SAMPLES = 4;
+
+bool fail(QString* errorString, const QString& message)
+{
+    if (errorString) *errorString = message;
+    return false;
+}
+
+}
+
+OffscreenRenderer::~OffscreenRenderer()
+{
+    // GL objects must be released with their context current
+    if (m_context.isValid() && m_context.makeCurrent(&m_surface)) {
+        m_renderer.destroy();
+        m_framebuffer.reset();
+        m_context.doneCurrent();
+    }
+}
+
+bool OffscreenRenderer::create(const QSize& size, QString* errorString)
+{
+    const QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    m_surface.setFormat(format);
+    m_surface.create();
+    if (!m_surface.isValid()) {
+        return fail(errorString, "Could not create an offscreen surface");
+    }
+
+    m_context.setFormat(format);
+    if (!m_context.create() || !m_context.makeCurrent(&m_surface)) {
+        return fail(errorString, "Could not create an OpenGL context");
+    }
+    if (!QOpenGLFramebufferObject::hasOpenGLFramebufferObjects()) {
+        return fail(errorString, "Framebuffer objects are not supported");
+    }
+
+    QOpenGLFramebufferObjectFormat framebufferFormat;
+    framebufferFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+    framebufferFormat.setSamples(FRAMEBUFFER_SAMPLES);
+    m_framebuffer = std::make_unique<QOpenGLFramebufferObject>(size, framebufferFormat);
+    if (!m_framebuffer->isValid()) {
+        return fail(errorString, "Could not create a framebuffer");
+    }
+
+    m_initialized = m_renderer.initialize(&m_context);
+    if (!m_initialized) {
+        return fail(errorString, "Could not build the shaders");
+    }
+    return true;
+}
+
+QString OffscreenRenderer::rendererName()
+{
+    if (!m_context.makeCurrent(&m_surface)) return QString();
+    return QString::fromLatin1(reinterpret_cast<const char*>(m_context.functions()->glGetString(GL_RENDERER)));
+}
+
+void OffscreenRenderer::setScene(const QList<SceneCurve>& curves)
+{
+    m_scene.clear();
+    if (curves.isEmpty()) {
+        m_curve.setControlPoints({});
+    } else {
+        m_curve.setType(curves.first().type);
+        m_curve.setControlPoints(curves.first().controlPoints);
+        for (qsizetype i = 1; i < curves.size(); ++i) {
+            m_scene.addCurve(curves[i].type, curves[i].controlPoints);
+        }
+    }
+    m_uploadPending = true;
+}
+
+void OffscreenRenderer::renderFrame()
+{
+    m_context.makeCurrent(&m_surface);
+    m_framebuffer->bind();
+    m_renderer.setViewport(m_framebuffer->size());
+
+    // Before the uploads: the renderer copies points for the Bézier program only while it is in use
+    m_renderer.setGpuCurve(m_gpuEvaluation && m_renderer.supportsGpuCurve(m_curve.type(), m_curve.controlPoints().size()),
+                           m_curve.type());
+    if (m_uploadPending) {
+        const QList<QVector3D>& points = m_curve.controlPoints();
+        m_renderer.updateCurve(m_curve.type(), m_curve.vertices(), m_curve.takeDirtyVertices(),
+                               m_curve.segmentBounds(), m_curve.takeDirtyBounds(), m_curve.takeLayoutChanged());
+        m_renderer.updatePoints(points, { 0, points.size() }, true);
+        m_renderer.updatePointStates(QVector<quint8>(points.size(), SceneRenderer::PointNormal), { 0, points.size() }, true);
+        m_uploadPending = false;
+    }
+    // Headless rendering waits for its frames anyway, so the scene is tessellated in place
+    m_scene.update();
+    m_renderer.updateScene(m_scene.geometry(), m_scene.takeDirtyVertices(), m_scene.takeDirtyBounds(),
+                           m_scene.takeLayoutChanged());
+
+    m_renderer.render(m_camera.projectionMatrix(m_framebuffer->size()), m_camera.viewMatrix(), m_proceduralGrid);
+}
+
+QImage OffscreenRenderer::renderImage()
+{
+    if (!m_initialized) return QImage();
+
+    renderFrame();
+    // Resolves the multisampled framebuffer
+    return m_framebuffer->toImage();
+}
+
+QVector<double> OffscreenRenderer::timeFrames(int frameCount)
+{
+    QVector<double> times;
+    if (!m_initialized) return times;
+
+    renderFrame();
+    m_context.functions()->glFinish();
+
+    times.reserve(frameCount);
+    QElapsedTimer timer;
+    for (int i = 0; i < frameCount; ++i) {
+        timer.start();
+        renderFrame();
+        m_context.functions()->glFinish();
+        times.append(timer.nsecsElapsed() / 1.0e6);
+    }
+    return times;
+}
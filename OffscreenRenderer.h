@@ -0,0 +1,66 @@
+//
+// OffscreenRenderer.h
+//
+
+#ifndef CURVES3D_OFFSCREENRENDERER_H
+#define CURVES3D_OFFSCREENRENDERER_H
+
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+
+#include <memory>
+
+#include "CurveCache.h"
+#include "CurveScene.h"
+#include "SceneFile.h"
+#include "SceneRenderer.h"
+
+// Renders scenes without a window: a QOffscreenSurface keeps a context
+// current and SceneRenderer draws into a framebuffer object, exactly as
+// DrawingArea does on screen. Works on any platform plugin that provides
+// OpenGL, including "offscreen" with Mesa's software rasterizer.
+class OffscreenRenderer
+{
+public:
+    OffscreenRenderer() = default;
+    ~OffscreenRenderer();
+
+    // Needs a QGuiApplication; size is the image size in pixels
+    bool create(const QSize& size, QString* errorString = nullptr);
+    // GL_RENDERER of the context, e.g. to confirm a software rasterizer
+    QString rendererName();
+
+    // Like the viewer: the first curve is drawn with its control points, the rest as the scene
+    void setScene(const QList<SceneCurve>& curves);
+    void setCamera(const SceneCamera& camera) { m_camera = camera; }
+    void setProceduralGrid(bool enabled) { m_proceduralGrid = enabled; }
+    // Evaluates the edited curve in the vertex shader where supported, as DrawingArea can
+    void setGpuEvaluation(bool enabled) { m_gpuEvaluation = enabled; m_uploadPending = true; }
+
+    QImage renderImage();
+    // Milliseconds per frame for frameCount frames, each waited on with glFinish();
+    // an untimed first frame does the uploads
+    QVector<double> timeFrames(int frameCount);
+
+private:
+    void renderFrame();
+
+    QOpenGLContext m_context;
+    QOffscreenSurface m_surface;
+    std::unique_ptr<QOpenGLFramebufferObject> m_framebuffer;
+    SceneRenderer m_renderer;
+    bool m_initialized = false;
+
+    SceneCamera m_camera;
+    bool m_proceduralGrid = false;
+    bool m_gpuEvaluation = false;
+
+    // Evaluated on the calling thread: there is no interaction to keep responsive
+    CurveCache m_curve;
+    CurveScene m_scene;
+    bool m_uploadPending = true;
+};
+
+#endif //CURVES3D_OFFSCREENRENDERER_H
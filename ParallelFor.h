@@ -0,0 +1,52 @@
+//
+// ParallelFor.h
+//
+
+#ifndef CURVES3D_PARALLELFOR_H
+#define CURVES3D_PARALLELFOR_H
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Runs body(i) for i in [0, count) on up to threadCount threads (0 = one per
+// hardware thread), with at least threshold items per extra thread, since
+// below that a thread costs more to start than it saves. Each thread takes
+// one contiguous chunk and the calling thread takes the first one.
+template <typename Body>
+void parallelFor(qsizetype count, qsizetype threshold, int threadCount, const Body& body)
+{
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    threadCount = static_cast<int>(std::min<qsizetype>(threadCount, count / threshold + 1));
+
+    auto run = [&body](qsizetype first, qsizetype last) {
+        for (qsizetype i = first; i < last; ++i) {
+            body(i);
+        }
+    };
+
+    if (threadCount <= 1) {
+        run(0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(threadCount - 1));
+    const qsizetype chunk = (count + threadCount - 1) / threadCount;
+    for (int k = 1; k < threadCount; ++k) {
+        const qsizetype first = std::min(count, k * chunk);
+        const qsizetype last = std::min(count, first + chunk);
+        threads.emplace_back(run, first, last);
+    }
+    run(0, std::min(count, chunk));
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+#endif //CURVES3D_PARALLELFOR_H
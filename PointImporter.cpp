@@ -0,0 +1,506 @@
+//
+// PointImporter.cpp
+//
+
+#include "PointImporter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QThread>
+#include <QtEndian>
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+constexpr qint64 READ_BLOCK_BYTES = 1 << 20;
+
+bool fail(QString* errorString, const QString& message)
+{
+    if (errorString) *errorString = message;
+    return false;
+}
+
+bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+// Parses the next number in [*cursor, end), skipping separators first
+bool parseNumber(const char*& cursor, const char* end, float& value)
+{
+    while (cursor < end && isSeparator(*cursor)) ++cursor;
+    if (cursor < end && *cursor == '+') ++cursor;
+
+    double number = 0.0;
+    const std::from_chars_result result = std::from_chars(cursor, end, number);
+    if (result.ec != std::errc()) return false;
+
+    cursor = result.ptr;
+    value = static_cast<float>(number);
+    return true;
+}
+
+enum class LineKind
+{
+    Blank,
+    Point,
+    Invalid
+};
+
+LineKind parsePointLine(const char* begin, const char* end, QVector3D& point)
+{
+    while (begin < end && isSeparator(*begin)) ++begin;
+    if (begin == end || *begin == '#') return LineKind::Blank;
+
+    float x, y, z;
+    if (!parseNumber(begin, end, x) || !parseNumber(begin, end, y) || !parseNumber(begin, end, z)) {
+        return LineKind::Invalid;
+    }
+    point = QVector3D(x, y, z);
+    return LineKind::Point;
+}
+
+// Collects points and hands them over CHUNK_POINTS at a time
+class ChunkBuffer
+{
+public:
+    explicit ChunkBuffer(const PointImporter::ChunkHandler& onChunk) : m_onChunk(onChunk)
+    {
+        m_points.reserve(PointImporter::CHUNK_POINTS);
+    }
+
+    bool append(const QVector3D& point)
+    {
+        m_points.append(point);
+        return m_points.size() < PointImporter::CHUNK_POINTS || flush();
+    }
+
+    bool flush()
+    {
+        if (m_points.isEmpty()) return true;
+        const bool keepGoing = m_onChunk(m_points);
+        m_points = QList<QVector3D>();
+        m_points.reserve(PointImporter::CHUNK_POINTS);
+        return keepGoing;
+    }
+
+private:
+    const PointImporter::ChunkHandler& m_onChunk;
+    QList<QVector3D> m_points;
+};
+
+bool readCsv(QIODevice& device, const PointImporter::ChunkHandler& onChunk, QString* errorString)
+{
+    ChunkBuffer chunk(onChunk);
+    QByteArray pending;
+    qint64 lineNumber = 0;
+    bool seenPoint = false;
+
+    forever {
+        const QByteArray block = device.read(READ_BLOCK_BYTES);
+        const bool atEnd = block.isEmpty();
+        pending.append(block);
+
+        qsizetype start = 0;
+        while (start < pending.size()) {
+            qsizetype newline = pending.indexOf('\n', start);
+            if (newline < 0) {
+                // A partial line waits for the next block, unless there is none
+                if (!atEnd) break;
+                newline = pending.size();
+            }
+            ++lineNumber;
+
+            QVector3D point;
+            switch (parsePointLine(pending.constData() + start, pending.constData() + newline, point)) {
+            case LineKind::Blank:
+                break;
+            case LineKind::Point:
+                seenPoint = true;
+                if (!chunk.append(point)) {
+                    return fail(errorString, QStringLiteral("Import cancelled"));
+                }
+                break;
+            case LineKind::Invalid:
+                // Column titles before the first point are fine, garbage after it is not
+                if (seenPoint) {
+                    return fail(errorString, QStringLiteral("Line %1 is not an x, y, z point").arg(lineNumber));
+                }
+                break;
+            }
+            start = newline + 1;
+        }
+        pending.remove(0, std::min(start, pending.size()));
+
+        if (atEnd) break;
+    }
+
+    if (!chunk.flush()) {
+        return fail(errorString, QStringLiteral("Import cancelled"));
+    }
+    return true;
+}
+
+// --- PLY ---
+
+enum class PlyType
+{
+    Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64, Invalid
+};
+
+PlyType plyType(const QByteArray& name)
+{
+    if (name == "char" || name == "int8") return PlyType::Int8;
+    if (name == "uchar" || name == "uint8") return PlyType::UInt8;
+    if (name == "short" || name == "int16") return PlyType::Int16;
+    if (name == "ushort" || name == "uint16") return PlyType::UInt16;
+    if (name == "int" || name == "int32") return PlyType::Int32;
+    if (name == "uint" || name == "uint32") return PlyType::UInt32;
+    if (name == "float" || name == "float32") return PlyType::Float32;
+    if (name == "double" || name == "float64") return PlyType::Float64;
+    return PlyType::Invalid;
+}
+
+int plyTypeSize(PlyType type)
+{
+    switch (type) {
+    case PlyType::Int8:
+    case PlyType::UInt8:
+        return 1;
+    case PlyType::Int16:
+    case PlyType::UInt16:
+        return 2;
+    case PlyType::Int32:
+    case PlyType::UInt32:
+    case PlyType::Float32:
+        return 4;
+    case PlyType::Float64:
+        return 8;
+    case PlyType::Invalid:
+        break;
+    }
+    return 0;
+}
+
+template <typename T>
+T fromEndian(const uchar* data, bool bigEndian)
+{
+    return bigEndian ? qFromBigEndian<T>(data) : qFromLittleEndian<T>(data);
+}
+
+double decodePly(const uchar* data, PlyType type, bool bigEndian)
+{
+    switch (type) {
+    case PlyType::Int8: return static_cast<qint8>(data[0]);
+    case PlyType::UInt8: return data[0];
+    case PlyType::Int16: return fromEndian<qint16>(data, bigEndian);
+    case PlyType::UInt16: return fromEndian<quint16>(data, bigEndian);
+    case PlyType::Int32: return fromEndian<qint32>(data, bigEndian);
+    case PlyType::UInt32: return fromEndian<quint32>(data, bigEndian);
+    case PlyType::Float32: return fromEndian<float>(data, bigEndian);
+    case PlyType::Float64: return fromEndian<double>(data, bigEndian);
+    case PlyType::Invalid: break;
+    }
+    return 0.0;
+}
+
+struct PlyProperty
+{
+    QByteArray name;
+    PlyType type = PlyType::Invalid;
+    bool isList = false;
+    PlyType countType = PlyType::Invalid;
+};
+
+struct PlyElement
+{
+    QByteArray name;
+    qint64 count = 0;
+    QList<PlyProperty> properties;
+
+    bool hasLists() const
+    {
+        return std::any_of(properties.cbegin(), properties.cend(), [](const PlyProperty& p) { return p.isList; });
+    }
+};
+
+enum class PlyFormat
+{
+    Ascii,
+    BinaryLittleEndian,
+    BinaryBigEndian
+};
+
+bool readPlyHeader(QIODevice& device, PlyFormat& format, QList<PlyElement>& elements, QString* errorString)
+{
+    if (device.readLine().trimmed() != "ply") {
+        return fail(errorString, QStringLiteral("Not a PLY file"));
+    }
+
+    bool hasFormat = false;
+    forever {
+        if (device.atEnd()) {
+            return fail(errorString, QStringLiteral("PLY header has no end_header"));
+        }
+        const QList<QByteArray> words = device.readLine().simplified().split(' ');
+        const QByteArray& keyword = words.first();
+
+        if (keyword == "end_header") break;
+        if (keyword == "format" && words.size() >= 2) {
+            if (words[1] == "ascii") format = PlyFormat::Ascii;
+            else if (words[1] == "binary_little_endian") format = PlyFormat::BinaryLittleEndian;
+            else if (words[1] == "binary_big_endian") format = PlyFormat::BinaryBigEndian;
+            else return fail(errorString, QStringLiteral("Unknown PLY format %1").arg(QString::fromLatin1(words[1])));
+            hasFormat = true;
+        } else if (keyword == "element" && words.size() >= 3) {
+            PlyElement element;
+            element.name = words[1];
+            element.count = words[2].toLongLong();
+            elements.append(element);
+        } else if (keyword == "property" && !elements.isEmpty()) {
+            PlyProperty property;
+            if (words.size() >= 5 && words[1] == "list") {
+                property.isList = true;
+                property.countType = plyType(words[2]);
+                property.type = plyType(words[3]);
+                property.name = words[4];
+            } else if (words.size() >= 3) {
+                property.type = plyType(words[1]);
+                property.name = words[2];
+            }
+            if (property.type == PlyType::Invalid || (property.isList && property.countType == PlyType::Invalid)) {
+                return fail(errorString, QStringLiteral("Unsupported PLY property: %1")
+                                             .arg(QString::fromLatin1(words.join(' '))));
+            }
+            elements.last().properties.append(property);
+        }
+        // comment, obj_info and unknown lines carry nothing we need
+    }
+
+    if (!hasFormat) {
+        return fail(errorString, QStringLiteral("PLY header has no format line"));
+    }
+    return true;
+}
+
+// Steps over the records of an element that precedes the vertices
+bool skipPlyElement(QIODevice& device, PlyFormat format, const PlyElement& element)
+{
+    if (format == PlyFormat::Ascii) {
+        for (qint64 i = 0; i < element.count; ++i) {
+            if (device.readLine().isEmpty() && device.atEnd()) return false;
+        }
+        return true;
+    }
+
+    const bool bigEndian = format == PlyFormat::BinaryBigEndian;
+    if (!element.hasLists()) {
+        qint64 stride = 0;
+        for (const PlyProperty& property : element.properties) {
+            stride += plyTypeSize(property.type);
+        }
+        return device.skip(stride * element.count) == stride * element.count;
+    }
+
+    for (qint64 i = 0; i < element.count; ++i) {
+        for (const PlyProperty& property : element.properties) {
+            qint64 bytes = plyTypeSize(property.type);
+            if (property.isList) {
+                uchar count[8];
+                const int countSize = plyTypeSize(property.countType);
+                if (device.read(reinterpret_cast<char*>(count), countSize) != countSize) return false;
+                bytes *= static_cast<qint64>(decodePly(count, property.countType, bigEndian));
+            }
+            if (device.skip(bytes) != bytes) return false;
+        }
+    }
+    return true;
+}
+
+bool readPly(QIODevice& device, const PointImporter::ChunkHandler& onChunk, QString* errorString)
+{
+    PlyFormat format = PlyFormat::Ascii;
+    QList<PlyElement> elements;
+    if (!readPlyHeader(device, format, elements, errorString)) return false;
+
+    for (const PlyElement& element : elements) {
+        if (element.name != "vertex") {
+            if (!skipPlyElement(device, format, element)) {
+                return fail(errorString, QStringLiteral("PLY element %1 is truncated").arg(QString::fromLatin1(element.name)));
+            }
+            continue;
+        }
+
+        if (element.hasLists()) {
+            return fail(errorString, QStringLiteral("PLY vertices with list properties are not supported"));
+        }
+
+        int columns[3] = { -1, -1, -1 };
+        int offsets[3] = { 0, 0, 0 };
+        PlyType types[3] = { PlyType::Invalid, PlyType::Invalid, PlyType::Invalid };
+        int stride = 0;
+        for (int i = 0; i < element.properties.size(); ++i) {
+            const PlyProperty& property = element.properties[i];
+            const int axis = property.name == "x" ? 0 : property.name == "y" ? 1 : property.name == "z" ? 2 : -1;
+            if (axis >= 0) {
+                columns[axis] = i;
+                offsets[axis] = stride;
+                types[axis] = property.type;
+            }
+            stride += plyTypeSize(property.type);
+        }
+        if (columns[0] < 0 || columns[1] < 0 || columns[2] < 0) {
+            return fail(errorString, QStringLiteral("PLY vertices have no x, y, z properties"));
+        }
+
+        ChunkBuffer chunk(onChunk);
+
+        if (format == PlyFormat::Ascii) {
+            for (qint64 v = 0; v < element.count; ++v) {
+                const QList<QByteArray> values = device.readLine().simplified().split(' ');
+                if (values.size() < element.properties.size()) {
+                    return fail(errorString, QStringLiteral("PLY vertex %1 is truncated").arg(v));
+                }
+                float xyz[3];
+                for (int axis = 0; axis < 3; ++axis) {
+                    const QByteArray& value = values[columns[axis]];
+                    const char* cursor = value.constData();
+                    if (!parseNumber(cursor, cursor + value.size(), xyz[axis])) {
+                        return fail(errorString, QStringLiteral("PLY vertex %1 is not numeric").arg(v));
+                    }
+                }
+                if (!chunk.append(QVector3D(xyz[0], xyz[1], xyz[2]))) {
+                    return fail(errorString, QStringLiteral("Import cancelled"));
+                }
+            }
+        } else {
+            // Whole chunks of fixed-size records per read
+            const bool bigEndian = format == PlyFormat::BinaryBigEndian;
+            QByteArray block;
+            for (qint64 v = 0; v < element.count;) {
+                const qint64 records = std::min<qint64>(element.count - v, PointImporter::CHUNK_POINTS);
+                block = device.read(records * stride);
+                if (block.size() != records * stride) {
+                    return fail(errorString, QStringLiteral("PLY vertex data is truncated"));
+                }
+
+                const uchar* record = reinterpret_cast<const uchar*>(block.constData());
+                for (qint64 i = 0; i < records; ++i, record += stride) {
+                    const QVector3D point(decodePly(record + offsets[0], types[0], bigEndian),
+                                          decodePly(record + offsets[1], types[1], bigEndian),
+                                          decodePly(record + offsets[2], types[2], bigEndian));
+                    if (!chunk.append(point)) {
+                        return fail(errorString, QStringLiteral("Import cancelled"));
+                    }
+                }
+                v += records;
+            }
+        }
+
+        if (!chunk.flush()) {
+            return fail(errorString, QStringLiteral("Import cancelled"));
+        }
+        // Faces and anything else after the vertices are of no use here
+        return true;
+    }
+
+    return fail(errorString, QStringLiteral("PLY file has no vertex element"));
+}
+
+}
+
+PointImporter::Format PointImporter::formatForPath(const QString& path)
+{
+    return QFileInfo(path).suffix().compare("ply", Qt::CaseInsensitive) == 0 ? Format::Ply : Format::Csv;
+}
+
+bool PointImporter::read(QIODevice& device, Format format, const ChunkHandler& onChunk, QString* errorString)
+{
+    switch (format) {
+    case Format::Csv:
+        return readCsv(device, onChunk, errorString);
+    case Format::Ply:
+        return readPly(device, onChunk, errorString);
+    }
+    return false;
+}
+
+PointImporter::PointImporter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+PointImporter::~PointImporter()
+{
+    stopThread();
+}
+
+void PointImporter::start(const QString& path)
+{
+    cancel();
+
+    const quint64 generation = ++m_generation;
+    m_running = true;
+    m_cancelled = false;
+
+    // Results hop back to this object's thread; stale ones fail the generation check
+    m_thread = QThread::create([this, path, generation] {
+        auto deliver = [this, generation](auto emitter) {
+            QMetaObject::invokeMethod(this, [this, generation, emitter] {
+                if (generation == m_generation) emitter();
+            }, Qt::QueuedConnection);
+        };
+
+        QFile file(path);
+        QString error;
+        bool ok = file.open(QIODevice::ReadOnly);
+        if (ok) {
+            const qint64 total = file.size();
+            ok = read(file, formatForPath(path), [&](QList<QVector3D>& points) {
+                if (m_cancelled) return false;
+                const qint64 position = file.pos();
+                deliver([this, points, position, total] {
+                    emit pointsRead(points);
+                    emit progress(position, total);
+                });
+                return true;
+            }, &error);
+        } else {
+            error = file.errorString();
+        }
+
+        deliver([this, ok, error] {
+            m_running = false;
+            emit finished(ok, error);
+        });
+    });
+    m_thread->setObjectName("PointImporter");
+    m_thread->start();
+}
+
+void PointImporter::cancel()
+{
+    stopThread();
+
+    // Chunks still queued from the stopped import are dropped on arrival
+    ++m_generation;
+    m_running = false;
+}
+
+bool PointImporter::isRunning() const
+{
+    return m_running;
+}
+
+void PointImporter::stopThread()
+{
+    if (!m_thread) return;
+
+    m_cancelled = true;
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+}
@@ -0,0 +1,74 @@
+//
+// PointImporter.h
+//
+
+#ifndef CURVES3D_POINTIMPORTER_H
+#define CURVES3D_POINTIMPORTER_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVector3D>
+
+#include <atomic>
+#include <functional>
+
+class QIODevice;
+class QThread;
+
+// Streams control points out of text and PLY files. read() parses a device
+// in fixed-size chunks and hands each chunk over as soon as it is complete,
+// so memory stays bounded by the chunk size and callers can show points
+// while the rest is still loading. start() runs the same parser on a worker
+// thread and delivers the chunks as queued signals.
+//
+// CSV: one point per line, the first three numbers separated by commas,
+// semicolons or whitespace; '#' comments and leading header lines are skipped.
+// PLY: ascii, binary_little_endian and binary_big_endian; x, y, z of the
+// vertex element, any scalar property types.
+class PointImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Format
+    {
+        Csv,
+        Ply
+    };
+
+    static constexpr qsizetype CHUNK_POINTS = 64 * 1024;
+
+    // Returning false from the handler stops the read
+    using ChunkHandler = std::function<bool(QList<QVector3D>& points)>;
+
+    static Format formatForPath(const QString& path);
+    static bool read(QIODevice& device, Format format, const ChunkHandler& onChunk,
+                     QString* errorString = nullptr);
+
+    explicit PointImporter(QObject *parent = nullptr);
+    ~PointImporter() override;
+
+    // Cancels an import still running, then reads path on the worker thread
+    void start(const QString& path);
+    void cancel();
+    bool isRunning() const;
+
+signals:
+    void pointsRead(const QList<QVector3D>& points);
+    void progress(qint64 bytesRead, qint64 bytesTotal);
+    // Not emitted for an import stopped by cancel() or a newer start()
+    void finished(bool ok, const QString& errorString);
+
+private:
+    void stopThread();
+
+    QThread *m_thread = nullptr;
+    std::atomic<bool> m_cancelled = false;
+
+    // GUI thread only: chunks queued by an earlier import are dropped on arrival
+    quint64 m_generation = 0;
+    bool m_running = false;
+};
+
+#endif //CURVES3D_POINTIMPORTER_H
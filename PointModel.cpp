@@ -3,8 +3,26 @@
 //
 
 #include "PointModel.h"
+
+#ifdef CURVES3D_DEBUG_MODEL
 #include <QDebug>
 
+namespace {
+
+// Debugging 3D points: only the changed range, never the whole model
+void dumpPoints(const char *change, const QList<QVector3D>& points, int first, int count)
+{
+    qDebug() << "PointModel" << change << "points" << first << "to" << first + count - 1
+             << "of" << points.size();
+    for (int i = first; i < first + count && i < points.size(); ++i) {
+        const QVector3D& p = points[i];
+        qDebug() << "  (" << p.x() << ", " << p.y() << ", " << p.z() << ")";
+    }
+}
+
+}
+#endif
+
 PointModel::PointModel(QObject *parent)
     : QObject(parent) {}
 
@@ -15,14 +33,121 @@ QList<QVector3D> PointModel::getControlPoints() const
 
 void PointModel::setControlPoints(const QList<QVector3D>& points)
 {
-    if (m_controlPoints != points) {
-        m_controlPoints = points;
-        emit pointsChanged(m_controlPoints);
-
-        // Debugging 3D points
-        qDebug() << "PointModel updated. Total points:" << m_controlPoints.size();
-        for (const QVector3D& p : m_controlPoints) {
-            qDebug() << "  (" << p.x() << ", " << p.y() << ", " << p.z() << ")";
+    if (points.size() == m_controlPoints.size()) {
+        beginBatch();
+        for (int i = 0; i < points.size(); ++i) {
+            setPoint(i, points[i]);
         }
+        endBatch();
+        return;
     }
-}
\ No newline at end of file
+
+    const bool batched = batchStructureChange();
+    if (!batched) emit pointsAboutToBeReset();
+    m_controlPoints = points;
+    if (batched) return;
+
+#ifdef CURVES3D_DEBUG_MODEL
+    dumpPoints("reset", m_controlPoints, 0, m_controlPoints.size());
+#endif
+    emit pointsReset();
+}
+
+void PointModel::setPoint(int index, const QVector3D& position)
+{
+    Q_ASSERT(index >= 0 && index < m_controlPoints.size());
+    if (m_controlPoints[index] == position) return;
+
+    m_controlPoints[index] = position;
+    notifyMoved(index, 1);
+}
+
+void PointModel::insertPoints(int first, const QList<QVector3D>& points)
+{
+    Q_ASSERT(first >= 0 && first <= m_controlPoints.size());
+    if (points.isEmpty()) return;
+
+    const bool batched = batchStructureChange();
+    if (!batched) emit pointsAboutToBeInserted(first, points.size());
+    for (int i = 0; i < points.size(); ++i) {
+        m_controlPoints.insert(first + i, points[i]);
+    }
+    if (batched) return;
+
+#ifdef CURVES3D_DEBUG_MODEL
+    dumpPoints("inserted", m_controlPoints, first, points.size());
+#endif
+    emit pointsInserted(first, points.size());
+}
+
+void PointModel::appendPoint(const QVector3D& position)
+{
+    insertPoints(m_controlPoints.size(), { position });
+}
+
+void PointModel::removePoints(int first, int count)
+{
+    Q_ASSERT(first >= 0 && first + count <= m_controlPoints.size());
+    if (count <= 0) return;
+
+    const bool batched = batchStructureChange();
+    if (!batched) emit pointsAboutToBeRemoved(first, count);
+    m_controlPoints.remove(first, count);
+    if (batched) return;
+
+#ifdef CURVES3D_DEBUG_MODEL
+    qDebug() << "PointModel removed points" << first << "to" << first + count - 1;
+#endif
+    emit pointsRemoved(first, count);
+}
+
+void PointModel::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+// Inside a batch the first insertion or removal announces the reset endBatch() will send
+bool PointModel::batchStructureChange()
+{
+    if (m_batchDepth == 0) return false;
+
+    if (!m_batchStructureChanged) {
+        m_batchStructureChanged = true;
+        emit pointsAboutToBeReset();
+    }
+    return true;
+}
+
+void PointModel::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+    if (--m_batchDepth > 0) return;
+
+    const IndexRange moved = m_batchMoved;
+    const bool structureChanged = m_batchStructureChanged;
+    m_batchMoved = {};
+    m_batchStructureChanged = false;
+
+    // Indices recorded before an insertion/removal no longer line up: reset instead
+    if (structureChanged) {
+#ifdef CURVES3D_DEBUG_MODEL
+        dumpPoints("reset", m_controlPoints, 0, m_controlPoints.size());
+#endif
+        emit pointsReset();
+    } else if (!moved.isEmpty()) {
+        notifyMoved(moved.first, moved.count);
+    }
+}
+
+void PointModel::notifyMoved(int first, int count)
+{
+    if (m_batchDepth > 0) {
+        m_batchMoved.unite({ first, count });
+        return;
+    }
+
+#ifdef CURVES3D_DEBUG_MODEL
+    dumpPoints("moved", m_controlPoints, first, count);
+#endif
+    emit pointsMoved(first, count);
+}
@@ -10,6 +10,15 @@
 #include <QVector3D> // The 3D vector type
 #include <QList>
 
+#include "IndexRange.h"
+
+// Control point storage. Changes are announced as deltas (index ranges into
+// the list) so views update only what changed; edits made between
+// beginBatch() and endBatch() are announced once, when the outermost batch
+// ends: as one pointsMoved range, or as pointsReset if points were inserted
+// or removed. Structural changes are also announced before the list changes
+// (pointsAboutTo*), for views that must know the old layout; in a batch the
+// first insertion or removal sends pointsAboutToBeReset.
 class PointModel : public QObject
 {
     Q_OBJECT
@@ -18,16 +27,43 @@ public:
     explicit PointModel(QObject *parent = nullptr);
 
     QList<QVector3D> getControlPoints() const;
+    const QList<QVector3D>& controlPoints() const { return m_controlPoints; }
+    int count() const { return m_controlPoints.size(); }
+    QVector3D point(int index) const { return m_controlPoints.at(index); }
+
+    // Lists of the same size are diffed into moves, anything else is a reset
     void setControlPoints(const QList<QVector3D>& points);
 
+    void setPoint(int index, const QVector3D& position);
+    void insertPoints(int first, const QList<QVector3D>& points);
+    void appendPoint(const QVector3D& position);
+    void removePoints(int first, int count);
+
+    void beginBatch();
+    void endBatch();
+
     signals:
-        void pointsChanged(const QList<QVector3D>& points);
+        void pointsMoved(int first, int count);
+        void pointsAboutToBeInserted(int first, int count);
+        void pointsInserted(int first, int count);
+        void pointsAboutToBeRemoved(int first, int count);
+        void pointsRemoved(int first, int count);
+        void pointsAboutToBeReset();
+        void pointsReset();
 
 private:
+    void notifyMoved(int first, int count);
+    bool batchStructureChange();
+
     QList<QVector3D> m_controlPoints;
+
+    // --- Batch State ---
+    int m_batchDepth = 0;
+    IndexRange m_batchMoved;
+    bool m_batchStructureChanged = false;
 };
 
 
 
 
-#endif //CURVES3D_POINTMODEL_H
\ No newline at end of file
+#endif //CURVES3D_POINTMODEL_H
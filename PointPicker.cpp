@@ -0,0 +1,157 @@
+//
+// PointPicker.cpp
+//
+
+#include "PointPicker.h"
+
+#include <QVector4D>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Roughly the hit radius: a pick touches at most a 3x3 block of cells
+constexpr int CELL_SIZE = 16;
+
+// The grid extends one cell past every viewport edge, so points just
+// off-screen can still be hit from the border
+constexpr int MARGIN = CELL_SIZE;
+
+// Beyond this many moved points a rebuild is cheaper than checking them all
+constexpr qsizetype MAX_MOVED_POINTS = 256;
+
+}
+
+void PointPicker::setCamera(const QMatrix4x4& viewProjection, const QSize& viewportSize)
+{
+    if (m_viewProjection != viewProjection || m_viewportSize != viewportSize) {
+        m_viewProjection = viewProjection;
+        m_viewportSize = viewportSize;
+        m_dirty = true;
+    }
+}
+
+void PointPicker::setPoints(const QList<QVector3D>& points)
+{
+    m_points = &points;
+    m_dirty = true;
+}
+
+void PointPicker::pointMoved(qsizetype index)
+{
+    if (m_dirty) return;
+
+    if (m_moved.size() >= MAX_MOVED_POINTS) {
+        m_dirty = true;
+        return;
+    }
+    m_projected[index] = project(m_points->at(index));
+    if (!m_moved.contains(index)) m_moved.append(index);
+}
+
+PointPicker::Projected PointPicker::project(const QVector3D& point) const
+{
+    const QVector4D clip = m_viewProjection * QVector4D(point, 1.0f);
+    Projected p;
+    if (clip.w() <= 0.0f) return p; // Behind the camera
+
+    p.x = (clip.x() / clip.w() + 1.0f) * 0.5f * m_viewportSize.width();
+    p.y = (1.0f - clip.y() / clip.w()) * 0.5f * m_viewportSize.height();
+    p.depth = clip.z() / clip.w();
+    p.visible = true;
+    return p;
+}
+
+void PointPicker::rebuild()
+{
+    m_dirty = false;
+    m_moved.clear();
+
+    m_columns = std::max(1, (m_viewportSize.width() + 2 * MARGIN + CELL_SIZE - 1) / CELL_SIZE);
+    m_rows = std::max(1, (m_viewportSize.height() + 2 * MARGIN + CELL_SIZE - 1) / CELL_SIZE);
+    const int cellCount = m_columns * m_rows;
+
+    // Counting sort by cell: one pass to count, one to place
+    static const QList<QVector3D> noPoints;
+    const QList<QVector3D>& points = m_points ? *m_points : noPoints;
+    m_projected.resize(points.size());
+    QVector<int> cellOf(points.size(), -1);
+    m_cellStart.fill(0, cellCount + 1);
+
+    for (qsizetype i = 0; i < points.size(); ++i) {
+        const Projected p = project(points[i]);
+        m_projected[i] = p;
+        if (!p.visible || p.x < -MARGIN || p.y < -MARGIN) continue;
+
+        const int column = static_cast<int>(p.x + MARGIN) / CELL_SIZE;
+        const int row = static_cast<int>(p.y + MARGIN) / CELL_SIZE;
+        if (column >= m_columns || row >= m_rows) continue;
+
+        cellOf[i] = row * m_columns + column;
+        ++m_cellStart[cellOf[i] + 1];
+    }
+
+    for (int c = 0; c < cellCount; ++c) {
+        m_cellStart[c + 1] += m_cellStart[c];
+    }
+
+    m_cellPoints.resize(m_cellStart[cellCount]);
+    QVector<int> fill(m_cellStart.cbegin(), m_cellStart.cend() - 1);
+    for (qsizetype i = 0; i < points.size(); ++i) {
+        if (cellOf[i] >= 0) m_cellPoints[fill[cellOf[i]]++] = static_cast<int>(i);
+    }
+}
+
+void PointPicker::consider(qsizetype index, const QPointF& pos, qreal radiusSquared,
+                           qsizetype& best, float& bestDepth, qreal& bestDistance) const
+{
+    const Projected& p = m_projected[index];
+    if (!p.visible) return;
+
+    const qreal dx = p.x - pos.x();
+    const qreal dy = p.y - pos.y();
+    const qreal distance = dx * dx + dy * dy;
+    if (distance > radiusSquared) return;
+
+    if (p.depth < bestDepth || (p.depth == bestDepth && distance < bestDistance)) {
+        best = index;
+        bestDepth = p.depth;
+        bestDistance = distance;
+    }
+}
+
+qsizetype PointPicker::pick(const QPointF& pos, qreal radius)
+{
+    if (m_dirty) rebuild();
+
+    qsizetype best = -1;
+    float bestDepth = std::numeric_limits<float>::infinity();
+    qreal bestDistance = std::numeric_limits<qreal>::infinity();
+    const qreal radiusSquared = radius * radius;
+
+    auto cellIndex = [](qreal coordinate) {
+        return static_cast<int>(std::floor((coordinate + MARGIN) / CELL_SIZE));
+    };
+    const int firstColumn = std::max(0, cellIndex(pos.x() - radius));
+    const int lastColumn = std::min(m_columns - 1, cellIndex(pos.x() + radius));
+    const int firstRow = std::max(0, cellIndex(pos.y() - radius));
+    const int lastRow = std::min(m_rows - 1, cellIndex(pos.y() + radius));
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const int cell = row * m_columns + column;
+            for (int k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                consider(m_cellPoints[k], pos, radiusSquared, best, bestDepth, bestDistance);
+            }
+        }
+    }
+
+    // Grid cells still list moved points at their old place; their current
+    // projection is what consider() tests, so checking them again is harmless
+    for (qsizetype index : m_moved) {
+        consider(index, pos, radiusSquared, best, bestDepth, bestDistance);
+    }
+    return best;
+}
@@ -0,0 +1,62 @@
+//
+// PointPicker.h
+//
+
+#ifndef CURVES3D_POINTPICKER_H
+#define CURVES3D_POINTPICKER_H
+
+#include <QList>
+#include <QMatrix4x4>
+#include <QPointF>
+#include <QSize>
+#include <QVector3D>
+
+// Screen-space grid over projected control points. The grid is rebuilt
+// lazily, on the first pick after the camera, the viewport or the point
+// set changed; a pick then only visits the few cells under the cursor.
+// Moved points are re-projected individually and checked alongside the
+// grid until the next rebuild, so dragging does not force a rebuild. The
+// picker reads the caller's point list in place and keeps no copy of it.
+class PointPicker
+{
+public:
+    void setCamera(const QMatrix4x4& viewProjection, const QSize& viewportSize);
+    // points must outlive the picker (or the next setPoints()); call again when
+    // points were inserted or removed
+    void setPoints(const QList<QVector3D>& points);
+    // points[index] has been changed in place
+    void pointMoved(qsizetype index);
+
+    // Index of the point nearest to the eye among those within radius pixels
+    // of pos (ties go to the one closest to pos), or -1
+    qsizetype pick(const QPointF& pos, qreal radius = 10.0);
+
+private:
+    struct Projected
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float depth = 0.0f;
+        bool visible = false;
+    };
+
+    Projected project(const QVector3D& point) const;
+    void rebuild();
+    void consider(qsizetype index, const QPointF& pos, qreal radiusSquared,
+                  qsizetype& best, float& bestDepth, qreal& bestDistance) const;
+
+    QMatrix4x4 m_viewProjection;
+    QSize m_viewportSize;
+    const QList<QVector3D> *m_points = nullptr;
+    bool m_dirty = true;
+
+    // Rebuilt state
+    QVector<Projected> m_projected;
+    int m_columns = 0;
+    int m_rows = 0;
+    QVector<int> m_cellStart;   // m_columns * m_rows + 1 offsets into m_cellPoints
+    QVector<int> m_cellPoints;  // Point indices sorted by cell
+    QVector<qsizetype> m_moved; // Re-projected since the rebuild, may sit in the wrong cell
+};
+
+#endif //CURVES3D_POINTPICKER_H
@@ -0,0 +1,95 @@
+//
+// PointTableModel.cpp
+//
+
+#include "PointTableModel.h"
+#include "PointModel.h"
+
+namespace {
+
+constexpr int COORDINATE_COUNT = 3;
+
+}
+
+PointTableModel::PointTableModel(PointModel *points, QObject *parent)
+    : QAbstractTableModel(parent), m_points(points)
+{
+    connect(m_points, &PointModel::pointsMoved, this, &PointTableModel::onPointsMoved);
+    connect(m_points, &PointModel::pointsAboutToBeInserted, this, &PointTableModel::onPointsAboutToBeInserted);
+    connect(m_points, &PointModel::pointsInserted, this, &PointTableModel::endInsertRows);
+    connect(m_points, &PointModel::pointsAboutToBeRemoved, this, &PointTableModel::onPointsAboutToBeRemoved);
+    connect(m_points, &PointModel::pointsRemoved, this, &PointTableModel::endRemoveRows);
+    connect(m_points, &PointModel::pointsAboutToBeReset, this, &PointTableModel::beginResetModel);
+    connect(m_points, &PointModel::pointsReset, this, &PointTableModel::endResetModel);
+}
+
+int PointTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_points->count();
+}
+
+int PointTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COORDINATE_COUNT;
+}
+
+QVariant PointTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return m_points->point(index.row())[index.column()];
+    }
+    if (role == Qt::TextAlignmentRole) {
+        return QVariant::fromValue(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+bool PointTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole || index.row() >= m_points->count()) return false;
+
+    bool ok = false;
+    const float v = value.toFloat(&ok);
+    if (!ok) return false;
+
+    // dataChanged comes back through pointsMoved, like any other edit
+    QVector3D point = m_points->point(index.row());
+    point[index.column()] = v;
+    m_points->setPoint(index.row(), point);
+    return true;
+}
+
+QVariant PointTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) return QVariant();
+
+    if (orientation == Qt::Horizontal) {
+        static const char *const names[COORDINATE_COUNT] = { "X", "Y", "Z" };
+        return (section >= 0 && section < COORDINATE_COUNT) ? QString(names[section]) : QVariant();
+    }
+    return QString("P%1").arg(section);
+}
+
+Qt::ItemFlags PointTableModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return QAbstractTableModel::flags(index) | Qt::ItemIsEditable;
+}
+
+void PointTableModel::onPointsMoved(int first, int count)
+{
+    emit dataChanged(index(first, 0), index(first + count - 1, COORDINATE_COUNT - 1),
+                     { Qt::DisplayRole, Qt::EditRole });
+}
+
+void PointTableModel::onPointsAboutToBeInserted(int first, int count)
+{
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+}
+
+void PointTableModel::onPointsAboutToBeRemoved(int first, int count)
+{
+    beginRemoveRows(QModelIndex(), first, first + count - 1);
+}
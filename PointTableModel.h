@@ -0,0 +1,40 @@
+//
+// PointTableModel.h
+//
+
+#ifndef CURVES3D_POINTTABLEMODEL_H
+#define CURVES3D_POINTTABLEMODEL_H
+
+#include <QAbstractTableModel>
+
+class PointModel;
+
+// Table view adapter over a PointModel: one row per control point, one
+// column per coordinate. Holds no point data of its own; views ask for the
+// cells they display, so a table over a million points costs only the rows
+// on screen. Rows are announced from PointModel's pointsAboutTo* signals,
+// while the list still has its old layout.
+class PointTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit PointTableModel(PointModel *points, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+private slots:
+    void onPointsMoved(int first, int count);
+    void onPointsAboutToBeInserted(int first, int count);
+    void onPointsAboutToBeRemoved(int first, int count);
+
+private:
+    PointModel *m_points;
+};
+
+#endif //CURVES3D_POINTTABLEMODEL_H
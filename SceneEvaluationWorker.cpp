@@ -0,0 +1,112 @@
+//
+// SceneEvaluationWorker.cpp
+//
+
+#include "SceneEvaluationWorker.h"
+#include "FrameProfiler.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+
+template <typename T>
+QVector<T> detachedCopy(const QVector<T>& all)
+{
+    return QVector<T>(all.cbegin(), all.cend());
+}
+
+}
+
+SceneJob SceneJob::snapshot(const CurveScene& scene)
+{
+    return { detachedCopy(scene.curves()), detachedCopy(scene.controlPoints()) };
+}
+
+void SceneResult::applyTo(SceneGeometry& geometry) const
+{
+    applySlice(geometry.vertices, vertexCount, vertices, dirty);
+    applySlice(geometry.segmentBounds, boundsCount, segmentBounds, dirtyBounds);
+    if (layoutChanged) {
+        geometry.drawFirsts = drawFirsts;
+        geometry.drawCounts = drawCounts;
+        geometry.curveTypes = curveTypes;
+        geometry.boundsOffsets = boundsOffsets;
+    }
+}
+
+SceneEvaluationWorker::SceneEvaluationWorker(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<SceneResult>();
+
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName("SceneEvaluationWorker");
+    m_thread->start();
+}
+
+SceneEvaluationWorker::~SceneEvaluationWorker()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_jobAvailable.wakeOne();
+    }
+    m_thread->wait();
+    delete m_thread;
+}
+
+quint64 SceneEvaluationWorker::submit(SceneJob job)
+{
+    // Every job is a whole snapshot, so a waiting one is simply replaced
+    QMutexLocker locker(&m_mutex);
+    m_pendingJob = std::move(job);
+    m_hasPendingJob = true;
+    m_jobAvailable.wakeOne();
+    return ++m_latestGeneration;
+}
+
+void SceneEvaluationWorker::run()
+{
+    forever {
+        SceneJob job;
+        quint64 generation = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_hasPendingJob && !m_quit) {
+                m_jobAvailable.wait(&m_mutex);
+            }
+            if (m_quit) return;
+
+            job = std::move(m_pendingJob);
+            m_hasPendingJob = false;
+            generation = m_latestGeneration;
+        }
+
+        const qint64 startNs = FrameProfiler::now();
+        m_scene.setCurves(job.curves, job.controlPoints);
+        m_scene.update();
+
+        // Only the changed slices are copied; the worker's scene is never shared
+        const SceneGeometry& geometry = m_scene.geometry();
+        SceneResult result;
+        result.generation = generation;
+        result.vertexCount = geometry.vertices.size();
+        result.dirty = m_scene.takeDirtyVertices();
+        result.vertices = sliceOf(geometry.vertices, result.dirty);
+        result.boundsCount = geometry.segmentBounds.size();
+        result.dirtyBounds = m_scene.takeDirtyBounds();
+        result.segmentBounds = sliceOf(geometry.segmentBounds, result.dirtyBounds);
+        result.layoutChanged = m_scene.takeLayoutChanged();
+        if (result.layoutChanged) {
+            result.drawFirsts = detachedCopy(geometry.drawFirsts);
+            result.drawCounts = detachedCopy(geometry.drawCounts);
+            result.curveTypes = detachedCopy(geometry.curveTypes);
+            result.boundsOffsets = detachedCopy(geometry.boundsOffsets);
+        }
+        result.evaluationStartNs = startNs;
+        result.evaluationNs = FrameProfiler::now() - startNs;
+
+        emit resultReady(result);
+    }
+}
@@ -0,0 +1,90 @@
+//
+// SceneEvaluationWorker.h
+//
+
+#ifndef CURVES3D_SCENEEVALUATIONWORKER_H
+#define CURVES3D_SCENEEVALUATIONWORKER_H
+
+#include "CurveScene.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QWaitCondition>
+
+class QThread;
+
+// The whole scene as curves() and controlPoints() of the edited CurveScene,
+// copied so that the job shares nothing with it
+struct SceneJob
+{
+    QVector<CurveBatchItem> curves;
+    QVector<QVector3D> controlPoints;
+
+    static SceneJob snapshot(const CurveScene& scene);
+};
+
+// Tessellated scene handed back to the GUI thread. Like CurveResult only what
+// changed travels: vertices holds [dirty.first, dirty.end()) of the scene and
+// segmentBounds the boxes in dirtyBounds; the draw ranges, types and bounds
+// offsets are only sent when the layout changed.
+struct SceneResult
+{
+    quint64 generation = 0;
+    qsizetype vertexCount = 0;
+    QVector<QVector3D> vertices;
+    IndexRange dirty;
+    qsizetype boundsCount = 0;
+    QVector<BoundingBox> segmentBounds;
+    IndexRange dirtyBounds;
+    bool layoutChanged = false;
+    QVector<int> drawFirsts;          // With layoutChanged
+    QVector<int> drawCounts;
+    QVector<CurveType> curveTypes;
+    QVector<qsizetype> boundsOffsets;
+    // When the delivered job started and how long it took, on FrameProfiler::now()'s clock
+    qint64 evaluationStartNs = 0;
+    qint64 evaluationNs = 0;
+
+    // Brings the receiver's copy of the scene up to date
+    void applyTo(SceneGeometry& geometry) const;
+};
+
+Q_DECLARE_METATYPE(SceneResult)
+
+// Tessellates the multi-curve scene on a dedicated thread with the
+// latest-wins semantics of CurveEvaluationWorker: a job still waiting is
+// replaced by a newer snapshot, and results are delivered in order through
+// resultReady, queued to the receiver's thread. The worker keeps its own
+// CurveScene, so a snapshot that only moves points re-evaluates just the
+// curves that differ. Receivers must apply every result.
+class SceneEvaluationWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SceneEvaluationWorker(QObject *parent = nullptr);
+    ~SceneEvaluationWorker() override;
+
+    // Returns the generation the eventual result will carry
+    quint64 submit(SceneJob job);
+
+signals:
+    void resultReady(const SceneResult& result);
+
+private:
+    void run();
+
+    QThread *m_thread = nullptr;
+
+    QMutex m_mutex;
+    QWaitCondition m_jobAvailable;
+    SceneJob m_pendingJob;
+    bool m_hasPendingJob = false;
+    bool m_quit = false;
+    quint64 m_latestGeneration = 0;
+
+    // Worker thread only
+    CurveScene m_scene;
+};
+
+#endif //CURVES3D_SCENEEVALUATIONWORKER_H
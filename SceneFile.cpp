@@ -0,0 +1,179 @@
+//
+// SceneFile.cpp
+//
+
+#include "SceneFile.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QSysInfo>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+static_assert(sizeof(QVector3D) == 3 * sizeof(float), "QVector3D must be three packed floats");
+
+struct FileHeader
+{
+    char magic[4];
+    quint32 version;
+    quint32 curveCount;
+    quint32 reserved;
+    quint64 pointCount;
+    quint64 pointsOffset;
+};
+
+struct CurveRecord
+{
+    quint32 type;
+    quint32 reserved;
+    quint64 pointCount;
+};
+
+static_assert(sizeof(FileHeader) == 32 && sizeof(CurveRecord) == 16, "Records must match the file layout");
+
+constexpr qint64 POINT_ALIGNMENT = 16;
+constexpr bool HOST_IS_LITTLE_ENDIAN = QSysInfo::ByteOrder == QSysInfo::LittleEndian;
+
+bool fail(QString* errorString, const QString& message)
+{
+    if (errorString) *errorString = message;
+    return false;
+}
+
+bool isCurveType(quint32 value)
+{
+    return value <= static_cast<quint32>(CurveType::BSpline);
+}
+
+// Points are stored little-endian; on such hosts a copy is all it takes
+void copyPoints(const uchar* source, qsizetype count, QVector3D* target)
+{
+    if constexpr (HOST_IS_LITTLE_ENDIAN) {
+        std::memcpy(static_cast<void*>(target), source, static_cast<size_t>(count) * sizeof(QVector3D));
+    } else {
+        for (qsizetype i = 0; i < count; ++i, source += sizeof(QVector3D)) {
+            target[i] = QVector3D(qFromLittleEndian<float>(source),
+                                  qFromLittleEndian<float>(source + 4),
+                                  qFromLittleEndian<float>(source + 8));
+        }
+    }
+}
+
+}
+
+bool SceneFile::save(const QString& path, std::span<const SceneCurve> curves, QString* errorString)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return fail(errorString, file.errorString());
+    }
+
+    quint64 pointCount = 0;
+    for (const SceneCurve& curve : curves) {
+        pointCount += static_cast<quint64>(curve.controlPoints.size());
+    }
+
+    const qint64 tableEnd = static_cast<qint64>(sizeof(FileHeader) + curves.size() * sizeof(CurveRecord));
+    const qint64 pointsOffset = (tableEnd + POINT_ALIGNMENT - 1) / POINT_ALIGNMENT * POINT_ALIGNMENT;
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = qToLittleEndian(VERSION);
+    header.curveCount = qToLittleEndian(static_cast<quint32>(curves.size()));
+    header.pointCount = qToLittleEndian(pointCount);
+    header.pointsOffset = qToLittleEndian(static_cast<quint64>(pointsOffset));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const SceneCurve& curve : curves) {
+        CurveRecord record = {};
+        record.type = qToLittleEndian(static_cast<quint32>(curve.type));
+        record.pointCount = qToLittleEndian(static_cast<quint64>(curve.controlPoints.size()));
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    file.write(QByteArray(pointsOffset - tableEnd, '\0'));
+
+    for (const SceneCurve& curve : curves) {
+        if constexpr (HOST_IS_LITTLE_ENDIAN) {
+            file.write(reinterpret_cast<const char*>(curve.controlPoints.constData()),
+                       curve.controlPoints.size() * static_cast<qint64>(sizeof(QVector3D)));
+        } else {
+            for (const QVector3D& p : curve.controlPoints) {
+                const float xyz[3] = { qToLittleEndian(p.x()), qToLittleEndian(p.y()), qToLittleEndian(p.z()) };
+                file.write(reinterpret_cast<const char*>(xyz), sizeof(xyz));
+            }
+        }
+    }
+
+    if (!file.commit()) {
+        return fail(errorString, file.errorString());
+    }
+    return true;
+}
+
+bool SceneFile::load(const QString& path, QList<SceneCurve>& curves, QString* errorString)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return fail(errorString, file.errorString());
+    }
+
+    const qint64 size = file.size();
+    if (size < static_cast<qint64>(sizeof(FileHeader))) {
+        return fail(errorString, QStringLiteral("Not a curve scene file"));
+    }
+
+    // Mapped pages are read straight into the point lists; nothing is buffered twice
+    const uchar* data = file.map(0, size);
+    if (!data) {
+        return fail(errorString, file.errorString());
+    }
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail(errorString, QStringLiteral("Not a curve scene file"));
+    }
+    if (qFromLittleEndian(header.version) != VERSION) {
+        return fail(errorString, QStringLiteral("Unsupported scene file version %1").arg(qFromLittleEndian(header.version)));
+    }
+
+    const quint64 curveCount = qFromLittleEndian(header.curveCount);
+    const quint64 pointCount = qFromLittleEndian(header.pointCount);
+    const quint64 pointsOffset = qFromLittleEndian(header.pointsOffset);
+    const quint64 tableEnd = sizeof(FileHeader) + curveCount * sizeof(CurveRecord);
+    if (pointsOffset < tableEnd || pointsOffset > static_cast<quint64>(size)
+        || pointCount > (static_cast<quint64>(size) - pointsOffset) / sizeof(QVector3D)) {
+        return fail(errorString, QStringLiteral("Scene file is truncated"));
+    }
+
+    QList<SceneCurve> loaded;
+    loaded.reserve(static_cast<qsizetype>(curveCount));
+
+    const uchar* records = data + sizeof(FileHeader);
+    const uchar* points = data + pointsOffset;
+    quint64 pointsLeft = pointCount;
+    for (quint64 i = 0; i < curveCount; ++i) {
+        CurveRecord record;
+        std::memcpy(&record, records + i * sizeof(CurveRecord), sizeof(record));
+        const quint32 type = qFromLittleEndian(record.type);
+        const quint64 count = qFromLittleEndian(record.pointCount);
+        if (!isCurveType(type) || count > pointsLeft) {
+            return fail(errorString, QStringLiteral("Scene file curve %1 is corrupt").arg(i));
+        }
+
+        SceneCurve curve;
+        curve.type = static_cast<CurveType>(type);
+        curve.controlPoints.resize(static_cast<qsizetype>(count));
+        copyPoints(points, static_cast<qsizetype>(count), curve.controlPoints.data());
+        loaded.append(std::move(curve));
+
+        points += count * sizeof(QVector3D);
+        pointsLeft -= count;
+    }
+
+    curves = std::move(loaded);
+    return true;
+}
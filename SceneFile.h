@@ -0,0 +1,37 @@
+//
+// SceneFile.h
+//
+
+#ifndef CURVES3D_SCENEFILE_H
+#define CURVES3D_SCENEFILE_H
+
+#include "CurveCalculator.h"
+
+#include <QString>
+
+#include <span>
+
+struct SceneCurve
+{
+    CurveType type = CurveType::Bezier;
+    QList<QVector3D> controlPoints;
+};
+
+// Binary scene format (.c3ds), little-endian:
+//   header     magic "C3DS", version, curve count, total point count, offset of the point block
+//   curve table  per curve: type and point count
+//   point block  x, y, z floats of all curves back to back, 16-byte aligned
+// The point block has exactly the layout of QVector3D arrays, so loading maps
+// the file and copies every curve's points in one memcpy, with no parsing.
+class SceneFile
+{
+public:
+    static constexpr char MAGIC[4] = { 'C', '3', 'D', 'S' };
+    static constexpr quint32 VERSION = 1;
+    static constexpr QLatin1String SUFFIX{ "c3ds" };
+
+    static bool save(const QString& path, std::span<const SceneCurve> curves, QString* errorString = nullptr);
+    static bool load(const QString& path, QList<SceneCurve>& curves, QString* errorString = nullptr);
+};
+
+#endif //CURVES3D_SCENEFILE_H
@@ -0,0 +1,937 @@
+//
+// SceneRenderer.cpp
+//
+
+#include "SceneRenderer.h"
+
+#include <QOpenGLContext>
+#include <QVector4D>
+
+#include <algorithm>
+
+// --- Shaders ---
+const char *vertexShaderSource =
+    "attribute vec3 position;\n"
+    "uniform mat4 matrix;\n"
+    "void main() {\n"
+    "    gl_Position = matrix * vec4(position, 1.0);\n"
+    "}\n";
+
+const char *fragmentShaderSource =
+    "uniform vec4 color;\n"
+    "void main() {\n"
+    "    gl_FragColor = color;\n"
+    "}\n";
+
+// Control points: one draw for all of them, the colour comes from a per-vertex state
+const char *pointVertexShaderSource =
+    "attribute vec3 position;\n"
+    "attribute float state;\n"
+    "uniform mat4 matrix;\n"
+    "uniform vec4 stateColors[4];\n"
+    "uniform float pointSize;\n"
+    "varying vec4 pointColor;\n"
+    "void main() {\n"
+    "    gl_Position = matrix * vec4(position, 1.0);\n"
+    "    gl_PointSize = pointSize;\n"
+    "    pointColor = stateColors[int(state + 0.5)];\n"
+    "}\n";
+
+const char *pointFragmentShaderSource =
+    "varying vec4 pointColor;\n"
+    "void main() {\n"
+    "    gl_FragColor = pointColor;\n"
+    "}\n";
+
+// Procedural grid: a screen-covering quad whose fragments are intersected
+// with the y = 0 plane, so the grid has no extent and no per-line vertices.
+const char *gridVertexShaderSource =
+    "attribute vec3 position;\n"
+    "uniform mat4 inverseMatrix;\n"
+    "varying vec3 nearPoint;\n"
+    "varying vec3 farPoint;\n"
+    "vec3 unproject(vec2 xy, float z) {\n"
+    "    vec4 p = inverseMatrix * vec4(xy, z, 1.0);\n"
+    "    return p.xyz / p.w;\n"
+    "}\n"
+    "void main() {\n"
+    "    nearPoint = unproject(position.xy, -1.0);\n"
+    "    farPoint = unproject(position.xy, 1.0);\n"
+    "    gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+    "}\n";
+
+const char *gridFragmentShaderSource =
+    "uniform mat4 matrix;\n"
+    "uniform vec4 color;\n"
+    "uniform float spacing;\n"
+    "uniform float fadeDistance;\n"
+    "varying vec3 nearPoint;\n"
+    "varying vec3 farPoint;\n"
+    "void main() {\n"
+    "    float t = -nearPoint.y / (farPoint.y - nearPoint.y);\n"
+    "    if (!(t > 0.0)) discard;\n"
+    "    vec3 p = nearPoint + t * (farPoint - nearPoint);\n"
+    "    vec2 coord = p.xz / spacing;\n"
+    "    vec2 g = abs(fract(coord - 0.5) - 0.5) / fwidth(coord);\n"
+    "    float alpha = 1.0 - min(min(g.x, g.y), 1.0);\n"
+    "    alpha *= clamp(1.0 - length(p.xz) / fadeDistance, 0.0, 1.0);\n"
+    "    if (alpha <= 0.0) discard;\n"
+    "    vec4 clip = matrix * vec4(p, 1.0);\n"
+    "    gl_FragDepth = 0.5 * clip.z / clip.w + 0.5;\n"
+    "    gl_FragColor = vec4(color.rgb, color.a * alpha);\n"
+    "}\n";
+
+// Surfaces: two-sided diffuse light from a fixed direction in view space
+const char *surfaceVertexShaderSource =
+    "attribute vec3 position;\n"
+    "attribute vec3 normal;\n"
+    "uniform mat4 matrix;\n"
+    "uniform mat4 viewMatrix;\n"
+    "varying vec3 viewNormal;\n"
+    "void main() {\n"
+    "    viewNormal = (viewMatrix * vec4(normal, 0.0)).xyz;\n"
+    "    gl_Position = matrix * vec4(position, 1.0);\n"
+    "}\n";
+
+const char *surfaceFragmentShaderSource =
+    "uniform vec4 color;\n"
+    "uniform vec3 lightDirection;\n"
+    "varying vec3 viewNormal;\n"
+    "void main() {\n"
+    "    float shade = 0.25 + 0.75 * abs(dot(viewNormal, lightDirection)) / max(length(viewNormal), 1e-6);\n"
+    "    gl_FragColor = vec4(color.rgb * shade, color.a);\n"
+    "}\n";
+
+// Curve evaluation on the GPU (GLSL 1.10, as the other programs). The
+// per-vertex attribute is only the sample parameter; the four control
+// points are per-instance attributes, and basis turns (1, t, t^2, t^3)
+// into their weights.
+const char *cubicCurveVertexShaderSource =
+    "attribute float parameter;\n"
+    "attribute vec3 p0;\n"
+    "attribute vec3 p1;\n"
+    "attribute vec3 p2;\n"
+    "attribute vec3 p3;\n"
+    "uniform mat4 matrix;\n"
+    "uniform mat4 basis;\n"
+    "void main() {\n"
+    "    float t = parameter;\n"
+    "    vec4 w = basis * vec4(1.0, t, t * t, t * t * t);\n"
+    "    vec3 p = w.x * p0 + w.y * p1 + w.z * p2 + w.w * p3;\n"
+    "    gl_Position = matrix * vec4(p, 1.0);\n"
+    "}\n";
+
+// De Casteljau over a uniform array; the loops have constant bounds as GLSL 1.10
+// requires. MAX_POINTS is defined from MAX_GPU_BEZIER_POINTS when compiling.
+const char *bezierCurveVertexShaderSource =
+    "attribute float parameter;\n"
+    "uniform vec3 controlPoints[MAX_POINTS];\n"
+    "uniform int pointCount;\n"
+    "uniform mat4 matrix;\n"
+    "void main() {\n"
+    "    vec3 q[MAX_POINTS];\n"
+    "    for (int i = 0; i < MAX_POINTS; ++i) {\n"
+    "        if (i >= pointCount) break;\n"
+    "        q[i] = controlPoints[i];\n"
+    "    }\n"
+    "    for (int k = 1; k < MAX_POINTS; ++k) {\n"
+    "        if (k >= pointCount) break;\n"
+    "        for (int i = 0; i < MAX_POINTS - 1; ++i) {\n"
+    "            if (i >= pointCount - k) break;\n"
+    "            q[i] = mix(q[i], q[i + 1], parameter);\n"
+    "        }\n"
+    "    }\n"
+    "    gl_Position = matrix * vec4(q[0], 1.0);\n"
+    "}\n";
+
+// Every static program reads positions from attribute 0, so one VAO serves them all
+const int POSITION_LOCATION = 0;
+const int STATE_LOCATION = 1;
+const int NORMAL_LOCATION = 1; // Surface program
+const int CONTROL_POINT_LOCATION = 2; // p0..p3 of the cubic curve program use 2..5
+const int PARAMETER_LOCATION = POSITION_LOCATION;
+
+const int GRID_SIZE = 100; // Total extent in one direction (e.g., -100 to +100)
+const int GRID_SPACING = 20; // Distance between lines (e.g., one tile size)
+const QVector4D GRID_COLOR(0.3f, 0.3f, 0.4f, 1.0f);
+
+namespace {
+
+// Rows give the weight of P0..P3 as coefficients of (1, t, t^2, t^3). Catmull-Rom
+// is folded exactly like CurveBasis::catmullRomWeights(), so both follow
+// CurveCalculator::CATMULL_ROM_TAU
+QMatrix4x4 catmullRomBasis()
+{
+    const float tau = static_cast<float>(CurveCalculator::CATMULL_ROM_TAU);
+    // Hermite blending functions H1..H4
+    const QVector4D h1(1.0f, 0.0f, -3.0f, 2.0f);
+    const QVector4D h2(0.0f, 0.0f, 3.0f, -2.0f);
+    const QVector4D h3(0.0f, 1.0f, -2.0f, 1.0f);
+    const QVector4D h4(0.0f, 0.0f, -1.0f, 1.0f);
+
+    QMatrix4x4 basis;
+    basis.setRow(0, -tau * h3);
+    basis.setRow(1, h1 - tau * h4);
+    basis.setRow(2, h2 + tau * h3);
+    basis.setRow(3, tau * h4);
+    return basis;
+}
+
+const QMatrix4x4 CATMULL_ROM_BASIS = catmullRomBasis();
+const QMatrix4x4 BSPLINE_BASIS(1.0f / 6.0f, -0.5f,  0.5f, -1.0f / 6.0f,
+                               4.0f / 6.0f,  0.0f, -1.0f,  0.5f,
+                               1.0f / 6.0f,  0.5f,  0.5f, -0.5f,
+                               0.0f,         0.0f,  0.0f,  1.0f / 6.0f);
+
+// render() stages in drawing order, as reported by the profiler
+const char *const STAGE_NAMES[] = { "Draw grid", "Draw axes", "Draw surfaces", "Draw scene", "Draw curve",
+                                     "Draw points" };
+constexpr int STAGE_COUNT = sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]);
+
+// Indexed by SceneRenderer::PointState
+const QVector4D POINT_STATE_COLORS[] = {
+    QVector4D(1.0f, 0.0f, 0.0f, 1.0f), // Normal: red
+    QVector4D(1.0f, 0.8f, 0.3f, 1.0f), // Hovered: light orange
+    QVector4D(0.2f, 0.8f, 1.0f, 1.0f), // Highlighted: cyan
+    QVector4D(1.0f, 0.5f, 0.0f, 1.0f), // Dragged: orange
+};
+
+}
+
+QMatrix4x4 SceneCamera::viewMatrix() const
+{
+    QMatrix4x4 view;
+    view.translate(0.0, 0.0, zoomDistance);
+    view.rotate(rotationX, 1, 0, 0);
+    view.rotate(rotationY, 0, 1, 0);
+    return view;
+}
+
+QMatrix4x4 SceneCamera::projectionMatrix(const QSize& viewport) const
+{
+    QMatrix4x4 projection;
+    projection.perspective(45.0f, (float)viewport.width() / (float)std::max(viewport.height(), 1), 0.1f, 1000.0f);
+    return projection;
+}
+
+// --- Setup ---
+
+bool SceneRenderer::initialize(QOpenGLContext *context)
+{
+    initializeOpenGLFunctions();
+
+    bool ok = m_program.addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShaderSource)
+           && m_program.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
+    m_program.bindAttributeLocation("position", POSITION_LOCATION);
+    ok = ok && m_program.link();
+
+    // The procedural grid is optional: without it the line grid is used
+    m_gridProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, gridVertexShaderSource);
+    m_gridProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, gridFragmentShaderSource);
+    m_gridProgram.bindAttributeLocation("position", POSITION_LOCATION);
+    m_gridProgramLinked = m_gridProgram.link();
+
+    ok = ok && m_pointProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, pointVertexShaderSource)
+            && m_pointProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, pointFragmentShaderSource);
+    m_pointProgram.bindAttributeLocation("position", POSITION_LOCATION);
+    m_pointProgram.bindAttributeLocation("state", STATE_LOCATION);
+    ok = ok && m_pointProgram.link();
+
+    // Surfaces are optional: without the program they are not drawn
+    m_surfaceProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, surfaceVertexShaderSource);
+    m_surfaceProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, surfaceFragmentShaderSource);
+    m_surfaceProgram.bindAttributeLocation("position", POSITION_LOCATION);
+    m_surfaceProgram.bindAttributeLocation("normal", NORMAL_LOCATION);
+    m_surfaceProgramLinked = m_surfaceProgram.link();
+
+    // GPU curve evaluation is optional: without it curves are always tessellated on the CPU
+    m_cubicCurveProgram.addShaderFromSourceCode(QOpenGLShader::Vertex, cubicCurveVertexShaderSource);
+    m_cubicCurveProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
+    m_cubicCurveProgram.bindAttributeLocation("parameter", PARAMETER_LOCATION);
+    for (int i = 0; i < 4; ++i) {
+        m_cubicCurveProgram.bindAttributeLocation(QByteArray("p") + QByteArray::number(i), CONTROL_POINT_LOCATION + i);
+    }
+    m_cubicCurveLinked = m_cubicCurveProgram.link();
+
+    m_bezierCurveProgram.addShaderFromSourceCode(QOpenGLShader::Vertex,
+        "#define MAX_POINTS " + QByteArray::number(MAX_GPU_BEZIER_POINTS) + "\n" + bezierCurveVertexShaderSource);
+    m_bezierCurveProgram.addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShaderSource);
+    m_bezierCurveProgram.bindAttributeLocation("parameter", PARAMETER_LOCATION);
+    m_bezierCurveLinked = m_bezierCurveProgram.link();
+
+    m_posAttr = m_program.attributeLocation("position");
+    m_matrixUniform = m_program.uniformLocation("matrix");
+    m_colorUniform = m_program.uniformLocation("color");
+
+    glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    buildStaticGeometry();
+
+    // Desktop GL 1.4+; absent on ES, where drawScene() falls back to a loop
+    m_glMultiDrawArrays = reinterpret_cast<MultiDrawArraysFunction>(context->getProcAddress("glMultiDrawArrays"));
+    m_glMultiDrawElements = reinterpret_cast<MultiDrawElementsFunction>(context->getProcAddress("glMultiDrawElements"));
+    m_glVertexAttribDivisor = reinterpret_cast<VertexAttribDivisorFunction>(context->getProcAddress("glVertexAttribDivisor"));
+    if (!m_glVertexAttribDivisor) {
+        m_glVertexAttribDivisor = reinterpret_cast<VertexAttribDivisorFunction>(context->getProcAddress("glVertexAttribDivisorARB"));
+    }
+    m_glDrawArraysInstanced = reinterpret_cast<DrawArraysInstancedFunction>(context->getProcAddress("glDrawArraysInstanced"));
+    if (!m_glDrawArraysInstanced) {
+        m_glDrawArraysInstanced = reinterpret_cast<DrawArraysInstancedFunction>(context->getProcAddress("glDrawArraysInstancedARB"));
+    }
+
+    // Optional: without timer queries the profiler reports CPU times only
+    m_gpuTimer.create(STAGE_COUNT);
+    return ok;
+}
+
+void SceneRenderer::destroy()
+{
+    m_curveBuffer.destroy();
+    m_pointsBuffer.destroy();
+    m_pointStateBuffer.destroy();
+    m_sceneBuffer.destroy();
+    m_curveIndexBuffer.destroy();
+    m_sceneIndexBuffer.destroy();
+    m_surfaceVertexBuffer.destroy();
+    m_surfaceNormalBuffer.destroy();
+    m_surfaceIndexBuffer.destroy();
+    m_staticVao.destroy();
+    m_staticVbo.destroy();
+    m_parameterVbo.destroy();
+    m_gpuTimer.destroy();
+}
+
+void SceneRenderer::buildStaticGeometry()
+{
+    QVector<QVector3D> staticData;
+    staticData.reserve(6 + 4 * (GRID_SIZE + 1) + 4);
+
+    // Axes: X (Red), Y (Green), Z (Blue)
+    m_axesFirst = staticData.size();
+    staticData << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(30.0f, 0.0f, 0.0f)
+               << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(0.0f, 30.0f, 0.0f)
+               << QVector3D(0.0f, 0.0f, 0.0f) << QVector3D(0.0f, 0.0f, 30.0f);
+
+    // Line grid
+    const float HALF_SIZE = (float)GRID_SIZE / 2.0f;
+    m_gridFirst = staticData.size();
+
+    // Generate lines parallel to the Z-axis (varying X)
+    for (int i = -GRID_SIZE / 2; i <= GRID_SIZE / 2; ++i) {
+        float x = (float)i * GRID_SPACING;
+        staticData.append(QVector3D(x, 0.0f, -HALF_SIZE * GRID_SPACING));
+        staticData.append(QVector3D(x, 0.0f, HALF_SIZE * GRID_SPACING));
+    }
+
+    // Generate lines parallel to the X-axis (varying Z)
+    for (int i = -GRID_SIZE / 2; i <= GRID_SIZE / 2; ++i) {
+        float z = (float)i * GRID_SPACING;
+        staticData.append(QVector3D(-HALF_SIZE * GRID_SPACING, 0.0f, z));
+        staticData.append(QVector3D(HALF_SIZE * GRID_SPACING, 0.0f, z));
+    }
+    m_gridCount = staticData.size() - m_gridFirst;
+
+    // Screen quad for the procedural grid (clip-space corners, triangle strip)
+    m_screenQuadFirst = staticData.size();
+    staticData << QVector3D(-1.0f, -1.0f, 0.0f) << QVector3D(1.0f, -1.0f, 0.0f)
+               << QVector3D(-1.0f, 1.0f, 0.0f) << QVector3D(1.0f, 1.0f, 0.0f);
+
+    m_staticVbo.create();
+    m_staticVbo.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_staticVbo.bind();
+    m_staticVbo.allocate(staticData.constData(), staticData.size() * sizeof(QVector3D));
+
+    // Record the attribute setup once; without VAO support it is redone per draw
+    if (m_staticVao.create()) {
+        QOpenGLVertexArrayObject::Binder vaoBinder(&m_staticVao);
+        glEnableVertexAttribArray(POSITION_LOCATION);
+        glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    }
+    m_staticVbo.release();
+
+    // Sample parameters of one segment, in the order CurveCalculator writes them
+    QVector<float> parameters(CurveCalculator::SEGMENT_SAMPLES);
+    for (int i = 0; i < parameters.size(); ++i) {
+        parameters[i] = static_cast<float>(i) / CurveCalculator::CURVE_DETAIL;
+    }
+    m_parameterVbo.create();
+    m_parameterVbo.setUsagePattern(QOpenGLBuffer::StaticDraw);
+    m_parameterVbo.bind();
+    m_parameterVbo.allocate(parameters.constData(), parameters.size() * sizeof(float));
+    m_parameterVbo.release();
+}
+
+void SceneRenderer::bindStaticGeometry()
+{
+    if (m_staticVao.isCreated()) {
+        m_staticVao.bind();
+        return;
+    }
+    m_staticVbo.bind();
+    glEnableVertexAttribArray(POSITION_LOCATION);
+    glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+}
+
+void SceneRenderer::releaseStaticGeometry()
+{
+    if (m_staticVao.isCreated()) {
+        m_staticVao.release();
+        return;
+    }
+    glDisableVertexAttribArray(POSITION_LOCATION);
+    m_staticVbo.release();
+}
+
+// --- Uploads ---
+
+void SceneRenderer::setViewport(const QSize& size)
+{
+    glViewport(0, 0, size.width(), size.height());
+    if (m_viewportSize != size) {
+        m_viewportSize = size;
+        m_curveLodDirty = true;
+        m_sceneLodDirty = true;
+    }
+}
+
+void SceneRenderer::setLevelOfDetail(bool enabled)
+{
+    m_levelOfDetail = enabled;
+    m_curveLodDirty = true;
+    m_sceneLodDirty = true;
+}
+
+void SceneRenderer::updateCurve(CurveType type, const QVector<QVector3D>& vertices, const IndexRange& dirty,
+                                const QVector<BoundingBox>& segmentBounds, const IndexRange& dirtyBounds,
+                                bool layoutChanged)
+{
+    if (layoutChanged || !dirty.isEmpty() || m_curveBounds.size() != segmentBounds.size()) {
+        m_curveType = type;
+        m_curveBounds.resize(segmentBounds.size());
+        m_curveLodDirty = true;
+    }
+    if (!dirtyBounds.isEmpty()) {
+        std::copy(segmentBounds.cbegin() + dirtyBounds.first, segmentBounds.cbegin() + dirtyBounds.end(),
+                  m_curveBounds.begin() + dirtyBounds.first);
+    }
+    if (layoutChanged) m_curveBuffer.markAllDirty();
+    m_curveBuffer.markDirty(dirty);
+    m_curveBuffer.sync(vertices);
+}
+
+void SceneRenderer::updatePoints(const QList<QVector3D>& points, const IndexRange& dirty, bool layoutChanged)
+{
+    // Inserts/removals shift every later point
+    if (layoutChanged) m_pointsBuffer.markAllDirty();
+    m_pointsBuffer.markDirty(dirty);
+    m_pointsBuffer.sync(points);
+
+    const bool bezierOnGpu = m_gpuCurve && m_gpuCurveType == CurveType::Bezier
+                          && points.size() <= MAX_GPU_BEZIER_POINTS;
+    if (bezierOnGpu && (layoutChanged || !dirty.isEmpty() || m_bezierPointsStale)) {
+        std::copy(points.cbegin(), points.cend(), m_bezierPoints.begin());
+        m_bezierPointCount = points.size();
+        m_bezierPointsStale = false;
+        m_bezierUniformsDirty = true;
+    }
+}
+
+bool SceneRenderer::supportsGpuCurve(CurveType type, qsizetype pointCount, int degree) const
+{
+    // Too few points for a segment: the CPU path draws the points themselves
+    if (CurveCalculator::segmentCount(type, pointCount, degree) == 0) return false;
+    if (type == CurveType::BSpline && degree != CurveCalculator::BSPLINE_DEGREE) return false;
+
+    if (type == CurveType::Bezier) {
+        return m_bezierCurveLinked && pointCount <= MAX_GPU_BEZIER_POINTS;
+    }
+    return m_cubicCurveLinked && m_glVertexAttribDivisor && m_glDrawArraysInstanced;
+}
+
+void SceneRenderer::setGpuCurve(bool enabled, CurveType type)
+{
+    // The Bézier copy is only kept up to date while it is in use
+    const bool bezierBefore = m_gpuCurve && m_gpuCurveType == CurveType::Bezier;
+    m_gpuCurve = enabled;
+    m_gpuCurveType = type;
+    if (!bezierBefore && enabled && type == CurveType::Bezier) {
+        m_bezierPointsStale = true;
+    }
+}
+
+void SceneRenderer::updatePointStates(const QVector<quint8>& states, const IndexRange& dirty, bool layoutChanged)
+{
+    if (layoutChanged) m_pointStateBuffer.markAllDirty();
+    m_pointStateBuffer.markDirty(dirty);
+    m_pointStateBuffer.sync(states);
+}
+
+void SceneRenderer::updateScene(const SceneGeometry& geometry, const IndexRange& dirtyVertices,
+                                const IndexRange& dirtyBounds, bool layoutChanged)
+{
+    if (layoutChanged) m_sceneBuffer.markAllDirty();
+    m_sceneBuffer.markDirty(dirtyVertices);
+    m_sceneBuffer.sync(geometry.vertices);
+
+    // Per-curve draw ranges only change with the layout and are taken whole;
+    // bounds are patched in place between layouts and copied by range
+    if (layoutChanged) {
+        m_sceneFirsts = geometry.drawFirsts;
+        m_sceneCounts = geometry.drawCounts;
+        m_sceneTypes = geometry.curveTypes;
+        m_sceneBoundsOffsets = geometry.boundsOffsets;
+        m_sceneBounds.resize(geometry.segmentBounds.size());
+        m_sceneLodDirty = true;
+    }
+    if (!dirtyBounds.isEmpty()) {
+        const QVector<BoundingBox>& bounds = geometry.segmentBounds;
+        std::copy(bounds.cbegin() + dirtyBounds.first, bounds.cbegin() + dirtyBounds.end(),
+                  m_sceneBounds.begin() + dirtyBounds.first);
+        m_sceneLodDirty = true;
+    }
+}
+
+void SceneRenderer::updateSurfaces(const SurfaceMesh& mesh, const IndexRange& dirtyVertices, bool layoutChanged)
+{
+    if (layoutChanged) {
+        m_surfaceVertexBuffer.markAllDirty();
+        m_surfaceNormalBuffer.markAllDirty();
+        m_surfaceIndexBuffer.markAllDirty();
+    }
+    m_surfaceVertexBuffer.markDirty(dirtyVertices);
+    m_surfaceNormalBuffer.markDirty(dirtyVertices);
+    m_surfaceVertexBuffer.sync(mesh.vertices);
+    m_surfaceNormalBuffer.sync(mesh.normals);
+    m_surfaceIndexBuffer.sync(mesh.indices);
+}
+
+void SceneRenderer::updateLevelOfDetail(const QMatrix4x4& combined)
+{
+    const CurveLod lod(combined, m_viewportSize);
+    // A new view invalidates both lists; an edit only the one it touched
+    const bool viewChanged = combined != m_lodMatrix;
+
+    // Index lists follow the view, so they are replaced wholesale
+    auto upload = [](GpuBuffer& buffer, const LodDrawList& list, QVector<const void*>& offsets) {
+        offsets.resize(list.runFirsts.size());
+        for (qsizetype i = 0; i < offsets.size(); ++i) {
+            offsets[i] = reinterpret_cast<const void*>(static_cast<quintptr>(list.runFirsts[i]) * sizeof(quint32));
+        }
+        buffer.markAllDirty();
+        buffer.sync(list.indices);
+    };
+
+    if (viewChanged || m_curveLodDirty) {
+        m_curveLod.clear();
+        lod.appendCurve(m_curveType,
+                        std::span<const BoundingBox>(m_curveBounds.constData(), static_cast<size_t>(m_curveBounds.size())),
+                        0, m_curveBuffer.count(), m_curveLod);
+        upload(m_curveIndexBuffer, m_curveLod, m_curveLodOffsets);
+    }
+
+    if (viewChanged || m_sceneLodDirty) {
+        m_sceneLod.clear();
+        for (qsizetype i = 0; i < m_sceneFirsts.size(); ++i) {
+            const qsizetype firstBox = m_sceneBoundsOffsets[i];
+            const std::span<const BoundingBox> bounds(m_sceneBounds.constData() + firstBox,
+                                                      static_cast<size_t>(m_sceneBoundsOffsets[i + 1] - firstBox));
+            lod.appendCurve(m_sceneTypes[i], bounds, static_cast<quint32>(m_sceneFirsts[i]), m_sceneCounts[i], m_sceneLod);
+        }
+        upload(m_sceneIndexBuffer, m_sceneLod, m_sceneLodOffsets);
+    }
+
+    m_lodMatrix = combined;
+    m_curveLodDirty = false;
+    m_sceneLodDirty = false;
+}
+
+qint64 SceneRenderer::totalBytesUploaded() const
+{
+    return m_curveBuffer.totalBytesUploaded() + m_pointsBuffer.totalBytesUploaded()
+         + m_pointStateBuffer.totalBytesUploaded() + m_sceneBuffer.totalBytesUploaded()
+         + m_surfaceVertexBuffer.totalBytesUploaded() + m_surfaceNormalBuffer.totalBytesUploaded()
+         + m_surfaceIndexBuffer.totalBytesUploaded();
+}
+
+// --- Drawing ---
+
+void SceneRenderer::render(const QMatrix4x4& projection, const QMatrix4x4& view, bool proceduralGrid)
+{
+    const bool profiling = m_profiler && m_profiler->isEnabled();
+    if (profiling) {
+        // Results of earlier frames that the GPU has finished by now
+        m_gpuTimer.collect([this](quint64 frame, int stage, qint64 offsetNs, qint64 durationNs) {
+            m_profiler->addGpuEvent(STAGE_NAMES[stage], frame, offsetNs, durationNs);
+        });
+        m_gpuTimer.beginFrame(m_profiler->currentFrame());
+    }
+    m_stats = {};
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_DEPTH_TEST);
+
+    const QMatrix4x4 combined = projection * view;
+    if (m_levelOfDetail && (m_curveLodDirty || m_sceneLodDirty || combined != m_lodMatrix)) {
+        ProfileScope scope(m_profiler, "Level of detail");
+        updateLevelOfDetail(combined);
+    }
+
+    qint64 start = FrameProfiler::now();
+    drawGrid(combined, proceduralGrid);
+    endStage(STAGE_NAMES[0], start);
+
+    start = FrameProfiler::now();
+    drawAxes(combined);
+    endStage(STAGE_NAMES[1], start);
+
+    start = FrameProfiler::now();
+    drawSurfaces(combined, view);
+    endStage(STAGE_NAMES[2], start);
+
+    start = FrameProfiler::now();
+    drawScene(combined);
+    endStage(STAGE_NAMES[3], start);
+
+    start = FrameProfiler::now();
+    drawCurve(combined);
+    endStage(STAGE_NAMES[4], start);
+
+    start = FrameProfiler::now();
+    drawPoints(combined);
+    endStage(STAGE_NAMES[5], start);
+
+    if (profiling) m_gpuTimer.endFrame();
+}
+
+void SceneRenderer::endStage(const char *name, qint64 startNs)
+{
+    if (!m_profiler || !m_profiler->isEnabled()) return;
+
+    m_profiler->addEvent(name, ProfileEvent::Cpu, startNs, FrameProfiler::now() - startNs);
+    m_gpuTimer.endStage();
+}
+
+void SceneRenderer::drawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    glDrawArrays(mode, first, count);
+    ++m_stats.drawCalls;
+    m_stats.vertices += count;
+}
+
+void SceneRenderer::drawRuns(GpuBuffer& indexBuffer, const LodDrawList& list, const QVector<const void*>& offsets)
+{
+    m_stats.culledSegments += list.culledSegments;
+    const int runCount = list.runCounts.size();
+    if (runCount == 0 || !indexBuffer.bind()) return;
+
+    if (m_glMultiDrawElements) {
+        m_glMultiDrawElements(GL_LINE_STRIP, list.runCounts.constData(), GL_UNSIGNED_INT, offsets.constData(), runCount);
+        ++m_stats.drawCalls;
+    } else {
+        for (int i = 0; i < runCount; ++i) {
+            glDrawElements(GL_LINE_STRIP, list.runCounts[i], GL_UNSIGNED_INT, offsets[i]);
+        }
+        m_stats.drawCalls += runCount;
+    }
+    m_stats.vertices += list.indices.size();
+    indexBuffer.release();
+}
+
+void SceneRenderer::drawGrid(const QMatrix4x4& combined, bool procedural)
+{
+    if (procedural && m_gridProgramLinked) {
+        m_gridProgram.bind();
+        m_gridProgram.setUniformValue("matrix", combined);
+        m_gridProgram.setUniformValue("inverseMatrix", combined.inverted());
+        m_gridProgram.setUniformValue("color", GRID_COLOR);
+        m_gridProgram.setUniformValue("spacing", (float)GRID_SPACING);
+        m_gridProgram.setUniformValue("fadeDistance", 1000.0f);
+
+        // Anti-aliased lines are blended over the cleared background
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        bindStaticGeometry();
+        drawArrays(GL_TRIANGLE_STRIP, m_screenQuadFirst, 4);
+        releaseStaticGeometry();
+        glDisable(GL_BLEND);
+
+        m_gridProgram.release();
+        return;
+    }
+
+    m_program.bind();
+    m_program.setUniformValue(m_matrixUniform, combined);
+
+    bindStaticGeometry();
+
+    glLineWidth(1.0f);
+
+    // Set grid color (Darker gray/cyan for visibility against axes)
+    m_program.setUniformValue(m_colorUniform, GRID_COLOR);
+
+    // Draw all cached lines
+    drawArrays(GL_LINES, m_gridFirst, m_gridCount);
+
+    releaseStaticGeometry();
+    m_program.release();
+}
+
+void SceneRenderer::drawAxes(const QMatrix4x4& combined)
+{
+    m_program.bind();
+    m_program.setUniformValue(m_matrixUniform, combined);
+
+    bindStaticGeometry();
+
+    glLineWidth(2.0f);
+
+    // X-Axis (Red)
+    m_program.setUniformValue(m_colorUniform, QVector4D(1.0f, 0.0f, 0.0f, 1.0f));
+    drawArrays(GL_LINES, m_axesFirst, 2);
+
+    // Y-Axis (Green)
+    m_program.setUniformValue(m_colorUniform, QVector4D(0.0f, 1.0f, 0.0f, 1.0f));
+    drawArrays(GL_LINES, m_axesFirst + 2, 2);
+
+    // Z-Axis (Blue)
+    m_program.setUniformValue(m_colorUniform, QVector4D(0.0f, 0.0f, 1.0f, 1.0f));
+    drawArrays(GL_LINES, m_axesFirst + 4, 2);
+
+    releaseStaticGeometry();
+    m_program.release();
+}
+
+void SceneRenderer::drawSurfaces(const QMatrix4x4& combined, const QMatrix4x4& view)
+{
+    const qsizetype indexCount = m_surfaceIndexBuffer.count();
+    if (!m_surfaceProgramLinked || !m_surfaceVertexBuffer.isCreated() || indexCount == 0) return;
+
+    m_surfaceProgram.bind();
+    m_surfaceProgram.setUniformValue("matrix", combined);
+    m_surfaceProgram.setUniformValue("viewMatrix", view);
+    m_surfaceProgram.setUniformValue("color", QVector4D(0.75f, 0.55f, 0.3f, 1.0f));
+    m_surfaceProgram.setUniformValue("lightDirection", QVector3D(0.3f, 0.5f, 0.8f).normalized());
+
+    m_surfaceVertexBuffer.bind();
+    m_surfaceProgram.enableAttributeArray(POSITION_LOCATION);
+    m_surfaceProgram.setAttributeBuffer(POSITION_LOCATION, GL_FLOAT, 0, 3, 0);
+    m_surfaceVertexBuffer.release();
+
+    m_surfaceNormalBuffer.bind();
+    m_surfaceProgram.enableAttributeArray(NORMAL_LOCATION);
+    m_surfaceProgram.setAttributeBuffer(NORMAL_LOCATION, GL_FLOAT, 0, 3, 0);
+    m_surfaceNormalBuffer.release();
+
+    // Lines drawn later sit on the surface; push the triangles back so they stay visible
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.0f, 1.0f);
+    if (m_surfaceIndexBuffer.bind()) {
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT, nullptr);
+        ++m_stats.drawCalls;
+        m_stats.vertices += indexCount;
+        m_surfaceIndexBuffer.release();
+    }
+    glDisable(GL_POLYGON_OFFSET_FILL);
+
+    m_surfaceProgram.disableAttributeArray(NORMAL_LOCATION);
+    m_surfaceProgram.disableAttributeArray(POSITION_LOCATION);
+    m_surfaceProgram.release();
+}
+
+void SceneRenderer::drawScene(const QMatrix4x4& combined)
+{
+    const int curveCount = m_sceneFirsts.size();
+    if (!m_sceneBuffer.isCreated() || curveCount == 0) return;
+
+    m_program.bind();
+    m_program.setUniformValue(m_matrixUniform, combined);
+    m_program.setUniformValue(m_colorUniform, QVector4D(0.2f, 0.7f, 0.6f, 1.0f));
+
+    m_sceneBuffer.bind();
+    m_program.enableAttributeArray(m_posAttr);
+    m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+
+    glLineWidth(1.0f);
+
+    // Every curve is a slice of the same buffer: one call for the whole scene
+    if (m_levelOfDetail) {
+        drawRuns(m_sceneIndexBuffer, m_sceneLod, m_sceneLodOffsets);
+    } else if (m_glMultiDrawArrays) {
+        m_glMultiDrawArrays(GL_LINE_STRIP, m_sceneFirsts.constData(), m_sceneCounts.constData(), curveCount);
+        ++m_stats.drawCalls;
+        for (int count : m_sceneCounts) m_stats.vertices += count;
+    } else {
+        for (int i = 0; i < curveCount; ++i) {
+            drawArrays(GL_LINE_STRIP, m_sceneFirsts[i], m_sceneCounts[i]);
+        }
+    }
+
+    m_program.disableAttributeArray(m_posAttr);
+    m_sceneBuffer.release();
+    m_program.release();
+}
+
+void SceneRenderer::drawCurve(const QMatrix4x4& combined)
+{
+    if (m_gpuCurve) {
+        drawGpuCurve(combined);
+        return;
+    }
+
+    if (m_curveBuffer.isCreated() && m_curveBuffer.count() > 1) {
+
+        m_program.bind();
+        m_program.setUniformValue(m_matrixUniform, combined);
+
+        // Draw Control Polygon (Gray Line)
+        m_pointsBuffer.bind();
+        m_program.enableAttributeArray(m_posAttr);
+        m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+
+        m_program.setUniformValue(m_colorUniform, QVector4D(0.6f, 0.6f, 0.6f, 1.0f));
+        glLineWidth(1.0f);
+        drawArrays(GL_LINE_STRIP, 0, m_pointsBuffer.count());
+        m_pointsBuffer.release();
+
+        // Draw Calculated Curve (Blue Line)
+        m_curveBuffer.bind();
+        m_program.enableAttributeArray(m_posAttr);
+        m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+
+        m_program.setUniformValue(m_colorUniform, QVector4D(0.0f, 0.0f, 1.0f, 1.0f));
+        glLineWidth(3.0f);
+        if (m_levelOfDetail) {
+            drawRuns(m_curveIndexBuffer, m_curveLod, m_curveLodOffsets);
+        } else {
+            drawArrays(GL_LINE_STRIP, 0, m_curveBuffer.count());
+        }
+
+        m_program.disableAttributeArray(m_posAttr);
+        m_curveBuffer.release();
+        m_program.release();
+    }
+}
+
+void SceneRenderer::drawGpuCurve(const QMatrix4x4& combined)
+{
+    const qsizetype pointCount = m_pointsBuffer.count();
+    if (!m_pointsBuffer.isCreated() || !supportsGpuCurve(m_gpuCurveType, pointCount)) return;
+
+    // Control polygon, exactly as in drawCurve()
+    m_program.bind();
+    m_program.setUniformValue(m_matrixUniform, combined);
+    m_program.setUniformValue(m_colorUniform, QVector4D(0.6f, 0.6f, 0.6f, 1.0f));
+    m_pointsBuffer.bind();
+    m_program.enableAttributeArray(m_posAttr);
+    m_program.setAttributeBuffer(m_posAttr, GL_FLOAT, 0, 3, 0);
+    glLineWidth(1.0f);
+    drawArrays(GL_LINE_STRIP, 0, pointCount);
+    m_program.disableAttributeArray(m_posAttr);
+    m_pointsBuffer.release();
+    m_program.release();
+
+    const QVector4D curveColor(0.0f, 0.0f, 1.0f, 1.0f);
+    glLineWidth(3.0f);
+
+    if (m_gpuCurveType == CurveType::Bezier) {
+        m_bezierCurveProgram.bind();
+        m_bezierCurveProgram.setUniformValue("matrix", combined);
+        m_bezierCurveProgram.setUniformValue("color", curveColor);
+        // Uniforms live in the program, so they are only resent after an edit
+        if (m_bezierUniformsDirty) {
+            m_bezierCurveProgram.setUniformValueArray("controlPoints", m_bezierPoints.data(),
+                                                      static_cast<int>(m_bezierPointCount));
+            m_bezierCurveProgram.setUniformValue("pointCount", static_cast<GLint>(m_bezierPointCount));
+            m_bezierUniformsDirty = false;
+        }
+
+        m_parameterVbo.bind();
+        m_bezierCurveProgram.enableAttributeArray(PARAMETER_LOCATION);
+        glVertexAttribPointer(PARAMETER_LOCATION, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+        m_parameterVbo.release();
+
+        drawArrays(GL_LINE_STRIP, 0, CurveCalculator::SEGMENT_SAMPLES);
+
+        m_bezierCurveProgram.disableAttributeArray(PARAMETER_LOCATION);
+        m_bezierCurveProgram.release();
+        return;
+    }
+
+    m_cubicCurveProgram.bind();
+    m_cubicCurveProgram.setUniformValue("matrix", combined);
+    m_cubicCurveProgram.setUniformValue("color", curveColor);
+    m_cubicCurveProgram.setUniformValue("basis",
+                                        m_gpuCurveType == CurveType::BSpline ? BSPLINE_BASIS : CATMULL_ROM_BASIS);
+
+    m_parameterVbo.bind();
+    m_cubicCurveProgram.enableAttributeArray(PARAMETER_LOCATION);
+    glVertexAttribPointer(PARAMETER_LOCATION, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+    m_parameterVbo.release();
+
+    const qsizetype n = pointCount;
+    if (m_gpuCurveType == CurveType::BSpline) {
+        drawCubicInstances({ 0, 1, 2, 3 }, static_cast<GLsizei>(n - 3));
+    } else if (n == 2) {
+        drawCubicInstances({ 0, 0, 1, 1 }, 1);
+    } else {
+        // The end segments repeat the end points, as CurveCalculator pads the chain
+        drawCubicInstances({ 0, 0, 1, 2 }, 1);
+        if (n > 3) drawCubicInstances({ 0, 1, 2, 3 }, static_cast<GLsizei>(n - 3));
+        drawCubicInstances({ n - 3, n - 2, n - 1, n - 1 }, 1);
+    }
+
+    // Divisors are not part of any VAO here; reset them for the other programs
+    for (int i = 0; i < 4; ++i) {
+        m_glVertexAttribDivisor(CONTROL_POINT_LOCATION + i, 0);
+        glDisableVertexAttribArray(CONTROL_POINT_LOCATION + i);
+    }
+    m_cubicCurveProgram.disableAttributeArray(PARAMETER_LOCATION);
+    m_cubicCurveProgram.release();
+}
+
+// Instance i reads control points firstPoints[k] + i for p0..p3, straight from the point buffer
+void SceneRenderer::drawCubicInstances(const std::array<qsizetype, 4>& firstPoints, GLsizei instances)
+{
+    m_pointsBuffer.bind();
+    for (int i = 0; i < 4; ++i) {
+        glEnableVertexAttribArray(CONTROL_POINT_LOCATION + i);
+        glVertexAttribPointer(CONTROL_POINT_LOCATION + i, 3, GL_FLOAT, GL_FALSE, 0,
+                              reinterpret_cast<const void*>(static_cast<quintptr>(firstPoints[i]) * sizeof(QVector3D)));
+        m_glVertexAttribDivisor(CONTROL_POINT_LOCATION + i, 1);
+    }
+    m_pointsBuffer.release();
+
+    m_glDrawArraysInstanced(GL_LINE_STRIP, 0, CurveCalculator::SEGMENT_SAMPLES, instances);
+    ++m_stats.drawCalls;
+    m_stats.vertices += static_cast<qint64>(instances) * CurveCalculator::SEGMENT_SAMPLES;
+}
+
+void SceneRenderer::drawPoints(const QMatrix4x4& combined)
+{
+    if (m_pointsBuffer.isCreated() && m_pointStateBuffer.isCreated() && m_pointsBuffer.count() > 0) {
+        m_pointProgram.bind();
+        m_pointProgram.setUniformValue("matrix", combined);
+        m_pointProgram.setUniformValueArray("stateColors", POINT_STATE_COLORS, PointStateCount);
+        m_pointProgram.setUniformValue("pointSize", 10.0f);
+
+        m_pointsBuffer.bind();
+        m_pointProgram.enableAttributeArray(POSITION_LOCATION);
+        m_pointProgram.setAttributeBuffer(POSITION_LOCATION, GL_FLOAT, 0, 3, 0);
+        m_pointsBuffer.release();
+
+        // One byte per point: dragged, hovered and highlighted points differ only here
+        m_pointStateBuffer.bind();
+        // Not normalized: the shader indexes stateColors with the raw value
+        m_pointProgram.enableAttributeArray(STATE_LOCATION);
+        glVertexAttribPointer(STATE_LOCATION, 1, GL_UNSIGNED_BYTE, GL_FALSE, 0, nullptr);
+        m_pointStateBuffer.release();
+
+        drawArrays(GL_POINTS, 0, m_pointsBuffer.count());
+
+        m_pointProgram.disableAttributeArray(STATE_LOCATION);
+        m_pointProgram.disableAttributeArray(POSITION_LOCATION);
+        m_pointProgram.release();
+    }
+}
@@ -0,0 +1,212 @@
+//
+// SceneRenderer.h
+//
+
+#ifndef CURVES3D_SCENERENDERER_H
+#define CURVES3D_SCENERENDERER_H
+
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QMatrix4x4>
+#include <QSize>
+
+#include <array>
+
+#include "CurveLod.h"
+#include "CurveScene.h"
+#include "FrameProfiler.h"
+#include "GpuBuffer.h"
+#include "GpuStageTimer.h"
+#include "SurfaceTessellator.h"
+
+class QOpenGLContext;
+
+// Orbit camera around the origin, shared by the widget and offscreen rendering
+struct SceneCamera
+{
+    qreal rotationX = 3.0;
+    qreal rotationY = -45.0;
+    qreal zoomDistance = -300.0;
+
+    QMatrix4x4 viewMatrix() const;
+    QMatrix4x4 projectionMatrix(const QSize& viewport) const;
+};
+
+// The GL side of the viewer: shaders, buffers and draw calls for the grid,
+// axes, surfaces, scene curves, edited curve and control points. It owns no curve
+// data; callers pass what changed and the renderer forwards the dirty ranges
+// to its GpuBuffers. Drawing into a widget or an offscreen framebuffer is the
+// same code path. All calls need the context given to initialize() current.
+class SceneRenderer : protected QOpenGLFunctions
+{
+public:
+    // Per-vertex control point state, drawn with a colour per state
+    enum PointState : quint8 {
+        PointNormal,
+        PointHovered,
+        PointHighlighted,
+        PointDragged,
+        PointStateCount
+    };
+
+    // Compiles the programs and builds the static geometry; false if a required program fails
+    bool initialize(QOpenGLContext *context);
+    void destroy();
+
+    // Sets glViewport; the size also drives the level of detail
+    void setViewport(const QSize& size);
+
+    // segmentBounds as from CurveCache, with the boxes changed since the last
+    // call in dirtyBounds; empty draws the whole curve. Only dirty ranges are
+    // copied, the renderer never shares the caller's arrays.
+    void updateCurve(CurveType type, const QVector<QVector3D>& vertices, const IndexRange& dirty,
+                     const QVector<BoundingBox>& segmentBounds, const IndexRange& dirtyBounds, bool layoutChanged);
+    void updatePoints(const QList<QVector3D>& points, const IndexRange& dirty, bool layoutChanged);
+    void updatePointStates(const QVector<quint8>& states, const IndexRange& dirty, bool layoutChanged);
+    // dirtyVertices and dirtyBounds as from CurveScene; the draw ranges are
+    // only read when the layout changed
+    void updateScene(const SceneGeometry& geometry, const IndexRange& dirtyVertices,
+                     const IndexRange& dirtyBounds, bool layoutChanged);
+    // dirtyVertices as from SurfaceTessellator::updateGrid(); indices are only
+    // uploaded when the layout changed
+    void updateSurfaces(const SurfaceMesh& mesh, const IndexRange& dirtyVertices, bool layoutChanged);
+
+    // Draws the edited curve by evaluating it in the vertex shader straight
+    // from the control point buffer: Catmull-Rom and B-spline segments are
+    // instances reading four consecutive points, Bézier curves (up to
+    // MAX_GPU_BEZIER_POINTS) read their points from a uniform array. Moving a
+    // point then uploads just that point, and updateCurve() is not needed.
+    // Call setGpuCurve() before updatePoints() in a frame. B-splines of other
+    // degrees than cubic stay on the CPU.
+    static constexpr int MAX_GPU_BEZIER_POINTS = 32;
+    bool supportsGpuCurve(CurveType type, qsizetype pointCount,
+                          int degree = CurveCalculator::BSPLINE_DEGREE) const;
+    void setGpuCurve(bool enabled, CurveType type);
+
+    // Culls off-screen segments of the curve and scene and thins out the
+    // samples of small ones (see CurveLod); on by default
+    void setLevelOfDetail(bool enabled);
+
+    // Clears the bound framebuffer and draws everything
+    void render(const QMatrix4x4& projection, const QMatrix4x4& view, bool proceduralGrid);
+
+    // Bytes sent by all dynamic buffers so far
+    qint64 totalBytesUploaded() const;
+
+    // Work done by the last render()
+    struct RenderStats
+    {
+        int drawCalls = 0;
+        qint64 vertices = 0;
+        qsizetype culledSegments = 0;
+    };
+    const RenderStats& lastStats() const { return m_stats; }
+
+    // Times the level of detail and every draw stage, on the GPU too where
+    // timer queries exist; null or a disabled profiler turns timing off
+    void setProfiler(FrameProfiler *profiler) { m_profiler = profiler; }
+
+private:
+    void buildStaticGeometry();
+    void bindStaticGeometry();
+    void releaseStaticGeometry();
+    void drawGrid(const QMatrix4x4& combined, bool procedural);
+    void drawAxes(const QMatrix4x4& combined);
+    void drawSurfaces(const QMatrix4x4& combined, const QMatrix4x4& view);
+    void drawScene(const QMatrix4x4& combined);
+    void drawCurve(const QMatrix4x4& combined);
+    void drawPoints(const QMatrix4x4& combined);
+    void drawArrays(GLenum mode, GLint first, GLsizei count);
+    void drawGpuCurve(const QMatrix4x4& combined);
+    void drawCubicInstances(const std::array<qsizetype, 4>& firstPoints, GLsizei instances);
+    void drawRuns(GpuBuffer& indexBuffer, const LodDrawList& list, const QVector<const void*>& offsets);
+    void updateLevelOfDetail(const QMatrix4x4& combined);
+    void endStage(const char *name, qint64 startNs);
+
+    QOpenGLShaderProgram m_program;
+    QOpenGLShaderProgram m_pointProgram;
+    QOpenGLShaderProgram m_gridProgram;
+    bool m_gridProgramLinked = false;
+
+    // --- GPU Curve Evaluation ---
+    QOpenGLShaderProgram m_cubicCurveProgram;
+    QOpenGLShaderProgram m_bezierCurveProgram;
+    bool m_cubicCurveLinked = false;
+    bool m_bezierCurveLinked = false;
+    QOpenGLBuffer m_parameterVbo; // t of every sample in a segment, shared by all segments
+    bool m_gpuCurve = false;
+    CurveType m_gpuCurveType = CurveType::Bezier;
+    // Own copy of the points for the uniform array, taken only while the Bézier
+    // program draws the curve; never shares the caller's list
+    std::array<QVector3D, MAX_GPU_BEZIER_POINTS> m_bezierPoints;
+    qsizetype m_bezierPointCount = 0;
+    bool m_bezierPointsStale = true; // Edited while another path drew the curve
+    bool m_bezierUniformsDirty = true;
+
+    GpuBuffer m_curveBuffer;
+    GpuBuffer m_pointsBuffer;
+    GpuBuffer m_pointStateBuffer;
+    GpuBuffer m_sceneBuffer;
+    QVector<int> m_sceneFirsts;
+    QVector<int> m_sceneCounts;
+    QVector<CurveType> m_sceneTypes;
+    QVector<BoundingBox> m_sceneBounds;
+    QVector<qsizetype> m_sceneBoundsOffsets;
+
+    // --- Surfaces ---
+    QOpenGLShaderProgram m_surfaceProgram;
+    bool m_surfaceProgramLinked = false;
+    GpuBuffer m_surfaceVertexBuffer;
+    GpuBuffer m_surfaceNormalBuffer;
+    GpuBuffer m_surfaceIndexBuffer{ QOpenGLBuffer::StaticDraw, QOpenGLBuffer::IndexBuffer };
+
+    // --- Level of Detail (rebuilt when the view or the geometry changes) ---
+    bool m_levelOfDetail = true;
+    bool m_curveLodDirty = true; // Curve and scene lists are rebuilt independently
+    bool m_sceneLodDirty = true;
+    QSize m_viewportSize;
+    QMatrix4x4 m_lodMatrix;
+    CurveType m_curveType = CurveType::Bezier;
+    QVector<BoundingBox> m_curveBounds;
+    LodDrawList m_curveLod;
+    LodDrawList m_sceneLod;
+    QVector<const void*> m_curveLodOffsets; // Byte offsets of the runs, for glMultiDrawElements
+    QVector<const void*> m_sceneLodOffsets;
+    GpuBuffer m_curveIndexBuffer{ QOpenGLBuffer::DynamicDraw, QOpenGLBuffer::IndexBuffer };
+    GpuBuffer m_sceneIndexBuffer{ QOpenGLBuffer::DynamicDraw, QOpenGLBuffer::IndexBuffer };
+
+    using MultiDrawArraysFunction = void (QOPENGLF_APIENTRYP)(GLenum mode, const GLint *first,
+                                                               const GLsizei *count, GLsizei drawcount);
+    MultiDrawArraysFunction m_glMultiDrawArrays = nullptr;
+    using MultiDrawElementsFunction = void (QOPENGLF_APIENTRYP)(GLenum mode, const GLsizei *count, GLenum type,
+                                                                 const void *const *indices, GLsizei drawcount);
+    MultiDrawElementsFunction m_glMultiDrawElements = nullptr;
+    // GL 3.3 / ARB_instanced_arrays; without them only Bézier curves run on the GPU
+    using VertexAttribDivisorFunction = void (QOPENGLF_APIENTRYP)(GLuint index, GLuint divisor);
+    using DrawArraysInstancedFunction = void (QOPENGLF_APIENTRYP)(GLenum mode, GLint first, GLsizei count,
+                                                                   GLsizei instanceCount);
+    VertexAttribDivisorFunction m_glVertexAttribDivisor = nullptr;
+    DrawArraysInstancedFunction m_glDrawArraysInstanced = nullptr;
+
+    // --- Static Scene Geometry (built once in initialize) ---
+    QOpenGLVertexArrayObject m_staticVao;
+    QOpenGLBuffer m_staticVbo;
+    int m_axesFirst = 0;
+    int m_gridFirst = 0;
+    int m_gridCount = 0;
+    int m_screenQuadFirst = 0;
+
+    // --- Profiling ---
+    FrameProfiler *m_profiler = nullptr;
+    GpuStageTimer m_gpuTimer;
+    RenderStats m_stats;
+
+    // Shader Locations
+    int m_posAttr = -1;
+    int m_matrixUniform = -1;
+    int m_colorUniform = -1;
+};
+
+#endif //CURVES3D_SCENERENDERER_H
@@ -0,0 +1,53 @@
+//
+// SurfaceModel.cpp
+//
+
+#include "SurfaceModel.h"
+
+SurfaceModel::SurfaceModel(QObject *parent)
+    : QObject(parent) {}
+
+int SurfaceModel::addGrid(const ControlGrid& grid)
+{
+    Q_ASSERT(grid.points.size() == static_cast<qsizetype>(grid.rows) * grid.columns);
+    m_grids.append(grid);
+    emit gridsReset();
+    return m_grids.size() - 1;
+}
+
+void SurfaceModel::setGrid(int index, const ControlGrid& grid)
+{
+    Q_ASSERT(grid.points.size() == static_cast<qsizetype>(grid.rows) * grid.columns);
+    ControlGrid& current = m_grids[index];
+    const bool sameLayout = current.type == grid.type && current.rows == grid.rows && current.columns == grid.columns;
+    current = grid;
+
+    if (sameLayout) {
+        emit gridMoved(index);
+    } else {
+        emit gridsReset();
+    }
+}
+
+void SurfaceModel::setPoint(int index, int row, int column, const QVector3D& position)
+{
+    ControlGrid& grid = m_grids[index];
+    QVector3D& point = grid.points[row * grid.columns + column];
+    if (point == position) return;
+
+    point = position;
+    emit gridMoved(index);
+}
+
+void SurfaceModel::removeGrid(int index)
+{
+    m_grids.removeAt(index);
+    emit gridsReset();
+}
+
+void SurfaceModel::clear()
+{
+    if (m_grids.isEmpty()) return;
+    m_grids.clear();
+    emit gridsReset();
+}
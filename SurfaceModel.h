@@ -0,0 +1,42 @@
+//
+// SurfaceModel.h
+//
+
+#ifndef CURVES3D_SURFACEMODEL_H
+#define CURVES3D_SURFACEMODEL_H
+
+#include <QObject>
+#include <QList>
+
+#include "SurfaceTessellator.h"
+
+// Control grids of the surfaces shown with the curves. Like PointModel it
+// announces what changed: gridMoved when a grid kept its size (its patches
+// are re-evaluated in place), gridsReset when grids or their sizes changed.
+class SurfaceModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SurfaceModel(QObject *parent = nullptr);
+
+    const QList<ControlGrid>& grids() const { return m_grids; }
+    int count() const { return m_grids.size(); }
+    const ControlGrid& grid(int index) const { return m_grids.at(index); }
+
+    // Returns the new grid's index
+    int addGrid(const ControlGrid& grid);
+    void setGrid(int index, const ControlGrid& grid);
+    void setPoint(int index, int row, int column, const QVector3D& position);
+    void removeGrid(int index);
+    void clear();
+
+    signals:
+        void gridMoved(int index);
+        void gridsReset();
+
+private:
+    QList<ControlGrid> m_grids;
+};
+
+#endif //CURVES3D_SURFACEMODEL_H
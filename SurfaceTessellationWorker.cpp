@@ -0,0 +1,132 @@
+//
+// SurfaceTessellationWorker.cpp
+//
+
+#include "SurfaceTessellationWorker.h"
+#include "FrameProfiler.h"
+
+#include <QMutexLocker>
+#include <QThread>
+
+ControlGrid SurfaceJob::detachedCopy(const ControlGrid& grid)
+{
+    ControlGrid copy;
+    copy.type = grid.type;
+    copy.rows = grid.rows;
+    copy.columns = grid.columns;
+    copy.points = QVector<QVector3D>(grid.points.cbegin(), grid.points.cend());
+    return copy;
+}
+
+void SurfaceResult::applyTo(SurfaceMesh& mesh) const
+{
+    applySlice(mesh.vertices, vertexCount, vertices, dirty);
+    applySlice(mesh.normals, vertexCount, normals, dirty);
+    if (layoutChanged) {
+        mesh.indices = indices;
+        mesh.gridVertexOffsets = gridVertexOffsets;
+    }
+}
+
+SurfaceTessellationWorker::SurfaceTessellationWorker(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<SurfaceResult>();
+
+    m_thread = QThread::create([this] { run(); });
+    m_thread->setObjectName("SurfaceTessellationWorker");
+    m_thread->start();
+}
+
+SurfaceTessellationWorker::~SurfaceTessellationWorker()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_jobAvailable.wakeOne();
+    }
+    m_thread->wait();
+    delete m_thread;
+}
+
+quint64 SurfaceTessellationWorker::submit(SurfaceJob job)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Edited grids replace their counterparts in the waiting job
+    if (m_hasPendingJob && !job.reset) {
+        for (qsizetype i = 0; i < job.gridIndices.size(); ++i) {
+            const int index = job.gridIndices[i];
+            if (m_pendingJob.reset) {
+                m_pendingJob.grids[index] = std::move(job.grids[i]);
+                continue;
+            }
+            const qsizetype slot = m_pendingJob.gridIndices.indexOf(index);
+            if (slot >= 0) {
+                m_pendingJob.grids[slot] = std::move(job.grids[i]);
+            } else {
+                m_pendingJob.gridIndices.append(index);
+                m_pendingJob.grids.append(std::move(job.grids[i]));
+            }
+        }
+        job = std::move(m_pendingJob);
+    }
+    m_pendingJob = std::move(job);
+    m_hasPendingJob = true;
+    m_jobAvailable.wakeOne();
+    return ++m_latestGeneration;
+}
+
+void SurfaceTessellationWorker::run()
+{
+    forever {
+        SurfaceJob job;
+        quint64 generation = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_hasPendingJob && !m_quit) {
+                m_jobAvailable.wait(&m_mutex);
+            }
+            if (m_quit) return;
+
+            job = std::move(m_pendingJob);
+            m_hasPendingJob = false;
+            generation = m_latestGeneration;
+        }
+
+        const qint64 startNs = FrameProfiler::now();
+        SurfaceResult result;
+        result.generation = generation;
+        result.layoutChanged = job.reset;
+        if (job.reset) {
+            m_grids = std::move(job.grids);
+        } else {
+            for (qsizetype i = 0; i < job.gridIndices.size(); ++i) {
+                m_grids[job.gridIndices[i]] = std::move(job.grids[i]);
+            }
+        }
+
+        const std::span<const ControlGrid> grids(m_grids.constData(), static_cast<size_t>(m_grids.size()));
+        if (job.reset) {
+            m_tessellator.tessellate(grids, m_mesh);
+            result.dirty = { 0, m_mesh.vertices.size() };
+            result.indices = QVector<quint32>(m_mesh.indices.cbegin(), m_mesh.indices.cend());
+            result.gridVertexOffsets = QVector<qsizetype>(m_mesh.gridVertexOffsets.cbegin(),
+                                                          m_mesh.gridVertexOffsets.cend());
+        } else {
+            for (int index : job.gridIndices) {
+                result.dirty.unite(m_tessellator.updateGrid(grids, index, m_mesh));
+            }
+        }
+
+        // Only the rewritten vertices are copied; no array of the worker's mesh is shared
+        result.vertexCount = m_mesh.vertices.size();
+        IndexRange normalsRange = result.dirty;
+        result.vertices = sliceOf(m_mesh.vertices, result.dirty);
+        result.normals = sliceOf(m_mesh.normals, normalsRange);
+        result.evaluationStartNs = startNs;
+        result.evaluationNs = FrameProfiler::now() - startNs;
+
+        emit resultReady(result);
+    }
+}
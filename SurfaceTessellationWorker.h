@@ -0,0 +1,94 @@
+//
+// SurfaceTessellationWorker.h
+//
+
+#ifndef CURVES3D_SURFACETESSELLATIONWORKER_H
+#define CURVES3D_SURFACETESSELLATIONWORKER_H
+
+#include "SurfaceTessellator.h"
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QWaitCondition>
+
+class QThread;
+
+// Grids to tessellate; each submission supersedes every earlier one. A reset
+// carries every grid, otherwise grids[i] replaces grid gridIndices[i] of the
+// previous job. Grids travel as copies the job owns (see detachedCopy()), so
+// a later edit of the model never copies a whole grid on the GUI thread.
+struct SurfaceJob
+{
+    bool reset = false;
+    QList<int> gridIndices; // Without reset
+    QList<ControlGrid> grids;
+
+    // A grid whose points share nothing with the original
+    static ControlGrid detachedCopy(const ControlGrid& grid);
+};
+
+// Tessellated surfaces handed back to the GUI thread. Only what changed since
+// the previous delivered result travels: vertices and normals hold
+// [dirty.first, dirty.end()) of the mesh, and the indices and grid offsets
+// are only sent when the layout changed.
+struct SurfaceResult
+{
+    quint64 generation = 0;
+    qsizetype vertexCount = 0;
+    QVector<QVector3D> vertices;
+    QVector<QVector3D> normals;
+    IndexRange dirty;
+    bool layoutChanged = false;
+    QVector<quint32> indices;             // With layoutChanged
+    QVector<qsizetype> gridVertexOffsets; // With layoutChanged
+    // When the delivered job started and how long it took, on FrameProfiler::now()'s clock
+    qint64 evaluationStartNs = 0;
+    qint64 evaluationNs = 0;
+
+    // Brings the receiver's copy of the mesh up to date
+    void applyTo(SurfaceMesh& mesh) const;
+};
+
+Q_DECLARE_METATYPE(SurfaceResult)
+
+// Tessellates surfaces on a dedicated thread with the latest-wins semantics
+// of CurveEvaluationWorker: a job still waiting is replaced by a newer
+// submission (grid edits are folded into it), and results are delivered in
+// order through resultReady, queued to the receiver's thread. Receivers must
+// apply every result, since each carries only the vertices changed since the
+// last. The patches of one job are still spread across threads by
+// SurfaceTessellator.
+class SurfaceTessellationWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SurfaceTessellationWorker(QObject *parent = nullptr);
+    ~SurfaceTessellationWorker() override;
+
+    // Returns the generation the eventual result will carry
+    quint64 submit(SurfaceJob job);
+
+signals:
+    void resultReady(const SurfaceResult& result);
+
+private:
+    void run();
+
+    QThread *m_thread = nullptr;
+
+    QMutex m_mutex;
+    QWaitCondition m_jobAvailable;
+    SurfaceJob m_pendingJob;
+    bool m_hasPendingJob = false;
+    bool m_quit = false;
+    quint64 m_latestGeneration = 0;
+
+    // Worker thread only
+    SurfaceTessellator m_tessellator;
+    QList<ControlGrid> m_grids;
+    SurfaceMesh m_mesh;
+};
+
+#endif //CURVES3D_SURFACETESSELLATIONWORKER_H
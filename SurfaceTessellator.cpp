@@ -0,0 +1,177 @@
+//
+// SurfaceTessellator.cpp
+//
+
+#include "SurfaceTessellator.h"
+#include "CurveBasis.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+
+namespace {
+
+// Below this many patches per thread the thread start-up costs more than it saves
+constexpr qsizetype PARALLEL_THRESHOLD = 16;
+
+constexpr std::array<qreal, 4> bernsteinWeights(qreal t)
+{
+    const qreal s = 1.0 - t;
+    return { s * s * s, 3.0 * s * s * t, 3.0 * s * t * t, t * t * t };
+}
+
+constexpr std::array<qreal, 4> bernsteinDerivativeWeights(qreal t)
+{
+    const qreal s = 1.0 - t;
+    return { -3.0 * s * s, 3.0 * s * s - 6.0 * s * t, 6.0 * s * t - 3.0 * t * t, 3.0 * t * t };
+}
+
+}
+
+int ControlGrid::patchesAlong(int count) const
+{
+    if (type == SurfaceType::Bezier) {
+        return count >= 4 ? (count - 1) / 3 : 0;
+    }
+    return std::max(count - 3, 0);
+}
+
+SurfaceTessellator::SurfaceTessellator(int resolution)
+    : m_resolution(std::max(resolution, 1))
+{
+    auto fill = [this](BasisRows& rows, auto weights, auto derivativeWeights) {
+        rows.values.resize(m_resolution + 1);
+        rows.derivatives.resize(m_resolution + 1);
+        for (int i = 0; i <= m_resolution; ++i) {
+            const qreal t = static_cast<qreal>(i) / m_resolution;
+            const std::array<qreal, 4> w = weights(t);
+            const std::array<qreal, 4> d = derivativeWeights(t);
+            for (int k = 0; k < 4; ++k) {
+                rows.values[i][k] = static_cast<float>(w[k]);
+                rows.derivatives[i][k] = static_cast<float>(d[k]);
+            }
+        }
+    };
+    fill(m_bezier, bernsteinWeights, bernsteinDerivativeWeights);
+    fill(m_bspline, CurveBasis::bsplineWeights, CurveBasis::bsplineDerivativeWeights);
+}
+
+const SurfaceTessellator::BasisRows& SurfaceTessellator::basisRows(SurfaceType type) const
+{
+    return type == SurfaceType::Bezier ? m_bezier : m_bspline;
+}
+
+void SurfaceTessellator::tessellate(std::span<const ControlGrid> grids, SurfaceMesh& mesh, int threadCount) const
+{
+    // Layout first, so every patch knows where its vertices and indices go
+    QVector<qsizetype> patchOffsets(static_cast<qsizetype>(grids.size()) + 1);
+    patchOffsets[0] = 0;
+    for (size_t g = 0; g < grids.size(); ++g) {
+        patchOffsets[g + 1] = patchOffsets[g] + grids[g].patchCount();
+    }
+    const qsizetype patchCount = patchOffsets.last();
+
+    mesh.gridVertexOffsets.resize(patchOffsets.size());
+    for (qsizetype g = 0; g < patchOffsets.size(); ++g) {
+        mesh.gridVertexOffsets[g] = patchOffsets[g] * verticesPerPatch();
+    }
+    mesh.vertices.resize(patchCount * verticesPerPatch());
+    mesh.normals.resize(mesh.vertices.size());
+    mesh.indices.resize(patchCount * indicesPerPatch());
+
+    QVector3D *vertices = mesh.vertices.data();
+    QVector3D *normals = mesh.normals.data();
+    quint32 *indices = mesh.indices.data();
+
+    parallelFor(patchCount, PARALLEL_THRESHOLD, threadCount, [&](qsizetype patch) {
+        const qsizetype grid = std::upper_bound(patchOffsets.cbegin(), patchOffsets.cend(), patch)
+                             - patchOffsets.cbegin() - 1;
+        const ControlGrid& controlGrid = grids[static_cast<size_t>(grid)];
+        const qsizetype local = patch - patchOffsets[grid];
+        const qsizetype firstVertex = patch * verticesPerPatch();
+
+        evaluatePatch(controlGrid, static_cast<int>(local / controlGrid.patchColumns()),
+                      static_cast<int>(local % controlGrid.patchColumns()),
+                      vertices + firstVertex, normals + firstVertex);
+        writePatchIndices(static_cast<quint32>(firstVertex), indices + patch * indicesPerPatch());
+    });
+}
+
+IndexRange SurfaceTessellator::updateGrid(std::span<const ControlGrid> grids, qsizetype grid, SurfaceMesh& mesh,
+                                          int threadCount) const
+{
+    const ControlGrid& controlGrid = grids[static_cast<size_t>(grid)];
+    const qsizetype firstVertex = mesh.gridVertexOffsets[grid];
+    Q_ASSERT(mesh.gridVertexOffsets[grid + 1] - firstVertex == controlGrid.patchCount() * verticesPerPatch());
+
+    QVector3D *vertices = mesh.vertices.data() + firstVertex;
+    QVector3D *normals = mesh.normals.data() + firstVertex;
+
+    parallelFor(controlGrid.patchCount(), PARALLEL_THRESHOLD, threadCount, [&](qsizetype patch) {
+        evaluatePatch(controlGrid, static_cast<int>(patch / controlGrid.patchColumns()),
+                      static_cast<int>(patch % controlGrid.patchColumns()),
+                      vertices + patch * verticesPerPatch(), normals + patch * verticesPerPatch());
+    });
+    return { firstVertex, controlGrid.patchCount() * verticesPerPatch() };
+}
+
+void SurfaceTessellator::evaluatePatch(const ControlGrid& grid, int patchRow, int patchColumn,
+                                       QVector3D *vertices, QVector3D *normals) const
+{
+    const BasisRows& basis = basisRows(grid.type);
+    // Bézier patches share their edge rows, B-spline patches slide by one
+    const int step = grid.type == SurfaceType::Bezier ? 3 : 1;
+    const int firstRow = patchRow * step;
+    const int firstColumn = patchColumn * step;
+
+    QVector3D p[4][4];
+    for (int a = 0; a < 4; ++a) {
+        for (int b = 0; b < 4; ++b) {
+            p[a][b] = grid.at(firstRow + a, firstColumn + b);
+        }
+    }
+
+    for (int j = 0; j <= m_resolution; ++j) {
+        // Rows blended at this v: the patch reduces to a cubic curve in u and its v-derivative
+        const Weights& wv = basis.values[j];
+        const Weights& dv = basis.derivatives[j];
+        QVector3D q[4];
+        QVector3D dq[4];
+        for (int b = 0; b < 4; ++b) {
+            q[b] = p[0][b] * wv[0] + p[1][b] * wv[1] + p[2][b] * wv[2] + p[3][b] * wv[3];
+            dq[b] = p[0][b] * dv[0] + p[1][b] * dv[1] + p[2][b] * dv[2] + p[3][b] * dv[3];
+        }
+
+        for (int i = 0; i <= m_resolution; ++i) {
+            const Weights& wu = basis.values[i];
+            const Weights& du = basis.derivatives[i];
+            const qsizetype index = static_cast<qsizetype>(j) * (m_resolution + 1) + i;
+
+            vertices[index] = q[0] * wu[0] + q[1] * wu[1] + q[2] * wu[2] + q[3] * wu[3];
+            const QVector3D tangentU = q[0] * du[0] + q[1] * du[1] + q[2] * du[2] + q[3] * du[3];
+            const QVector3D tangentV = dq[0] * wu[0] + dq[1] * wu[1] + dq[2] * wu[2] + dq[3] * wu[3];
+            // Not normalized(): its fuzzy zero test would also drop normals of small-scale grids
+            const QVector3D normal = QVector3D::crossProduct(tangentU, tangentV);
+            const float length = normal.length();
+            normals[index] = length > 0.0f ? normal / length : QVector3D();
+        }
+    }
+}
+
+void SurfaceTessellator::writePatchIndices(quint32 firstVertex, quint32 *indices) const
+{
+    const quint32 stride = static_cast<quint32>(m_resolution + 1);
+    for (int j = 0; j < m_resolution; ++j) {
+        for (int i = 0; i < m_resolution; ++i) {
+            const quint32 v00 = firstVertex + static_cast<quint32>(j) * stride + static_cast<quint32>(i);
+            const quint32 v01 = v00 + 1;
+            const quint32 v10 = v00 + stride;
+            const quint32 v11 = v10 + 1;
+            *indices++ = v00;
+            *indices++ = v01;
+            *indices++ = v11;
+            *indices++ = v00;
+            *indices++ = v11;
+            *indices++ = v10;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+//
+// SurfaceTessellator.h
+//
+
+#ifndef CURVES3D_SURFACETESSELLATOR_H
+#define CURVES3D_SURFACETESSELLATOR_H
+
+#include <QVector3D>
+#include <QVector>
+
+#include <array>
+#include <span>
+
+#include "IndexRange.h"
+
+enum class SurfaceType
+{
+    Bezier,     // Bicubic Bézier patches sharing edge rows: (3m + 1) x (3n + 1) points
+    BSpline     // Uniform bicubic B-spline: every 4 x 4 window of the grid is a patch
+};
+
+// Control grid of a patch network, row-major: rows run along v, columns along u
+struct ControlGrid
+{
+    SurfaceType type = SurfaceType::BSpline;
+    int rows = 0;
+    int columns = 0;
+    QVector<QVector3D> points;
+
+    const QVector3D& at(int row, int column) const { return points[row * columns + column]; }
+
+    int patchRows() const { return patchesAlong(rows); }
+    int patchColumns() const { return patchesAlong(columns); }
+    qsizetype patchCount() const { return static_cast<qsizetype>(patchRows()) * patchColumns(); }
+
+private:
+    int patchesAlong(int count) const;
+};
+
+// Triangle mesh of one or more grids: every patch owns a contiguous block of
+// (resolution + 1)^2 vertices and 6 * resolution^2 indices, in grid and
+// patch order, so a patch can be re-evaluated in place.
+struct SurfaceMesh
+{
+    QVector<QVector3D> vertices;
+    QVector<QVector3D> normals;     // Unit length, zero where the surface degenerates
+    QVector<quint32> indices;       // GL_TRIANGLES
+    QVector<qsizetype> gridVertexOffsets; // grids + 1 entries
+
+    qsizetype triangleCount() const { return indices.size() / 3; }
+};
+
+// Tessellates bicubic patches at a fixed resolution. The weights of the
+// four control rows (and their derivatives, for normals) at every sample
+// are computed once; u and v share them. A patch first blends its four rows
+// for a v sample, then sweeps u over the four blended points, so a sample
+// costs four weighted sums instead of sixteen. Patches are independent and
+// are spread across threads.
+class SurfaceTessellator
+{
+public:
+    static constexpr int DEFAULT_RESOLUTION = 16;
+
+    // Quads along each patch edge
+    explicit SurfaceTessellator(int resolution = DEFAULT_RESOLUTION);
+    int resolution() const { return m_resolution; }
+
+    qsizetype verticesPerPatch() const { return static_cast<qsizetype>(m_resolution + 1) * (m_resolution + 1); }
+    qsizetype indicesPerPatch() const { return static_cast<qsizetype>(6) * m_resolution * m_resolution; }
+
+    // Builds the whole mesh on threadCount threads (0 = one per hardware thread)
+    void tessellate(std::span<const ControlGrid> grids, SurfaceMesh& mesh, int threadCount = 0) const;
+
+    // Re-evaluates the vertices of one grid whose size is unchanged; the
+    // indices stay valid. Returns the rewritten vertex range.
+    IndexRange updateGrid(std::span<const ControlGrid> grids, qsizetype grid, SurfaceMesh& mesh,
+                          int threadCount = 0) const;
+
+private:
+    using Weights = std::array<float, 4>;
+    struct BasisRows
+    {
+        QVector<Weights> values;      // resolution + 1 samples
+        QVector<Weights> derivatives;
+    };
+
+    const BasisRows& basisRows(SurfaceType type) const;
+    void evaluatePatch(const ControlGrid& grid, int patchRow, int patchColumn,
+                       QVector3D *vertices, QVector3D *normals) const;
+    void writePatchIndices(quint32 firstVertex, quint32 *indices) const;
+
+    int m_resolution;
+    BasisRows m_bezier;
+    BasisRows m_bspline;
+};
+
+#endif //CURVES3D_SURFACETESSELLATOR_H
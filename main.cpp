@@ -1,12 +1,173 @@
 #include <QApplication>
-#include <QPushButton>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include <QSurfaceFormat>
+#include <QTextStream>
 
-#include "mainwindow.h"
-#include <QApplication>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "MainWindow.h"
+#include "OffscreenRenderer.h"
+#include "SceneFile.h"
+
+namespace {
+
+// Must be decided before the application object exists, so argv is scanned directly
+bool hasArgument(int argc, char *argv[], const char *name)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) return true;
+    }
+    return false;
+}
+
+bool parseSize(const QString& text, QSize& size)
+{
+    const QStringList parts = text.split('x');
+    if (parts.size() != 2) return false;
+    bool okWidth = false;
+    bool okHeight = false;
+    size = QSize(parts[0].toInt(&okWidth), parts[1].toInt(&okHeight));
+    return okWidth && okHeight && !size.isEmpty();
+}
+
+bool parseCamera(const QString& text, SceneCamera& camera)
+{
+    const QStringList parts = text.split(',');
+    if (parts.size() != 3) return false;
+    bool ok[3] = {};
+    camera.rotationX = parts[0].toDouble(&ok[0]);
+    camera.rotationY = parts[1].toDouble(&ok[1]);
+    camera.zoomDistance = parts[2].toDouble(&ok[2]);
+    return ok[0] && ok[1] && ok[2];
+}
+
+void printFrameTimes(QTextStream& out, const QString& name, QVector<double> times)
+{
+    if (times.isEmpty()) return;
+    std::sort(times.begin(), times.end());
+    const double mean = std::accumulate(times.cbegin(), times.cend(), 0.0) / times.size();
+    out << name << ": " << times.size() << " frames, ms min " << times.first()
+        << " median " << times[times.size() / 2] << " mean " << mean
+        << " max " << times.last() << Qt::endl;
+}
+
+// Renders every scene file to <output dir>/<base name>.png; returns the exit code
+int runHeadless(const QCommandLineParser& parser)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QSize size(800, 600);
+    if (parser.isSet("size") && !parseSize(parser.value("size"), size)) {
+        err << "Invalid --size, expected WIDTHxHEIGHT" << Qt::endl;
+        return 1;
+    }
+    SceneCamera camera;
+    if (parser.isSet("camera") && !parseCamera(parser.value("camera"), camera)) {
+        err << "Invalid --camera, expected rotationX,rotationY,distance" << Qt::endl;
+        return 1;
+    }
+    bool framesOk = true;
+    const int frames = parser.isSet("frames") ? parser.value("frames").toInt(&framesOk) : 0;
+    if (!framesOk || frames < 0) {
+        err << "Invalid --frames" << Qt::endl;
+        return 1;
+    }
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        err << "No scene files given" << Qt::endl;
+        return 1;
+    }
+
+    const QDir outputDir(parser.isSet("output-dir") ? parser.value("output-dir") : QDir::currentPath());
+    if (!outputDir.exists() && !QDir().mkpath(outputDir.path())) {
+        err << "Cannot create " << outputDir.path() << Qt::endl;
+        return 1;
+    }
+
+    OffscreenRenderer renderer;
+    QString error;
+    if (!renderer.create(size, &error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+    renderer.setCamera(camera);
+    renderer.setProceduralGrid(parser.isSet("procedural-grid"));
+    renderer.setGpuEvaluation(parser.isSet("gpu-curves"));
+    out << "Renderer: " << renderer.rendererName() << Qt::endl;
+
+    int exitCode = 0;
+    for (const QString& file : files) {
+        QList<SceneCurve> curves;
+        if (!SceneFile::load(file, curves, &error)) {
+            err << file << ": " << error << Qt::endl;
+            exitCode = 1;
+            continue;
+        }
+        renderer.setScene(curves);
+
+        const QString imagePath = outputDir.filePath(QFileInfo(file).completeBaseName() + ".png");
+        if (!renderer.renderImage().save(imagePath)) {
+            err << "Cannot write " << imagePath << Qt::endl;
+            exitCode = 1;
+            continue;
+        }
+        out << imagePath << Qt::endl;
+
+        if (frames > 0) {
+            printFrameTimes(out, QFileInfo(file).fileName(), renderer.timeFrames(frames));
+        }
+    }
+    return exitCode;
+}
+
+void addOptions(QCommandLineParser& parser)
+{
+    parser.addHelpOption();
+    parser.addPositionalArgument("scenes", "Scene files to render in headless mode.", "[scenes...]");
+    parser.addOptions({
+        { "headless", "Render the scene files to PNG without opening a window." },
+        { { "o", "output-dir" }, "Directory for the rendered images.", "dir" },
+        { "size", "Image size, default 800x600.", "WxH" },
+        { "camera", "Camera rotation in degrees and distance, default 3,-45,-300.", "rx,ry,distance" },
+        { "frames", "Also time this many frames per scene.", "count" },
+        { "procedural-grid", "Draw the grid with the fragment shader." },
+        { "gpu-curves", "Evaluate the edited curve in the vertex shader." },
+        { "software-gl", "Use the software OpenGL rasterizer." },
+    });
+}
+
+}
 
 int main(int argc, char *argv[]) {
+    const bool headless = hasArgument(argc, argv, "--headless");
+    if (hasArgument(argc, argv, "--software-gl")) {
+        // Mesa picks llvmpipe from the environment; Qt's flag covers Windows
+        qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+        QCoreApplication::setAttribute(Qt::AA_UseSoftwareOpenGL);
+    }
+
+    if (headless) {
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QGuiApplication a(argc, argv);
+        QCommandLineParser parser;
+        addOptions(parser);
+        parser.process(a);
+        return runHeadless(parser);
+    }
+
     QApplication a(argc, argv);
+    QCommandLineParser parser;
+    addOptions(parser);
+    parser.process(a);
+
     MainWindow w;
     w.show();
     return a.exec();
-}
\ No newline at end of file
+}
@@ -0,0 +1,47 @@
+//
+// TestPoints.h
+//
+
+#ifndef CURVES3D_TESTPOINTS_H
+#define CURVES3D_TESTPOINTS_H
+
+#include <QList>
+#include <QVector3D>
+
+#include <cmath>
+#include <span>
+
+// Control-point fixtures shared by the core library tests
+namespace TestPoints {
+
+// Wavy control polygon, the same on every run
+inline QList<QVector3D> wave(qsizetype count)
+{
+    QList<QVector3D> points;
+    points.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        const float t = static_cast<float>(i);
+        points.append(QVector3D(t * 10.0f, 25.0f * std::sin(t * 0.7f), 15.0f * std::cos(t * 1.3f)));
+    }
+    return points;
+}
+
+// Evenly spaced points on the x axis
+inline QList<QVector3D> line(qsizetype count, float spacing)
+{
+    QList<QVector3D> points;
+    points.reserve(count);
+    for (qsizetype i = 0; i < count; ++i) {
+        points.append(QVector3D(spacing * static_cast<float>(i), 0.0f, 0.0f));
+    }
+    return points;
+}
+
+inline std::span<const QVector3D> spanOf(const QList<QVector3D>& points)
+{
+    return std::span<const QVector3D>(points.constData(), static_cast<size_t>(points.size()));
+}
+
+}
+
+#endif //CURVES3D_TESTPOINTS_H
@@ -0,0 +1,114 @@
+//
+// tst_arclengthtable.cpp
+//
+
+#include <QTest>
+
+#include "ArcLengthTable.h"
+#include "TestPoints.h"
+
+class TestArcLengthTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void straightLinesHaveTheirLength();
+    void parameterAtInvertsLengthAt();
+    void updateSegmentsMatchesRebuild();
+    void uniformSamplesAreEvenlySpaced();
+    void emptyCurve();
+};
+
+void TestArcLengthTable::straightLinesHaveTheirLength()
+{
+    // Derivatives come from float control points, so exact means within float rounding
+    const qreal tolerance = 1e-6;
+    ArcLengthTable table;
+
+    // A Bézier curve over collinear, evenly spaced points is the straight line itself
+    table.rebuild(CurveType::Bezier, TestPoints::line(4, 10.0f));
+    QVERIFY(qAbs(table.totalLength() - 30.0) < 30.0 * tolerance);
+
+    // Uniform B-splines reproduce linear functions: each segment spans one spacing
+    table.rebuild(CurveType::BSpline, TestPoints::line(9, 5.0f));
+    QCOMPARE(table.segmentCount(), qsizetype(6));
+    QVERIFY(qAbs(table.totalLength() - 30.0) < 30.0 * tolerance);
+    for (qsizetype segment = 0; segment < table.segmentCount(); ++segment) {
+        QVERIFY(qAbs(table.segmentLength(segment) - 5.0) < 5.0 * tolerance);
+    }
+
+    // Any degree reproduces them, with n - degree segments
+    table.rebuild(CurveType::BSpline, TestPoints::line(9, 5.0f), 2);
+    QCOMPARE(table.segmentCount(), qsizetype(7));
+    QVERIFY(qAbs(table.totalLength() - 35.0) < 35.0 * tolerance);
+}
+
+void TestArcLengthTable::parameterAtInvertsLengthAt()
+{
+    for (CurveType type : { CurveType::Bezier, CurveType::Hermite, CurveType::BSpline }) {
+        ArcLengthTable table;
+        table.rebuild(type, TestPoints::wave(type == CurveType::Bezier ? 7 : 20));
+        const qreal total = table.totalLength();
+        QVERIFY(total > 0.0);
+
+        for (int k = 0; k <= 50; ++k) {
+            const qreal distance = total * k / 50.0;
+            const ArcLengthParameter parameter = table.parameterAt(distance);
+            QVERIFY(parameter.isValid());
+            QVERIFY(qAbs(table.lengthAt(parameter.segment, parameter.t) - distance) < 1e-6 * total);
+        }
+
+        // Out-of-range distances clamp to the ends
+        QCOMPARE(table.pointAt(-1.0), table.pointAt(0.0));
+        QCOMPARE(table.pointAt(total * 2.0), table.pointAt(total));
+    }
+}
+
+void TestArcLengthTable::updateSegmentsMatchesRebuild()
+{
+    QList<QVector3D> points = TestPoints::wave(30);
+    ArcLengthTable table;
+    table.rebuild(CurveType::Hermite, points);
+
+    const qsizetype index = 12;
+    points[index] += QVector3D(3.0f, -8.0f, 5.0f);
+    qsizetype firstSegment = 0;
+    qsizetype lastSegment = 0;
+    CurveCalculator::affectedSegments(CurveType::Hermite, points.size(), index, firstSegment, lastSegment);
+    table.updateSegments(points, firstSegment, lastSegment);
+
+    ArcLengthTable expected;
+    expected.rebuild(CurveType::Hermite, points);
+    QVERIFY(qAbs(table.totalLength() - expected.totalLength()) < 1e-9 * expected.totalLength());
+    for (qsizetype segment = 0; segment < expected.segmentCount(); ++segment) {
+        QVERIFY(qAbs(table.segmentLength(segment) - expected.segmentLength(segment)) < 1e-9 * expected.totalLength());
+    }
+}
+
+void TestArcLengthTable::uniformSamplesAreEvenlySpaced()
+{
+    // Along a straight B-spline, equal arc lengths are equal chords
+    ArcLengthTable table;
+    table.rebuild(CurveType::BSpline, TestPoints::line(12, 7.0f));
+
+    QVector<QVector3D> samples(33);
+    table.sampleUniform(std::span<QVector3D>(samples.data(), static_cast<size_t>(samples.size())));
+    const qreal step = table.totalLength() / (samples.size() - 1);
+    for (qsizetype i = 1; i < samples.size(); ++i) {
+        QVERIFY(qAbs((samples[i] - samples[i - 1]).length() - step) < 1e-4);
+    }
+    QVERIFY((samples.first() - table.pointAt(0.0)).length() < 1e-5f);
+    QVERIFY((samples.last() - table.pointAt(table.totalLength())).length() < 1e-5f);
+}
+
+void TestArcLengthTable::emptyCurve()
+{
+    ArcLengthTable table;
+    table.rebuild(CurveType::BSpline, TestPoints::line(3, 1.0f));
+    QVERIFY(table.isEmpty());
+    QCOMPARE(table.totalLength(), 0.0);
+    QVERIFY(!table.parameterAt(1.0).isValid());
+}
+
+QTEST_APPLESS_MAIN(TestArcLengthTable)
+#include "tst_arclengthtable.moc"
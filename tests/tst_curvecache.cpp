@@ -0,0 +1,204 @@
+//
+// tst_curvecache.cpp
+//
+
+#include <QTest>
+
+#include "CurveCache.h"
+#include "TestPoints.h"
+
+namespace {
+
+// A cache that evaluated the points in one go
+CurveCache rebuilt(CurveType type, const QList<QVector3D>& points, int degree = CurveCalculator::BSPLINE_DEGREE)
+{
+    CurveCache cache;
+    cache.setType(type);
+    cache.setDegree(degree);
+    cache.setControlPoints(points);
+    return cache;
+}
+
+bool sameBounds(const QVector<BoundingBox>& a, const QVector<BoundingBox>& b)
+{
+    if (a.size() != b.size()) return false;
+    for (qsizetype i = 0; i < a.size(); ++i) {
+        if (a[i].min != b[i].min || a[i].max != b[i].max) return false;
+    }
+    return true;
+}
+
+}
+
+// Moving points patches the local support in place; the result must be
+// exactly what a full rebuild produces, and the dirty ranges must cover
+// everything that changed
+class TestCurveCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void movePointMatchesRebuild();
+    void movePointsMatchesRebuild();
+    void setControlPointsMatchesRebuild();
+    void dirtyRangesCoverChanges();
+    void pointCountChangeReportsLayout();
+    void otherDegreesMatchRebuild();
+    void degreeChangeRebuilds();
+    void arcLengthFollowsMoves();
+};
+
+void TestCurveCache::movePointMatchesRebuild()
+{
+    for (CurveType type : { CurveType::Bezier, CurveType::Hermite, CurveType::BSpline }) {
+        QList<QVector3D> points = TestPoints::wave(type == CurveType::Bezier ? 6 : 40);
+        CurveCache cache = rebuilt(type, points);
+
+        for (int k = 0; k < 25; ++k) {
+            const qsizetype index = (k * 7) % points.size();
+            points[index] += QVector3D(1.5f, -2.0f, 0.25f * k);
+            cache.movePoint(index, points[index]);
+
+            const CurveCache expected = rebuilt(type, points);
+            QCOMPARE(cache.vertices(), expected.vertices());
+            QVERIFY(sameBounds(cache.segmentBounds(), expected.segmentBounds()));
+        }
+    }
+}
+
+void TestCurveCache::movePointsMatchesRebuild()
+{
+    for (CurveType type : { CurveType::Hermite, CurveType::BSpline }) {
+        QList<QVector3D> points = TestPoints::wave(64);
+        CurveCache cache = rebuilt(type, points);
+
+        // A few moves are patched, many fall back to one rebuild; both must agree
+        for (qsizetype moves : { 3, 40 }) {
+            QList<qsizetype> indices;
+            QList<QVector3D> positions;
+            for (qsizetype i = 0; i < moves; ++i) {
+                const qsizetype index = (i * 11 + moves) % points.size();
+                points[index] += QVector3D(0.0f, 3.0f, -1.0f);
+                indices.append(index);
+                positions.append(points[index]);
+            }
+            cache.movePoints(indices, positions);
+
+            const CurveCache expected = rebuilt(type, points);
+            QCOMPARE(cache.vertices(), expected.vertices());
+            QVERIFY(sameBounds(cache.segmentBounds(), expected.segmentBounds()));
+        }
+    }
+}
+
+void TestCurveCache::setControlPointsMatchesRebuild()
+{
+    QList<QVector3D> points = TestPoints::wave(30);
+    CurveCache cache = rebuilt(CurveType::BSpline, points);
+
+    points[4] = QVector3D(-5.0f, 8.0f, 2.0f);
+    points[20] = QVector3D(7.0f, -3.0f, 1.0f);
+    cache.setControlPoints(points);
+    QCOMPARE(cache.vertices(), rebuilt(CurveType::BSpline, points).vertices());
+}
+
+void TestCurveCache::dirtyRangesCoverChanges()
+{
+    QList<QVector3D> points = TestPoints::wave(50);
+    CurveCache cache = rebuilt(CurveType::Hermite, points);
+    cache.takeDirtyVertices();
+    cache.takeDirtyBounds();
+    cache.takeLayoutChanged();
+
+    const QVector<QVector3D> verticesBefore = cache.vertices();
+    const QVector<BoundingBox> boundsBefore = cache.segmentBounds();
+    points[25] += QVector3D(4.0f, 4.0f, 4.0f);
+    cache.movePoint(25, points[25]);
+
+    const IndexRange dirty = cache.takeDirtyVertices();
+    const IndexRange dirtyBounds = cache.takeDirtyBounds();
+    QVERIFY(!dirty.isEmpty());
+    QVERIFY(dirty.count < cache.vertices().size());
+    QVERIFY(!cache.takeLayoutChanged());
+
+    for (qsizetype i = 0; i < verticesBefore.size(); ++i) {
+        if (i < dirty.first || i >= dirty.end()) QCOMPARE(cache.vertices()[i], verticesBefore[i]);
+    }
+    for (qsizetype i = 0; i < boundsBefore.size(); ++i) {
+        if (i >= dirtyBounds.first && i < dirtyBounds.end()) continue;
+        QCOMPARE(cache.segmentBounds()[i].min, boundsBefore[i].min);
+        QCOMPARE(cache.segmentBounds()[i].max, boundsBefore[i].max);
+    }
+}
+
+void TestCurveCache::pointCountChangeReportsLayout()
+{
+    CurveCache cache = rebuilt(CurveType::BSpline, TestPoints::wave(10));
+    cache.takeLayoutChanged();
+
+    cache.setControlPoints(TestPoints::wave(11));
+    QVERIFY(cache.takeLayoutChanged());
+    const IndexRange dirty = cache.takeDirtyVertices();
+    QCOMPARE(dirty.first, qsizetype(0));
+    QCOMPARE(dirty.count, cache.vertices().size());
+}
+
+void TestCurveCache::otherDegreesMatchRebuild()
+{
+    for (int degree : { 1, 2, 5 }) {
+        QList<QVector3D> points = TestPoints::wave(30);
+        CurveCache cache = rebuilt(CurveType::BSpline, points, degree);
+        QCOMPARE(cache.segmentBounds().size(), qsizetype(30 - degree));
+        QCOMPARE(cache.vertices().size(), (30 - degree) * CurveCalculator::SEGMENT_SAMPLES);
+
+        for (int k = 0; k < 12; ++k) {
+            const qsizetype index = (k * 5) % points.size();
+            points[index] += QVector3D(-1.0f, 2.5f, 0.5f * k);
+            cache.movePoint(index, points[index]);
+
+            const CurveCache expected = rebuilt(CurveType::BSpline, points, degree);
+            QCOMPARE(cache.vertices(), expected.vertices());
+            QVERIFY(sameBounds(cache.segmentBounds(), expected.segmentBounds()));
+        }
+    }
+}
+
+void TestCurveCache::degreeChangeRebuilds()
+{
+    const QList<QVector3D> points = TestPoints::wave(12);
+    CurveCache cache = rebuilt(CurveType::BSpline, points);
+    cache.takeLayoutChanged();
+
+    cache.setDegree(4);
+    QVERIFY(cache.takeLayoutChanged());
+    QCOMPARE(cache.vertices(), rebuilt(CurveType::BSpline, points, 4).vertices());
+
+    // Too few points for the degree: the points themselves, as for the cubic
+    cache.setDegree(12);
+    QCOMPARE(cache.vertices(), points);
+    QVERIFY(cache.segmentBounds().isEmpty());
+}
+
+void TestCurveCache::arcLengthFollowsMoves()
+{
+    for (int degree : { 2, 3 }) {
+        QList<QVector3D> points = TestPoints::wave(40);
+        CurveCache cache = rebuilt(CurveType::BSpline, points, degree);
+        QVERIFY(cache.arcLength().totalLength() > 0.0);
+
+        // Moves re-integrate their segments only; the totals must match a fresh table
+        for (int k = 0; k < 6; ++k) {
+            const qsizetype index = (k * 13) % points.size();
+            points[index] += QVector3D(4.0f, -1.0f, 2.0f);
+            cache.movePoint(index, points[index]);
+            if (k % 2 == 0) continue; // Several moves between two lookups
+
+            ArcLengthTable expected;
+            expected.rebuild(CurveType::BSpline, points, degree);
+            QVERIFY(qAbs(cache.arcLength().totalLength() - expected.totalLength()) < 1e-9 * expected.totalLength());
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(TestCurveCache)
+#include "tst_curvecache.moc"
@@ -0,0 +1,108 @@
+//
+// tst_curvecalculator.cpp
+//
+
+#include <QTest>
+
+#include "CurveCalculator.h"
+#include "NurbsEvaluator.h"
+#include "TestPoints.h"
+
+namespace {
+
+bool fuzzyEqual(const QVector3D& a, const QVector3D& b, float tolerance)
+{
+    return (a - b).length() <= tolerance * std::max(1.0f, b.length());
+}
+
+}
+
+// B-splines of any degree: n - degree segments evaluated span by span, which
+// must agree with one whole-curve evaluation and with the cubic fast path
+class TestCurveCalculator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cubicDegreeUsesCubicPath();
+    void segmentsMatchWholeCurve();
+    void derivativeMatchesFiniteDifference();
+    void layoutFollowsDegree();
+};
+
+void TestCurveCalculator::cubicDegreeUsesCubicPath()
+{
+    const QList<QVector3D> points = TestPoints::wave(20);
+    QVector<QVector3D> cubic(CurveCalculator::outputSize(CurveType::BSpline, points.size()));
+    CurveCalculator::evaluate(CurveType::BSpline, TestPoints::spanOf(points),
+                              std::span<QVector3D>(cubic.data(), static_cast<size_t>(cubic.size())));
+    QCOMPARE(CurveCalculator::calculateBSpline(points, 3), cubic);
+}
+
+void TestCurveCalculator::segmentsMatchWholeCurve()
+{
+    const QList<QVector3D> points = TestPoints::wave(16);
+    for (int degree : { 1, 2, 4, 5 }) {
+        NurbsCurve curve;
+        curve.degree = degree;
+        curve.controlPoints = points;
+        curve.knots = NurbsCurve::uniformKnots(points.size(), degree);
+        NurbsEvaluator whole(curve);
+
+        const QVector<QVector3D> samples = CurveCalculator::calculateBSpline(points, degree);
+        const qsizetype segments = CurveCalculator::segmentCount(CurveType::BSpline, points.size(), degree);
+        QCOMPARE(samples.size(), segments * CurveCalculator::SEGMENT_SAMPLES);
+
+        for (qsizetype segment = 0; segment < segments; ++segment) {
+            for (qreal t : { 0.0, 0.3, 0.75 }) {
+                const QVector3D expected = whole.point(degree + segment + t);
+                const QVector3D actual = CurveCalculator::segmentPoint(CurveType::BSpline, TestPoints::spanOf(points),
+                                                                       segment, t, degree);
+                QVERIFY(fuzzyEqual(actual, expected, 1e-5f));
+            }
+            const qsizetype offset = CurveCalculator::segmentVertexOffset(CurveType::BSpline, segment);
+            QVERIFY(fuzzyEqual(samples[offset], whole.point(degree + segment), 1e-5f));
+        }
+    }
+}
+
+void TestCurveCalculator::derivativeMatchesFiniteDifference()
+{
+    const QList<QVector3D> points = TestPoints::wave(12);
+    const qreal h = 1e-3;
+    for (int degree : { 1, 2, 3, 5 }) {
+        const qsizetype segments = CurveCalculator::segmentCount(CurveType::BSpline, points.size(), degree);
+        for (qsizetype segment = 0; segment < segments; ++segment) {
+            const qreal t = 0.4;
+            const QVector3D ahead = CurveCalculator::segmentPoint(CurveType::BSpline, TestPoints::spanOf(points),
+                                                                  segment, t + h, degree);
+            const QVector3D behind = CurveCalculator::segmentPoint(CurveType::BSpline, TestPoints::spanOf(points),
+                                                                   segment, t - h, degree);
+            const QVector3D derivative = CurveCalculator::segmentDerivative(CurveType::BSpline,
+                                                                            TestPoints::spanOf(points),
+                                                                            segment, t, degree);
+            QVERIFY(fuzzyEqual(derivative, (ahead - behind) / float(2 * h), 1e-2f));
+        }
+    }
+}
+
+void TestCurveCalculator::layoutFollowsDegree()
+{
+    QCOMPARE(CurveCalculator::segmentCount(CurveType::BSpline, 10, 2), qsizetype(8));
+    QCOMPARE(CurveCalculator::outputSize(CurveType::BSpline, 10, 5), 5 * CurveCalculator::SEGMENT_SAMPLES);
+    // Fewer than degree + 1 points: no segments, the points are drawn as they are
+    QCOMPARE(CurveCalculator::segmentCount(CurveType::BSpline, 5, 5), qsizetype(0));
+    QCOMPARE(CurveCalculator::outputSize(CurveType::BSpline, 5, 5), qsizetype(5));
+
+    qsizetype first = 0;
+    qsizetype last = 0;
+    CurveCalculator::affectedSegments(CurveType::BSpline, 10, 4, first, last, 2);
+    QCOMPARE(first, qsizetype(2));
+    QCOMPARE(last, qsizetype(4));
+    CurveCalculator::segmentSupport(CurveType::BSpline, 10, 3, first, last, 2);
+    QCOMPARE(first, qsizetype(3));
+    QCOMPARE(last, qsizetype(5));
+}
+
+QTEST_APPLESS_MAIN(TestCurveCalculator)
+#include "tst_curvecalculator.moc"
@@ -0,0 +1,152 @@
+//
+// tst_curvekernels.cpp
+//
+
+#include <QTest>
+
+#include "CurveCalculator.h"
+#include "CurveKernels.h"
+#include "TestPoints.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using TestPoints::spanOf;
+
+QVector<QVector3D> evaluate(CurveType type, const QList<QVector3D>& points, BasisEvaluation mode)
+{
+    QVector<QVector3D> out(CurveCalculator::outputSize(type, points.size()));
+    const qsizetype written = CurveCalculator::evaluate(type, spanOf(points),
+                                                        std::span<QVector3D>(out.data(), static_cast<size_t>(out.size())),
+                                                        mode);
+    out.resize(written);
+    return out;
+}
+
+// Control points split into axes for CurveKernels
+struct SoAStorage
+{
+    explicit SoAStorage(const QList<QVector3D>& points)
+    {
+        for (const QVector3D& p : points) {
+            x.append(p.x());
+            y.append(p.y());
+            z.append(p.z());
+        }
+    }
+
+    SoAPoints points() const { return { x.constData(), y.constData(), z.constData(), x.size() }; }
+
+    QVector<float> x;
+    QVector<float> y;
+    QVector<float> z;
+};
+
+QVector<QVector3D> evaluateSegments(CubicSegmentBasis basis, const QList<QVector3D>& points, SimdIsa isa)
+{
+    const SoAStorage input(points);
+    const qsizetype size = CurveKernels::segmentCount(basis, points.size()) * CurveCalculator::SEGMENT_SAMPLES;
+    QVector<float> x(size), y(size), z(size);
+    const qsizetype written = CurveKernels::evaluateSegments(basis, input.points(),
+                                                             { x.data(), y.data(), z.data() }, isa);
+
+    QVector<QVector3D> out;
+    out.reserve(written);
+    for (qsizetype i = 0; i < written; ++i) {
+        out.append(QVector3D(x[i], y[i], z[i]));
+    }
+    return out;
+}
+
+QList<SimdIsa> supportedIsas()
+{
+    QList<SimdIsa> isas;
+    for (SimdIsa isa : { SimdIsa::Scalar, SimdIsa::SSE2, SimdIsa::AVX2 }) {
+        if (CurveKernels::isSupported(isa)) isas.append(isa);
+    }
+    return isas;
+}
+
+}
+
+// The vectorized kernels must reproduce CurveCalculator exactly, except
+// where CurveKernels documents a tolerance
+class TestCurveKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void simdBSplineMatchesCalculator();
+    void simdHermiteMatchesCalculator();
+    void simdCatmullRomWithinTolerance();
+    void vectorizedModeMatchesTabulated();
+};
+
+void TestCurveKernels::simdBSplineMatchesCalculator()
+{
+    // Odd counts leave partial SIMD blocks at the end of every segment
+    for (qsizetype count : { 4, 7, 33 }) {
+        const QList<QVector3D> points = TestPoints::wave(count);
+        const QVector<QVector3D> expected = evaluate(CurveType::BSpline, points, BasisEvaluation::Tabulated);
+        for (SimdIsa isa : supportedIsas()) {
+            QCOMPARE(evaluateSegments(CubicSegmentBasis::UniformBSpline, points, isa), expected);
+        }
+    }
+}
+
+void TestCurveKernels::simdHermiteMatchesCalculator()
+{
+    // Groups of four: P1, P4, R1, R4
+    const QList<QVector3D> points = TestPoints::wave(12);
+    QVector<QVector3D> expected;
+    for (qsizetype first = 0; first + 4 <= points.size(); first += 4) {
+        QVector<QVector3D> segment(CurveCalculator::SEGMENT_SAMPLES);
+        CurveCalculator::evaluateHermite(points[first], points[first + 1], points[first + 2], points[first + 3],
+                                         std::span<QVector3D>(segment.data(), static_cast<size_t>(segment.size())));
+        expected.append(segment);
+    }
+
+    for (SimdIsa isa : supportedIsas()) {
+        QCOMPARE(evaluateSegments(CubicSegmentBasis::Hermite, points, isa), expected);
+    }
+}
+
+void TestCurveKernels::simdCatmullRomWithinTolerance()
+{
+    const QList<QVector3D> points = TestPoints::wave(9);
+    QVector<QVector3D> expected;
+    float largest = 0.0f;
+    for (qsizetype i = 0; i + 4 <= points.size(); ++i) {
+        expected.append(CurveCalculator::calculateCatmullRomSegment(points[i], points[i + 1], points[i + 2], points[i + 3]));
+    }
+    for (const QVector3D& p : expected) {
+        largest = std::max({ largest, std::abs(p.x()), std::abs(p.y()), std::abs(p.z()) });
+    }
+
+    // Point-form weights against the tangent form: equal up to rounding
+    for (SimdIsa isa : supportedIsas()) {
+        const QVector<QVector3D> out = evaluateSegments(CubicSegmentBasis::CatmullRom, points, isa);
+        QCOMPARE(out.size(), expected.size());
+        for (qsizetype i = 0; i < out.size(); ++i) {
+            QVERIFY2((out[i] - expected[i]).length() <= 1e-6f * largest * 2.0f,
+                     qPrintable(QString("sample %1 on %2").arg(i).arg(CurveKernels::isaName(isa))));
+        }
+    }
+}
+
+void TestCurveKernels::vectorizedModeMatchesTabulated()
+{
+    const QList<QVector3D> points = TestPoints::wave(21);
+    QCOMPARE(evaluate(CurveType::BSpline, points, BasisEvaluation::Vectorized),
+             evaluate(CurveType::BSpline, points, BasisEvaluation::Tabulated));
+
+    // Bézier curves have no vectorized path and stay tabulated
+    const QList<QVector3D> bezier = TestPoints::wave(6);
+    QCOMPARE(evaluate(CurveType::Bezier, bezier, BasisEvaluation::Vectorized),
+             evaluate(CurveType::Bezier, bezier, BasisEvaluation::Tabulated));
+}
+
+QTEST_APPLESS_MAIN(TestCurveKernels)
+#include "tst_curvekernels.moc"
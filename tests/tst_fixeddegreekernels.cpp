@@ -0,0 +1,70 @@
+//
+// tst_fixeddegreekernels.cpp
+//
+
+#include <QTest>
+
+#include "CurveCalculator.h"
+#include "FixedDegreeKernels.h"
+#include "TestPoints.h"
+
+namespace {
+
+using TestPoints::spanOf;
+
+QVector<QVector3D> evaluate(CurveType type, const QList<QVector3D>& points)
+{
+    QVector<QVector3D> out(CurveCalculator::outputSize(type, points.size()));
+    CurveCalculator::evaluate(type, spanOf(points), std::span<QVector3D>(out.data(), static_cast<size_t>(out.size())));
+    return out;
+}
+
+QVector<QVector3D> evaluate(FixedDegreeKernels::Evaluator evaluator, CurveType type, const QList<QVector3D>& points)
+{
+    QVector<QVector3D> out(CurveCalculator::outputSize(type, points.size()));
+    evaluator(spanOf(points), std::span<QVector3D>(out.data(), static_cast<size_t>(out.size())));
+    return out;
+}
+
+}
+
+// The specializations must reproduce the tabulated CurveCalculator output exactly
+class TestFixedDegreeKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void bezierMatchesTabulated();
+    void bsplineMatchesTabulated();
+    void noSpecializationOutsideRange();
+};
+
+void TestFixedDegreeKernels::bezierMatchesTabulated()
+{
+    for (int degree = FixedDegreeKernels::MIN_BEZIER_DEGREE; degree <= FixedDegreeKernels::MAX_BEZIER_DEGREE; ++degree) {
+        const QList<QVector3D> points = TestPoints::wave(degree + 1);
+        const FixedDegreeKernels::Evaluator evaluator = FixedDegreeKernels::find(CurveType::Bezier, points.size());
+        QVERIFY(evaluator);
+        QCOMPARE(evaluate(evaluator, CurveType::Bezier, points), evaluate(CurveType::Bezier, points));
+    }
+}
+
+void TestFixedDegreeKernels::bsplineMatchesTabulated()
+{
+    for (qsizetype count : { 4, 5, 17, 64 }) {
+        const QList<QVector3D> points = TestPoints::wave(count);
+        const FixedDegreeKernels::Evaluator evaluator = FixedDegreeKernels::find(CurveType::BSpline, count);
+        QVERIFY(evaluator);
+        QCOMPARE(evaluate(evaluator, CurveType::BSpline, points), evaluate(CurveType::BSpline, points));
+    }
+}
+
+void TestFixedDegreeKernels::noSpecializationOutsideRange()
+{
+    QVERIFY(!FixedDegreeKernels::find(CurveType::Bezier, FixedDegreeKernels::MAX_BEZIER_DEGREE + 2));
+    QVERIFY(!FixedDegreeKernels::find(CurveType::Bezier, FixedDegreeKernels::MIN_BEZIER_DEGREE));
+    QVERIFY(!FixedDegreeKernels::find(CurveType::BSpline, 3));
+}
+
+QTEST_APPLESS_MAIN(TestFixedDegreeKernels)
+#include "tst_fixeddegreekernels.moc"
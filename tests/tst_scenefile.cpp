@@ -0,0 +1,142 @@
+//
+// tst_scenefile.cpp
+//
+
+#include <QTest>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "SceneFile.h"
+
+namespace {
+
+QList<SceneCurve> makeCurves()
+{
+    QList<SceneCurve> curves;
+    curves.append(SceneCurve{ CurveType::Bezier, { QVector3D(0, 0, 0), QVector3D(1, 2, 3), QVector3D(-4.5f, 5, 6) } });
+    curves.append(SceneCurve{ CurveType::Hermite, {} });
+    SceneCurve spline{ CurveType::BSpline, {} };
+    for (int i = 0; i < 1000; ++i) {
+        spline.controlPoints.append(QVector3D(i * 0.5f, -i * 0.25f, i * 1e-3f));
+    }
+    curves.append(spline);
+    return curves;
+}
+
+bool save(const QString& path, const QList<SceneCurve>& curves)
+{
+    return SceneFile::save(path, std::span<const SceneCurve>(curves.constData(), static_cast<size_t>(curves.size())));
+}
+
+// Overwrites bytes of an existing file
+void patchFile(const QString& path, qint64 offset, const QByteArray& bytes)
+{
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.seek(offset));
+    QCOMPARE(file.write(bytes), bytes.size());
+}
+
+}
+
+class TestSceneFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void rejectsMissingFile();
+    void rejectsWrongMagic();
+    void rejectsUnsupportedVersion();
+    void rejectsTruncatedFile();
+    void rejectsCorruptCurveRecord();
+
+private:
+    // Loading must fail with a message and leave the output list alone
+    void verifyRejected(const QString& path);
+
+    QTemporaryDir m_dir;
+};
+
+void TestSceneFile::verifyRejected(const QString& path)
+{
+    QList<SceneCurve> curves = { SceneCurve{ CurveType::Bezier, { QVector3D(9, 9, 9) } } };
+    QString error;
+    QVERIFY(!SceneFile::load(path, curves, &error));
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(curves.size(), qsizetype(1));
+    QCOMPARE(curves.first().controlPoints.first(), QVector3D(9, 9, 9));
+}
+
+void TestSceneFile::roundTrip()
+{
+    QVERIFY(m_dir.isValid());
+    const QString path = m_dir.filePath("round-trip.c3ds");
+    const QList<SceneCurve> curves = makeCurves();
+    QVERIFY(save(path, curves));
+
+    QList<SceneCurve> loaded;
+    QString error;
+    QVERIFY2(SceneFile::load(path, loaded, &error), qPrintable(error));
+    QCOMPARE(loaded.size(), curves.size());
+    for (qsizetype i = 0; i < curves.size(); ++i) {
+        QVERIFY(loaded[i].type == curves[i].type);
+        QCOMPARE(loaded[i].controlPoints, curves[i].controlPoints);
+    }
+}
+
+void TestSceneFile::rejectsMissingFile()
+{
+    verifyRejected(m_dir.filePath("missing.c3ds"));
+}
+
+void TestSceneFile::rejectsWrongMagic()
+{
+    const QString path = m_dir.filePath("magic.c3ds");
+    QVERIFY(save(path, makeCurves()));
+    patchFile(path, 0, QByteArray("XXXX"));
+    verifyRejected(path);
+
+    // Shorter than a header
+    const QString tiny = m_dir.filePath("tiny.c3ds");
+    QFile file(tiny);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("C3DS");
+    file.close();
+    verifyRejected(tiny);
+}
+
+void TestSceneFile::rejectsUnsupportedVersion()
+{
+    const QString path = m_dir.filePath("version.c3ds");
+    QVERIFY(save(path, makeCurves()));
+    patchFile(path, 4, QByteArray("\x63\x00\x00\x00", 4));
+    verifyRejected(path);
+}
+
+void TestSceneFile::rejectsTruncatedFile()
+{
+    const QString path = m_dir.filePath("truncated.c3ds");
+    QVERIFY(save(path, makeCurves()));
+    QFile file(path);
+    QVERIFY(file.resize(file.size() - 4));
+    verifyRejected(path);
+}
+
+void TestSceneFile::rejectsCorruptCurveRecord()
+{
+    // The first curve record follows the 32-byte header: an unknown type
+    const QString badType = m_dir.filePath("bad-type.c3ds");
+    QVERIFY(save(badType, makeCurves()));
+    patchFile(badType, 32, QByteArray("\xff\x00\x00\x00", 4));
+    verifyRejected(badType);
+
+    // A point count larger than the point block
+    const QString badCount = m_dir.filePath("bad-count.c3ds");
+    QVERIFY(save(badCount, makeCurves()));
+    patchFile(badCount, 32 + 8, QByteArray("\xff\xff\x00\x00\x00\x00\x00\x00", 8));
+    verifyRejected(badCount);
+}
+
+QTEST_APPLESS_MAIN(TestSceneFile)
+#include "tst_scenefile.moc"
@@ -0,0 +1,175 @@
+//
+// tst_surfacetessellator.cpp
+//
+
+#include <QTest>
+
+#include "SurfaceTessellator.h"
+
+#include <array>
+#include <cmath>
+
+namespace {
+
+constexpr int RESOLUTION = 8;
+
+ControlGrid makeGrid(SurfaceType type, int patches)
+{
+    ControlGrid grid;
+    grid.type = type;
+    grid.rows = type == SurfaceType::Bezier ? 3 * patches + 1 : patches + 3;
+    grid.columns = grid.rows;
+    for (int row = 0; row < grid.rows; ++row) {
+        for (int column = 0; column < grid.columns; ++column) {
+            grid.points.append(QVector3D(column * 10.0f, 6.0f * std::sin(row * 0.8f + column * 0.5f), row * 10.0f));
+        }
+    }
+    return grid;
+}
+
+// Reference basis functions in double precision
+std::array<double, 4> basis(SurfaceType type, double t)
+{
+    const double s = 1.0 - t;
+    if (type == SurfaceType::Bezier) {
+        return { s * s * s, 3.0 * s * s * t, 3.0 * s * t * t, t * t * t };
+    }
+    return { s * s * s / 6.0,
+             (3.0 * t * t * t - 6.0 * t * t + 4.0) / 6.0,
+             (-3.0 * t * t * t + 3.0 * t * t + 3.0 * t + 1.0) / 6.0,
+             t * t * t / 6.0 };
+}
+
+// Tensor-product point of one patch, evaluated term by term
+QVector3D surfacePoint(const ControlGrid& grid, int patchRow, int patchColumn, double u, double v)
+{
+    const int step = grid.type == SurfaceType::Bezier ? 3 : 1;
+    const std::array<double, 4> bu = basis(grid.type, u);
+    const std::array<double, 4> bv = basis(grid.type, v);
+    double x = 0.0, y = 0.0, z = 0.0;
+    for (int a = 0; a < 4; ++a) {
+        for (int b = 0; b < 4; ++b) {
+            const QVector3D& p = grid.at(patchRow * step + a, patchColumn * step + b);
+            const double w = bv[a] * bu[b];
+            x += w * p.x();
+            y += w * p.y();
+            z += w * p.z();
+        }
+    }
+    return QVector3D(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+}
+
+std::span<const ControlGrid> spanOf(const QList<ControlGrid>& grids)
+{
+    return std::span<const ControlGrid>(grids.constData(), static_cast<size_t>(grids.size()));
+}
+
+}
+
+class TestSurfaceTessellator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void patchCounts();
+    void verticesMatchTensorProduct();
+    void flatGridHasUnitNormals();
+    void updateGridMatchesTessellate();
+    void threadCountDoesNotChangeResult();
+};
+
+void TestSurfaceTessellator::patchCounts()
+{
+    QCOMPARE(makeGrid(SurfaceType::Bezier, 3).patchCount(), qsizetype(9));
+    QCOMPARE(makeGrid(SurfaceType::BSpline, 4).patchCount(), qsizetype(16));
+
+    ControlGrid tooSmall;
+    tooSmall.rows = 3;
+    tooSmall.columns = 3;
+    QCOMPARE(tooSmall.patchCount(), qsizetype(0));
+}
+
+void TestSurfaceTessellator::verticesMatchTensorProduct()
+{
+    const SurfaceTessellator tessellator(RESOLUTION);
+    for (SurfaceType type : { SurfaceType::Bezier, SurfaceType::BSpline }) {
+        const QList<ControlGrid> grids = { makeGrid(type, 2) };
+        const ControlGrid& grid = grids.first();
+        SurfaceMesh mesh;
+        tessellator.tessellate(spanOf(grids), mesh);
+
+        QCOMPARE(mesh.vertices.size(), grid.patchCount() * tessellator.verticesPerPatch());
+        QCOMPARE(mesh.indices.size(), grid.patchCount() * tessellator.indicesPerPatch());
+
+        // Patches in row-major order, samples with u along a row and v across rows
+        for (qsizetype patch = 0; patch < grid.patchCount(); ++patch) {
+            const int patchRow = static_cast<int>(patch / grid.patchColumns());
+            const int patchColumn = static_cast<int>(patch % grid.patchColumns());
+            for (int j = 0; j <= RESOLUTION; ++j) {
+                for (int i = 0; i <= RESOLUTION; ++i) {
+                    const QVector3D expected = surfacePoint(grid, patchRow, patchColumn,
+                                                            double(i) / RESOLUTION, double(j) / RESOLUTION);
+                    const QVector3D& actual = mesh.vertices[patch * tessellator.verticesPerPatch()
+                                                            + j * (RESOLUTION + 1) + i];
+                    QVERIFY((actual - expected).length() < 1e-3f);
+                }
+            }
+        }
+
+        for (quint32 index : mesh.indices) {
+            QVERIFY(index < static_cast<quint32>(mesh.vertices.size()));
+        }
+    }
+}
+
+void TestSurfaceTessellator::flatGridHasUnitNormals()
+{
+    ControlGrid grid = makeGrid(SurfaceType::BSpline, 3);
+    for (QVector3D& p : grid.points) {
+        p.setY(0.0f);
+    }
+    const QList<ControlGrid> grids = { grid };
+    SurfaceMesh mesh;
+    SurfaceTessellator(RESOLUTION).tessellate(spanOf(grids), mesh);
+
+    for (const QVector3D& normal : mesh.normals) {
+        QVERIFY(qAbs(std::abs(normal.y()) - 1.0f) < 1e-5f);
+        QVERIFY(qAbs(normal.x()) < 1e-5f && qAbs(normal.z()) < 1e-5f);
+    }
+}
+
+void TestSurfaceTessellator::updateGridMatchesTessellate()
+{
+    const SurfaceTessellator tessellator(RESOLUTION);
+    QList<ControlGrid> grids = { makeGrid(SurfaceType::Bezier, 2), makeGrid(SurfaceType::BSpline, 3) };
+    SurfaceMesh mesh;
+    tessellator.tessellate(spanOf(grids), mesh);
+    const QVector<quint32> indicesBefore = mesh.indices;
+
+    grids[1].points[7] += QVector3D(0.0f, 25.0f, 0.0f);
+    const IndexRange dirty = tessellator.updateGrid(spanOf(grids), 1, mesh);
+    QCOMPARE(dirty.first, mesh.gridVertexOffsets[1]);
+    QCOMPARE(dirty.end(), mesh.gridVertexOffsets[2]);
+
+    SurfaceMesh expected;
+    tessellator.tessellate(spanOf(grids), expected);
+    QCOMPARE(mesh.vertices, expected.vertices);
+    QCOMPARE(mesh.normals, expected.normals);
+    QCOMPARE(mesh.indices, indicesBefore);
+}
+
+void TestSurfaceTessellator::threadCountDoesNotChangeResult()
+{
+    const SurfaceTessellator tessellator(RESOLUTION);
+    const QList<ControlGrid> grids = { makeGrid(SurfaceType::BSpline, 12) };
+    SurfaceMesh single;
+    SurfaceMesh threaded;
+    tessellator.tessellate(spanOf(grids), single, 1);
+    tessellator.tessellate(spanOf(grids), threaded, 4);
+    QCOMPARE(threaded.vertices, single.vertices);
+    QCOMPARE(threaded.normals, single.normals);
+    QCOMPARE(threaded.indices, single.indices);
+}
+
+QTEST_APPLESS_MAIN(TestSurfaceTessellator)
+#include "tst_surfacetessellator.moc"